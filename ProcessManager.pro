@@ -1,15 +1,24 @@
-QT       += core gui widgets
+QT       += core gui widgets network
 
 TARGET = ProcessManager
 TEMPLATE = app
 
 CONFIG += c++_cs98
 
+# 后台核心代码，基准测试(benchmarks/benchmarks.pro)也使用
+include(core/core.pri)
+
 SOURCES += main.cpp \
            gui/addservicedialog.cpp \
            gui/mainwindow.cpp \
            gui/processmodel.cpp \
-           core/backendworker.cpp
+           gui/processfilterproxy.cpp \
+           gui/ngramindex.cpp \
+           gui/diagnosticspanel.cpp \
+           gui/groupmodel.cpp \
+           gui/grouppanel.cpp \
+           gui/federationclient.cpp \
+           gui/runhistorydialog.cpp
 
 
 INCLUDEPATH += $$PWD/gui \
@@ -18,8 +27,13 @@ INCLUDEPATH += $$PWD/gui \
 HEADERS  += gui/mainwindow.h \
             gui/addservicedialog.h \
             gui/processmodel.h \
-            core/backendworker.h \
-            core/processinfo.h
+            gui/processfilterproxy.h \
+            gui/ngramindex.h \
+            gui/diagnosticspanel.h \
+            gui/groupmodel.h \
+            gui/grouppanel.h \
+            gui/federationclient.h \
+            gui/runhistorydialog.h
 
 FORMS    += gui/mainwindow.ui \
     gui/addservicedialog.ui
@@ -0,0 +1,32 @@
+# 后台热点路径的基准测试，独立于主程序构建:
+#   qmake benchmarks/benchmarks.pro && make && ./backend_benchmarks
+# 每个用例在 QTest 的结果之外另输出一行 "BENCH <名称>: ns/op, allocs/op"
+
+QT       += core gui network testlib
+
+TARGET = backend_benchmarks
+TEMPLATE = app
+
+CONFIG += console
+CONFIG -= app_bundle
+
+include(../core/core.pri)
+
+INCLUDEPATH += $$PWD/../gui
+
+SOURCES += tst_backendbench.cpp \
+           benchutil.cpp \
+           procsimulator.cpp \
+           ../gui/federationclient.cpp \
+           ../gui/processmodel.cpp \
+           ../gui/processfilterproxy.cpp \
+           ../gui/ngramindex.cpp \
+           ../gui/groupmodel.cpp
+
+HEADERS += benchutil.h \
+           procsimulator.h \
+           ../gui/federationclient.h \
+           ../gui/processmodel.h \
+           ../gui/processfilterproxy.h \
+           ../gui/ngramindex.h \
+           ../gui/groupmodel.h
@@ -0,0 +1,59 @@
+#include "benchutil.h"
+
+#include <stdio.h>
+
+#if defined(__GLIBC__)
+
+#include <stddef.h>
+
+// 可执行文件中定义的 malloc 会覆盖所有共享库(包括Qt)对 malloc 的引用，
+// 计数后转交 glibc 的实现
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+}
+
+namespace {
+volatile quint64 g_allocations = 0;
+}
+
+extern "C" void *malloc(size_t size) {
+    __sync_fetch_and_add(&g_allocations, 1);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) {
+    __sync_fetch_and_add(&g_allocations, 1);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size) {
+    __sync_fetch_and_add(&g_allocations, 1);
+    return __libc_realloc(ptr, size);
+}
+
+quint64 allocationCount() { return g_allocations; }
+
+#else
+
+quint64 allocationCount() { return 0; }
+
+#endif
+
+OpStats::OpStats(const QString &label) : m_label(label), m_ops(0) {
+    m_startAllocs = allocationCount();
+    m_timer.start();
+}
+
+OpStats::~OpStats() {
+    qint64 elapsedNs = m_timer.nsecsElapsed();
+    quint64 allocs = allocationCount() - m_startAllocs;
+    if (m_ops <= 0) {
+        return;
+    }
+    fprintf(stdout, "BENCH %s: %lld ns/op, %.1f allocs/op (%lld ops)\n",
+            m_label.toLocal8Bit().constData(), (long long)(elapsedNs / m_ops),
+            (double)allocs / m_ops, (long long)m_ops);
+    fflush(stdout);
+}
@@ -0,0 +1,30 @@
+#ifndef BENCHUTIL_H
+#define BENCHUTIL_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+// 进程内的堆分配计数(malloc/calloc/realloc 及经由它们的 operator new)。
+// 仅在 glibc 上可用，其他平台恒为0
+quint64 allocationCount();
+
+// 统计一个 QBENCHMARK 块的平均耗时与分配次数，析构时输出:
+//   BENCH monitorTick/1000: 812345 ns/op, 4012.0 allocs/op (25 ops)
+// QBENCHMARK 可能多次运行循环体，这里按实际执行的总次数平均；
+// QTest 在各轮之间的少量开销也计算在内。
+class OpStats {
+public:
+    explicit OpStats(const QString &label);
+    ~OpStats();
+
+    // 循环体每执行一次调用；一次执行包含多个操作时传入操作数
+    void tick(int ops = 1) { m_ops += ops; }
+
+private:
+    QString m_label;
+    qint64 m_ops;
+    quint64 m_startAllocs;
+    QElapsedTimer m_timer;
+};
+
+#endif  // BENCHUTIL_H
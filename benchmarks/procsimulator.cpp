@@ -0,0 +1,339 @@
+#include "procsimulator.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QtAlgorithms>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "pidfile.h"
+#include "procfs.h"
+
+namespace {
+
+const int kTicksPerSecond = 100;
+
+bool writeFile(const QString &path, const QByteArray &content) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    bool ok = file.write(content) == content.size();
+    file.close();
+    return ok;
+}
+
+QByteArray readFile(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+    QByteArray content = file.readAll();
+    file.close();
+    return content;
+}
+
+// 有 tmpfs 时放在 /dev/shm，上万个小文件的读写不落盘
+QString temporaryTemplate() {
+    QFileInfo shm("/dev/shm");
+    QString base = (shm.isDir() && shm.isWritable()) ? shm.absoluteFilePath()
+                                                      : QDir::tempPath();
+    return base + "/procsim-XXXXXX";
+}
+
+}  // namespace
+
+ProcSimulator::Options::Options() {
+    processes = 1000;
+    churnRate = 0.0;
+    crashRate = 0.0;
+    cpus = 8;
+    cpuPercent = 0.01;
+    cpuAmplitude = 0.5;
+    cpuPeriodSteps = 30;
+    hotFraction = 0.0;
+    memBaseMB = 50.0;
+    memLeakMBPerStep = 0.0;
+    stepMs = 2000;
+    seed = 1;
+}
+
+ProcSimulator::ProcSimulator(const Options &options)
+    : m_options(options), m_dir(temporaryTemplate()) {
+    m_valid = false;
+    m_scannedPid = ProcFs::SimulatedPidBase - 1;
+    m_random = options.seed ? options.seed : 1;
+    m_step = 0;
+    m_uptimeTicks = 1000 * kTicksPerSecond;
+    m_totalTicks = m_uptimeTicks * qMax(1, options.cpus);
+    m_workTicks = 0;
+    m_spawnedByBackend = 0;
+    m_signalled = 0;
+    m_crashed = 0;
+    m_churned = 0;
+
+    if (!m_dir.isValid()) return;
+
+    QDir dir(m_dir.path());
+    if (!dir.mkpath("proc/sys/kernel") || !dir.mkpath("proc/net") ||
+        !dir.mkpath("pids")) {
+        return;
+    }
+    m_root = dir.filePath("proc");
+
+    QByteArray tcpHeader(
+        "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when "
+        "retrnsmt   uid  timeout inode\n");
+    writeFile(m_root + "/net/tcp", tcpHeader);
+    writeFile(m_root + "/net/tcp6", tcpHeader);
+    writeFile(m_root + "/sys/kernel/ns_last_pid",
+              QByteArray::number(m_scannedPid) + '\n');
+
+    m_slotPid.fill(0, qMax(0, options.processes));
+    for (int slot = 0; slot < m_slotPid.size(); ++slot) {
+        spawn(slot);
+    }
+    m_scannedPid = readFile(m_root + "/sys/kernel/ns_last_pid").trimmed().toLongLong();
+    writeSystem(0);
+    m_valid = true;
+}
+
+QStringList ProcSimulator::writeConfigs(const QString &dir,
+                                        const QJsonObject &extra) const {
+    QDir().mkpath(dir);
+    QStringList paths;
+    for (int slot = 0; slot < m_slotPid.size(); ++slot) {
+        QString id = QString("sim-%1").arg(slot);
+
+        QJsonObject obj;
+        obj["id"] = id;
+        obj["name"] = QString::fromUtf8("模拟服务 %1").arg(slot);
+        obj["type"] = QString("service");
+        obj["command"] = QString("/sim/%1").arg(slot);
+        obj["pidFile"] = pidFileOf(slot);
+        for (QJsonObject::const_iterator it = extra.constBegin();
+             it != extra.constEnd(); ++it) {
+            obj[it.key()] = it.value();
+        }
+
+        QString path = QDir(dir).filePath(id + ".json");
+        if (writeFile(path, QJsonDocument(obj).toJson())) {
+            paths.append(path);
+        }
+    }
+    return paths;
+}
+
+void ProcSimulator::step() {
+    ++m_step;
+    deliverSignals();
+    adoptSpawned();
+
+    // QHash 的遍历顺序随进程变化，按PID排序保证同一个 seed 得到同样的结果
+    QList<qint64> pids = m_processes.keys();
+    qSort(pids);
+
+    double crashRate = m_options.crashRate;
+    double exitRate = crashRate + m_options.churnRate;
+    if (exitRate > 0.0) {
+        for (int i = 0; i < pids.count(); ++i) {
+            double r = nextUniform();
+            if (r >= exitRate) continue;
+
+            int slot = m_processes.value(pids.at(i)).slot;
+            exitProcess(pids.at(i));
+            if (r < crashRate) {
+                ++m_crashed;
+            } else {
+                spawn(slot);
+                ++m_churned;
+            }
+        }
+        pids = m_processes.keys();
+        qSort(pids);
+    }
+
+    unsigned long long stepTicks =
+        (unsigned long long)m_options.stepMs * kTicksPerSecond / 1000;
+    unsigned long long systemTicks = stepTicks * qMax(1, m_options.cpus);
+    unsigned long long workTicks = 0;
+    for (int i = 0; i < pids.count(); ++i) {
+        qint64 pid = pids.at(i);
+        Process &process = m_processes[pid];
+
+        double ticks = cpuPercentOf(pid, process) / 100.0 * systemTicks;
+        unsigned long long delta = (unsigned long long)ticks;
+        // 小数部分按概率进位，长期平均与曲线一致
+        if (nextUniform() < ticks - delta) ++delta;
+        process.utime += delta - delta / 4;
+        process.stime += delta / 4;
+        workTicks += delta;
+
+        process.memMB += m_options.memLeakMBPerStep;
+        writeProcess(pid, process);
+    }
+
+    m_uptimeTicks += stepTicks;
+    m_totalTicks += systemTicks;
+    writeSystem(qMin(workTicks, systemTicks));
+}
+
+quint32 ProcSimulator::nextRandom() {
+    // xorshift32
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return m_random;
+}
+
+double ProcSimulator::nextUniform() {
+    return nextRandom() / 4294967296.0;
+}
+
+QString ProcSimulator::pidDir(qint64 pid) const {
+    return QString("%1/%2").arg(m_root).arg(pid);
+}
+
+QString ProcSimulator::pidFileOf(int slot) const {
+    return QString("%1/pids/sim-%2.pid").arg(m_dir.path()).arg(slot);
+}
+
+qint64 ProcSimulator::allocatePid() {
+    // 后台也会从同一个计数器分配
+    QString lastPidPath = m_root + "/sys/kernel/ns_last_pid";
+    qint64 pid = readFile(lastPidPath).trimmed().toLongLong() + 1;
+    pid = qMax(pid, (qint64)ProcFs::SimulatedPidBase);
+    writeFile(lastPidPath, QByteArray::number(pid) + '\n');
+    return pid;
+}
+
+void ProcSimulator::spawn(int slot) {
+    qint64 pid = allocatePid();
+    QDir(m_root).mkpath(QString::number(pid));
+
+    Process process;
+    process.slot = slot;
+    process.utime = 0;
+    process.stime = 0;
+    process.startTicks = m_uptimeTicks;
+    process.memMB = m_options.memBaseMB;
+    process.hot = nextUniform() < m_options.hotFraction;
+    m_processes.insert(pid, process);
+    m_slotPid[slot] = pid;
+
+    QByteArray command = QString("/sim/%1").arg(slot).toLatin1();
+    writeFile(pidDir(pid) + "/cmdline", command + '\0');
+    writeFile(pidDir(pid) + "/comm", QByteArray("sim\n"));
+    writeProcess(pid, process);
+
+    ProcessIdentity identity;
+    identity.pid = pid;
+    identity.startTime = process.startTicks;
+    identity.cmdlineHash = ProcFs::hashCmdline(command + '\0');
+    PidFile::write(pidFileOf(slot), identity, 0);
+}
+
+void ProcSimulator::exitProcess(qint64 pid) {
+    QHash<qint64, Process>::iterator it = m_processes.find(pid);
+    if (it == m_processes.end()) return;
+
+    if (m_slotPid.value(it->slot) == pid) m_slotPid[it->slot] = 0;
+    m_processes.erase(it);
+    QDir(pidDir(pid)).removeRecursively();
+}
+
+void ProcSimulator::deliverSignals() {
+    QString path = m_root + "/signals";
+    QByteArray content = readFile(path);
+    if (content.isEmpty()) return;
+    QFile::remove(path);
+
+    // 每行 "<pid> <sig>"；模拟进程不处理信号，收到即退出
+    QList<QByteArray> lines = content.split('\n');
+    for (int i = 0; i < lines.count(); ++i) {
+        QList<QByteArray> fields = lines.at(i).split(' ');
+        if (fields.count() != 2) continue;
+        qint64 pid = fields.at(0).toLongLong();
+        int sig = fields.at(1).toInt();
+        if (sig == 0 || !m_processes.contains(pid)) continue;
+        exitProcess(pid);
+        ++m_signalled;
+    }
+}
+
+void ProcSimulator::adoptSpawned() {
+    qint64 lastPid =
+        readFile(m_root + "/sys/kernel/ns_last_pid").trimmed().toLongLong();
+    for (qint64 pid = m_scannedPid + 1; pid <= lastPid; ++pid) {
+        if (m_processes.contains(pid)) continue;
+
+        // 后台启动的进程：cmdline 为 /sim/<槽位号>
+        QByteArray cmdline = readFile(pidDir(pid) + "/cmdline");
+        if (!cmdline.startsWith("/sim/")) continue;
+        bool ok = false;
+        int slot = cmdline.mid(5).split('\0').at(0).toInt(&ok);
+        if (!ok || slot < 0 || slot >= m_slotPid.size()) continue;
+
+        Process process;
+        process.slot = slot;
+        process.utime = 0;
+        process.stime = 0;
+        process.startTicks = m_uptimeTicks;
+        process.memMB = m_options.memBaseMB;
+        process.hot = nextUniform() < m_options.hotFraction;
+        m_processes.insert(pid, process);
+        m_slotPid[slot] = pid;
+        ++m_spawnedByBackend;
+    }
+    m_scannedPid = qMax(m_scannedPid, lastPid);
+}
+
+double ProcSimulator::cpuPercentOf(qint64 pid, const Process &process) const {
+    double base = m_options.cpuPercent * (process.hot ? 50.0 : 1.0);
+    int period = qMax(1, m_options.cpuPeriodSteps);
+    double phase = 2.0 * M_PI * ((m_step + pid) % period) / period;
+    return qMax(0.0, base * (1.0 + m_options.cpuAmplitude * sin(phase)));
+}
+
+void ProcSimulator::writeProcess(qint64 pid, const Process &process) const {
+    qint64 rssPages = (qint64)(process.memMB * 256.0);
+    writeFile(pidDir(pid) + "/stat",
+              ProcFs::simulatedStat(pid, "sim", process.utime, process.stime,
+                                    process.startTicks, rssPages));
+
+    char statm[128];
+    int length = snprintf(statm, sizeof(statm), "%lld %lld %lld 1 0 %lld 0\n",
+                          (long long)rssPages * 2, (long long)rssPages,
+                          (long long)rssPages / 8, (long long)rssPages);
+    writeFile(pidDir(pid) + "/statm", QByteArray(statm, length));
+}
+
+void ProcSimulator::writeSystem(unsigned long long workTicks) {
+    m_workTicks += workTicks;
+    unsigned long long idle = m_totalTicks - m_workTicks;
+
+    char stat[256];
+    int length = snprintf(stat, sizeof(stat),
+                          "cpu  %llu 0 0 %llu 0 0 0 0 0 0\nbtime 1700000000\n",
+                          m_workTicks, idle);
+    writeFile(m_root + "/stat", QByteArray(stat, length));
+
+    double usedMB = 0.0;
+    for (QHash<qint64, Process>::const_iterator it = m_processes.constBegin();
+         it != m_processes.constEnd(); ++it) {
+        usedMB += it->memMB;
+    }
+    long long usedKB = (long long)(usedMB * 1024.0);
+    long long totalKB = qMax(16LL * 1024 * 1024, usedKB * 2);
+    char meminfo[256];
+    length = snprintf(meminfo, sizeof(meminfo),
+                      "MemTotal:       %lld kB\nMemFree:        %lld kB\n"
+                      "MemAvailable:   %lld kB\n",
+                      totalKB, totalKB - usedKB, totalKB - usedKB);
+    writeFile(m_root + "/meminfo", QByteArray(meminfo, length));
+
+    char uptime[64];
+    length = snprintf(uptime, sizeof(uptime), "%.2f %.2f\n",
+                      (double)m_uptimeTicks / kTicksPerSecond,
+                      (double)idle / kTicksPerSecond);
+    writeFile(m_root + "/uptime", QByteArray(uptime, length));
+}
@@ -0,0 +1,104 @@
+#ifndef PROCSIMULATOR_H
+#define PROCSIMULATOR_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QVector>
+
+// 在临时目录(有 /dev/shm 时放在 tmpfs 上)生成一棵模拟的 /proc，
+// 配合 BackendWorker::setProcRoot(root, true) 对上万个服务做可重复的压测。
+//
+// 每个服务对应一个槽位，服务命令为 /sim/<槽位号>，PID文件位于 <root>/pids。
+// 每调用一次 step() 推进 stepMs 毫秒:
+//   - 处理后台发来的信号(<root>/signals)，收到信号的进程立即退出；
+//   - 认领后台通过 ProcFs::spawnSimulated 启动的新进程(按 cmdline 找回槽位)；
+//   - 按 churnRate 让进程被"外部"重启(换新PID并改写PID文件)，
+//     按 crashRate 让进程直接退出(PID文件保留，由后台发现并处理)；
+//   - 按CPU/内存曲线更新每个进程的 stat/statm 以及全局的 stat/meminfo/uptime。
+// 随机数由 seed 决定，同样的参数每次生成同样的序列。
+class ProcSimulator {
+public:
+    struct Options {
+        int processes;
+        double churnRate;        // 每步被外部重启的进程比例
+        double crashRate;        // 每步意外退出的进程比例
+        int cpus;
+        double cpuPercent;       // 单进程平均CPU占用(占整机的百分比)
+        double cpuAmplitude;     // 正弦波动幅度，相对 cpuPercent 的比例
+        int cpuPeriodSteps;
+        double hotFraction;      // CPU占用为平均值50倍的进程比例
+        double memBaseMB;
+        double memLeakMBPerStep; // 每步的内存增长，模拟泄漏
+        int stepMs;
+        quint32 seed;
+
+        Options();
+    };
+
+    explicit ProcSimulator(const Options &options);
+
+    bool isValid() const { return m_valid; }
+    // 传给 BackendWorker::setProcRoot(root, true)
+    QString root() const { return m_root; }
+    int liveCount() const { return m_processes.count(); }
+
+    // 为每个槽位写出服务配置，extra 中的字段覆盖默认值；返回配置文件路径
+    QStringList writeConfigs(const QString &dir, const QJsonObject &extra) const;
+
+    void step();
+
+    // 自创建以来的累计次数
+    int spawnedByBackend() const { return m_spawnedByBackend; }
+    int signalled() const { return m_signalled; }
+    int crashed() const { return m_crashed; }
+    int churned() const { return m_churned; }
+
+private:
+    struct Process {
+        int slot;
+        unsigned long long utime;
+        unsigned long long stime;
+        unsigned long long startTicks;
+        double memMB;
+        bool hot;
+    };
+
+    quint32 nextRandom();
+    double nextUniform();
+
+    QString pidDir(qint64 pid) const;
+    QString pidFileOf(int slot) const;
+    qint64 allocatePid();
+    void spawn(int slot);
+    void exitProcess(qint64 pid);
+    void deliverSignals();
+    void adoptSpawned();
+    double cpuPercentOf(qint64 pid, const Process &process) const;
+    void writeProcess(qint64 pid, const Process &process) const;
+    void writeSystem(unsigned long long workTicks);
+
+    Options m_options;
+    QTemporaryDir m_dir;
+    QString m_root;
+    bool m_valid;
+
+    QHash<qint64, Process> m_processes;
+    QVector<qint64> m_slotPid;  // 槽位 -> 当前PID，0表示没有进程
+    qint64 m_scannedPid;  // 已检查过是否由后台启动的最大PID
+    quint32 m_random;
+
+    int m_step;
+    unsigned long long m_uptimeTicks;
+    unsigned long long m_totalTicks;
+    unsigned long long m_workTicks;
+
+    int m_spawnedByBackend;
+    int m_signalled;
+    int m_crashed;
+    int m_churned;
+};
+
+#endif  // PROCSIMULATOR_H
@@ -0,0 +1,1019 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QHostAddress>
+#include <QLocalSocket>
+#include <QMetaObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QVector>
+#include <QtTest>
+
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "backendworker.h"
+#include "benchutil.h"
+#include "childreaper.h"
+#include "cronexpression.h"
+#include "federationclient.h"
+#include "federationprotocol.h"
+#include "federationserver.h"
+#include "groupmodel.h"
+#include "healthprober.h"
+#include "pidfile.h"
+#include "processfilterproxy.h"
+#include "processmodel.h"
+#include "procsimulator.h"
+#include "taskscheduler.h"
+
+// 健康探测用的桩服务。收到完整的请求头后回复 "HTTP/1.0 <status>" 并关闭连接；
+// status 为0时只接受连接、从不回复，用来触发探测超时
+class StubHttpServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit StubHttpServer(int status) : m_status(status), m_connections(0), m_requests(0) {
+        connect(&m_server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+    }
+
+    bool listen() { return m_server.listen(QHostAddress(QHostAddress::LocalHost)); }
+    quint16 port() const { return m_server.serverPort(); }
+    int connections() const { return m_connections; }
+    int requests() const { return m_requests; }
+
+private slots:
+    void onNewConnection() {
+        while (m_server.hasPendingConnections()) {
+            QTcpSocket *socket = m_server.nextPendingConnection();
+            ++m_connections;
+            connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+            connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        }
+    }
+
+    void onReadyRead() {
+        QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+        QByteArray request = socket->property("request").toByteArray() + socket->readAll();
+        socket->setProperty("request", request);
+        if (!request.contains("\r\n\r\n")) {
+            return;
+        }
+        ++m_requests;
+        if (m_status == 0) {
+            return;
+        }
+        socket->write(QByteArray("HTTP/1.0 ") + QByteArray::number(m_status) +
+                      " Stub\r\nContent-Length: 0\r\n\r\n");
+        socket->disconnectFromHost();
+    }
+
+private:
+    QTcpServer m_server;
+    int m_status;
+    int m_connections;
+    int m_requests;
+};
+
+// 后台热点路径的基准测试。
+// 服务配置写在临时目录中，PID文件都指向本进程，监控周期读取的是真实的 /proc/self。
+class BackendBench : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void monitorTick_data();
+    void monitorTick();
+
+    void simulatedMonitorTick_data();
+    void simulatedMonitorTick();
+    void simulatorStep();
+
+    void pidFileRoundTrip();
+    void parseStartTime();
+    void healthProbeStub();
+
+    void parseConfigs_data();
+    void parseConfigs();
+
+    void nextFireTimeYear_data();
+    void nextFireTimeYear();
+
+    void cronNextAfterYear_data();
+    void cronNextAfterYear();
+
+    void scheduleTasks();
+    void rescheduleFiredTask();
+
+    void modelUpdateStatus_data();
+    void modelUpdateStatus();
+
+    void groupModelUpdate_data();
+    void groupModelUpdate();
+
+    void federationFanIn();
+    void federationLocalSockets();
+
+    // 安装的 SIGCHLD 处理函数和收割者身份作用于整个进程，放在最后
+    void childReaperOrphans();
+
+private:
+    QStringList writeConfigs(const QString &prefix, int count);
+    static QList<ProcessInfo::Schedule> sampleSchedules();
+    static ProcSimulator::Options fleetOptions(int services);
+    static QJsonObject fleetConfig(const ProcSimulator::Options &options);
+    static QList<ProcessInfo> federationServices(const QString &prefix, int count);
+    static int hostRow(const ProcessModel &model, const QString &host,
+                       const QString &id);
+    static int hostRowCount(const ProcessModel &model, const QString &host);
+
+    QTemporaryDir m_dir;
+    QString m_pidFile;
+};
+
+void BackendBench::initTestCase() {
+    QVERIFY(m_dir.isValid());
+
+    m_pidFile = m_dir.filePath("self.pid");
+    QFile pidFile(m_pidFile);
+    QVERIFY(pidFile.open(QIODevice::WriteOnly));
+    pidFile.write(QByteArray::number((qint64)::getpid()));
+    pidFile.close();
+}
+
+QStringList BackendBench::writeConfigs(const QString &prefix, int count) {
+    QDir dir(m_dir.path());
+    dir.mkpath(prefix);
+
+    QStringList paths;
+    for (int i = 0; i < count; ++i) {
+        QString id = QString("%1-%2").arg(prefix).arg(i);
+
+        QJsonObject obj;
+        obj["id"] = id;
+        obj["name"] = QString::fromUtf8("基准服务 %1").arg(i);
+        obj["type"] = QString("service");
+        obj["command"] = QString("/usr/bin/sleep");
+        QJsonArray args;
+        args.append(QString("3600"));
+        obj["args"] = args;
+        obj["pidFile"] = m_pidFile;
+
+        QJsonObject stop;
+        stop["signal"] = QString("SIGTERM");
+        stop["timeoutSeconds"] = 10;
+        obj["stop"] = stop;
+
+        QJsonObject restart;
+        restart["initialDelaySeconds"] = 1;
+        restart["maxDelaySeconds"] = 300;
+        obj["restart"] = restart;
+
+        QString path = dir.filePath(QString("%1/%2.json").arg(prefix).arg(id));
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(QJsonDocument(obj).toJson());
+            file.close();
+            paths.append(path);
+        }
+    }
+    return paths;
+}
+
+QList<ProcessInfo::Schedule> BackendBench::sampleSchedules() {
+    QList<ProcessInfo::Schedule> schedules;
+
+    ProcessInfo::Schedule daily;
+    daily.type = "daily";
+    daily.hour = 3;
+    daily.minute = 30;
+    schedules.append(daily);
+
+    ProcessInfo::Schedule weekly;
+    weekly.type = "weekly";
+    weekly.dayOfWeek = 1;
+    weekly.hour = 9;
+    weekly.minute = 0;
+    schedules.append(weekly);
+
+    ProcessInfo::Schedule monthly;
+    monthly.type = "monthly";
+    monthly.dayOfMonth = 31;
+    monthly.hour = 23;
+    monthly.minute = 55;
+    schedules.append(monthly);
+
+    ProcessInfo::Schedule workHours;
+    workHours.type = "cron";
+    workHours.expression = "*/15 9-17 * * 1-5";
+    schedules.append(workHours);
+
+    ProcessInfo::Schedule frequent;
+    frequent.type = "cron";
+    frequent.expression = "*/5 * * * *";
+    schedules.append(frequent);
+
+    return schedules;
+}
+
+void BackendBench::monitorTick_data() {
+    QTest::addColumn<int>("services");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void BackendBench::monitorTick() {
+    QFETCH(int, services);
+
+    BackendWorker worker;
+    QStringList paths = writeConfigs(QString("monitor%1").arg(services), services);
+    QCOMPARE(paths.count(), services);
+    for (int i = 0; i < paths.count(); ++i) {
+        worker.onServiceAdded(paths.at(i));
+    }
+
+    // 第一个周期完成 Stopped -> Running 的转换，不计入结果
+    QMetaObject::invokeMethod(&worker, "onMonitorTimeout", Qt::DirectConnection);
+
+    OpStats stats(QString("monitorTick/%1").arg(services));
+    QBENCHMARK {
+        QMetaObject::invokeMethod(&worker, "onMonitorTimeout",
+                                  Qt::DirectConnection);
+        stats.tick();
+    }
+}
+
+// 整个集群约占一半CPU，1%的进程是热点；每步约0.1%的进程被外部重启、0.05%崩溃
+ProcSimulator::Options BackendBench::fleetOptions(int services) {
+    ProcSimulator::Options options;
+    options.processes = services;
+    options.churnRate = 0.001;
+    options.crashRate = 0.0005;
+    options.cpus = 16;
+    options.cpuPercent = 50.0 / services;
+    options.hotFraction = 0.01;
+    options.memLeakMBPerStep = 0.01;
+    options.seed = 42;
+    return options;
+}
+
+// 崩溃后立即自动重启；热点进程会触发CPU健康检查
+QJsonObject BackendBench::fleetConfig(const ProcSimulator::Options &options) {
+    QJsonObject config;
+    config["autoStart"] = true;
+
+    QJsonObject restart;
+    restart["initialDelaySeconds"] = 0;
+    restart["maxDelaySeconds"] = 5;
+    config["restart"] = restart;
+
+    QJsonObject healthCheck;
+    healthCheck["enabled"] = true;
+    healthCheck["maxCpu"] = options.cpuPercent * 10;
+    healthCheck["maxMem"] = 1024;
+    config["healthCheck"] = healthCheck;
+    return config;
+}
+
+void BackendBench::simulatedMonitorTick_data() {
+    QTest::addColumn<int>("services");
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("20000") << 20000;
+}
+
+// 在模拟的 /proc 上跑完整的监控周期：采样、健康检查、崩溃检测与自动重启。
+// 每个操作 = 模拟器推进一步 + 一个监控周期，模拟器自身的开销见 simulatorStep
+void BackendBench::simulatedMonitorTick() {
+    QFETCH(int, services);
+
+    ProcSimulator::Options options = fleetOptions(services);
+    ProcSimulator sim(options);
+    QVERIFY(sim.isValid());
+
+    BackendWorker worker;
+    QVERIFY(worker.setProcRoot(sim.root(), true));
+    QStringList paths = sim.writeConfigs(
+        m_dir.filePath(QString("sim%1").arg(services)), fleetConfig(options));
+    QCOMPARE(paths.count(), services);
+    for (int i = 0; i < paths.count(); ++i) {
+        worker.onServiceAdded(paths.at(i));
+    }
+
+    QMetaObject::invokeMethod(&worker, "onMonitorTimeout", Qt::DirectConnection);
+
+    {
+        OpStats stats(QString("simulatedMonitorTick/%1").arg(services));
+        QBENCHMARK {
+            sim.step();
+            QMetaObject::invokeMethod(&worker, "onMonitorTimeout",
+                                      Qt::DirectConnection);
+            // 执行到期的自动重启
+            QCoreApplication::processEvents();
+            stats.tick();
+        }
+    }
+
+    fprintf(stdout,
+            "SIM simulatedMonitorTick/%d: %d crashed, %d churned, "
+            "%d signalled, %d started by backend, %d alive\n",
+            services, sim.crashed(), sim.churned(), sim.signalled(),
+            sim.spawnedByBackend(), sim.liveCount());
+    fflush(stdout);
+    QVERIFY(sim.liveCount() > 0);
+}
+
+void BackendBench::simulatorStep() {
+    const int services = 10000;
+    ProcSimulator sim(fleetOptions(services));
+    QVERIFY(sim.isValid());
+
+    OpStats stats(QString("simulatorStep/%1").arg(services));
+    QBENCHMARK {
+        sim.step();
+        stats.tick();
+    }
+}
+
+void BackendBench::pidFileRoundTrip() {
+    QString path = m_dir.filePath("roundtrip.pid");
+
+    ProcessIdentity written;
+    written.pid = 4321;
+    written.startTime = 987654321ULL;
+    written.cmdlineHash = 0xdeadbeefu;
+    QString error;
+    QVERIFY2(PidFile::write(path, written, &error), qPrintable(error));
+
+    ProcessIdentity read;
+    QVERIFY(PidFile::read(path, &read));
+    QCOMPARE(read.pid, written.pid);
+    QCOMPARE(read.startTime, written.startTime);
+    QCOMPARE(read.cmdlineHash, written.cmdlineHash);
+
+    // 只有一行的旧格式：身份未知
+    QFile legacy(path);
+    QVERIFY(legacy.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    legacy.write("4321\n");
+    legacy.close();
+    QVERIFY(PidFile::read(path, &read));
+    QCOMPARE(read.pid, (qint64)4321);
+    QCOMPARE(read.startTime, 0ULL);
+    QCOMPARE(read.cmdlineHash, 0u);
+
+    QVERIFY(legacy.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    legacy.write("garbage\n");
+    legacy.close();
+    QVERIFY(PidFile::read(path, &read));
+    QCOMPARE(read.pid, (qint64)0);
+
+    QVERIFY(!PidFile::read(m_dir.filePath("missing.pid"), &read));
+}
+
+void BackendBench::parseStartTime() {
+    // comm 中的 ')' 和空格不能打乱字段计数
+    QByteArray stat = ProcFs::simulatedStat(77, "a) b (c)", 10, 20, 123456789ULL, 100);
+    QCOMPARE(ProcFs::parseStartTime(stat), 123456789ULL);
+    QCOMPARE(ProcFs::parseStartTime(ProcFs::simulatedStat(77, "plain", 1, 2, 42, 1)),
+             42ULL);
+    QCOMPARE(ProcFs::parseStartTime("77 (truncated) S 1"), 0ULL);
+    QCOMPARE(ProcFs::parseStartTime(QByteArray()), 0ULL);
+
+    // 真实的 /proc/self/stat 与 readIdentity 一致
+    ProcFs procFs;
+    ProcessIdentity self;
+    QVERIFY(procFs.readIdentity(getpid(), &self));
+    QFile statFile(procFs.pidPath(getpid(), "stat"));
+    QVERIFY(statFile.open(QIODevice::ReadOnly));
+    QCOMPARE(ProcFs::parseStartTime(statFile.readAll()), self.startTime);
+    QVERIFY(self.startTime > 0);
+
+    // cmdline 以 '\0' 分隔，这里先用 '|' 书写
+    QVERIFY(ProcFs::cmdlineRuns(QByteArray("/usr/bin/svc|--port|80|").replace('|', '\0'),
+                                "/usr/bin/svc"));
+    QVERIFY(ProcFs::cmdlineRuns(QByteArray("svc|").replace('|', '\0'), "/usr/bin/svc"));
+    QVERIFY(ProcFs::cmdlineRuns(QByteArray("/bin/sh|/opt/run.sh|").replace('|', '\0'),
+                                "/opt/run.sh"));
+    QVERIFY(!ProcFs::cmdlineRuns(QByteArray("/usr/bin/other|svc.conf|").replace('|', '\0'),
+                                 "/usr/bin/svc"));
+}
+
+// 探测间隔最短1秒，各用例要等上几个周期
+void BackendBench::healthProbeStub() {
+    HealthProber prober;
+    QSignalSpy failed(&prober, SIGNAL(probeFailed(QString, int, QString)));
+
+    ProcessInfo::Probe probe;
+    probe.type = "http";
+    probe.intervalSeconds = 1;
+    probe.timeoutMs = 300;
+    probe.initialDelaySeconds = 0;
+
+    // 2xx：连续探测都不算失败
+    StubHttpServer healthy(200);
+    QVERIFY(healthy.listen());
+    probe.url = QString("http://127.0.0.1:%1/health").arg(healthy.port());
+    probe.failureThreshold = 1;
+    prober.watch("healthy", probe);
+    QTRY_VERIFY_WITH_TIMEOUT(healthy.requests() >= 2, 10000);
+    QCOMPARE(failed.count(), 0);
+    prober.unwatch("healthy");
+
+    // 5xx：第一次失败不上报，达到阈值时上报一次并重新计数
+    StubHttpServer broken(503);
+    QVERIFY(broken.listen());
+    probe.url = QString("http://127.0.0.1:%1/health").arg(broken.port());
+    probe.failureThreshold = 2;
+    prober.watch("broken", probe);
+    QTRY_COMPARE_WITH_TIMEOUT(failed.count(), 1, 10000);
+    QCOMPARE(broken.requests(), 2);
+    QList<QVariant> args = failed.takeFirst();
+    QCOMPARE(args.at(0).toString(), QString("broken"));
+    QCOMPARE(args.at(1).toInt(), 2);
+    QVERIFY(args.at(2).toString().contains("503"));
+    prober.unwatch("broken");
+
+    // 接受连接但不回复：按超时失败
+    StubHttpServer silent(0);
+    QVERIFY(silent.listen());
+    probe.url = QString("http://127.0.0.1:%1/health").arg(silent.port());
+    probe.failureThreshold = 1;
+    prober.watch("silent", probe);
+    QTRY_COMPARE_WITH_TIMEOUT(failed.count(), 1, 10000);
+    QVERIFY(silent.requests() >= 1);
+    args = failed.takeFirst();
+    QCOMPARE(args.at(0).toString(), QString("silent"));
+    QVERIFY(args.at(2).toString().contains(QString::fromUtf8("300 毫秒内无响应")));
+    prober.unwatch("silent");
+
+    // TCP：能连上即健康，端口无人监听即失败
+    probe.type = "tcp";
+    probe.host = "127.0.0.1";
+    probe.port = healthy.port();
+    int connectionsBefore = healthy.connections();
+    prober.watch("tcp-up", probe);
+    QTRY_VERIFY_WITH_TIMEOUT(healthy.connections() >= connectionsBefore + 2, 10000);
+    QCOMPARE(failed.count(), 0);
+    prober.unwatch("tcp-up");
+
+    QTcpServer closed;
+    QVERIFY(closed.listen(QHostAddress(QHostAddress::LocalHost)));
+    probe.port = closed.serverPort();
+    closed.close();
+    prober.watch("tcp-down", probe);
+    QTRY_COMPARE_WITH_TIMEOUT(failed.count(), 1, 10000);
+    QCOMPARE(failed.first().at(0).toString(), QString("tcp-down"));
+    prober.unwatch("tcp-down");
+}
+
+void BackendBench::parseConfigs_data() {
+    QTest::addColumn<int>("files");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+void BackendBench::parseConfigs() {
+    QFETCH(int, files);
+
+    BackendWorker worker;
+    QStringList paths = writeConfigs(QString("parse%1").arg(files), files);
+    QCOMPARE(paths.count(), files);
+
+    // 每个操作 = 读取并解析一个配置文件、登记到后台
+    OpStats stats(QString("parseConfigs/%1").arg(files));
+    QBENCHMARK {
+        for (int i = 0; i < paths.count(); ++i) {
+            worker.onServiceAdded(paths.at(i));
+        }
+        stats.tick(paths.count());
+    }
+}
+
+void BackendBench::nextFireTimeYear_data() {
+    QTest::addColumn<int>("schedule");
+    QList<ProcessInfo::Schedule> schedules = sampleSchedules();
+    for (int i = 0; i < schedules.count(); ++i) {
+        const ProcessInfo::Schedule &s = schedules.at(i);
+        QString name = s.type == "cron" ? s.expression : s.type;
+        QTest::newRow(name.toLatin1().constData()) << i;
+    }
+}
+
+// 按一年的模拟时间逐次求下一次触发时间(每次调用都重新编译调度配置)
+void BackendBench::nextFireTimeYear() {
+    QFETCH(int, schedule);
+    ProcessInfo::Schedule s = sampleSchedules().at(schedule);
+
+    QDateTime start(QDate(2025, 1, 1), QTime(0, 0));
+    QDateTime end = start.addYears(1);
+    int fires = 0;
+
+    OpStats stats(QString("nextFireTimeYear/%1")
+                      .arg(s.type == "cron" ? s.expression : s.type));
+    QBENCHMARK {
+        fires = 0;
+        QDateTime t = start;
+        while (true) {
+            t = TaskScheduler::nextFireTime(s, t);
+            stats.tick();
+            if (!t.isValid() || t >= end) break;
+            ++fires;
+        }
+    }
+    QVERIFY(fires > 0);
+}
+
+void BackendBench::cronNextAfterYear_data() { nextFireTimeYear_data(); }
+
+// 同上，但表达式只编译一次，只测位扫描本身
+void BackendBench::cronNextAfterYear() {
+    QFETCH(int, schedule);
+    ProcessInfo::Schedule s = sampleSchedules().at(schedule);
+    CronExpression expression = CronExpression::fromSchedule(s);
+    QVERIFY(expression.isValid());
+
+    QDateTime start(QDate(2025, 1, 1), QTime(0, 0));
+    QDateTime end = start.addYears(1);
+    int fires = 0;
+
+    OpStats stats(QString("cronNextAfterYear/%1")
+                      .arg(s.type == "cron" ? s.expression : s.type));
+    QBENCHMARK {
+        fires = 0;
+        QDateTime t = start;
+        while (true) {
+            t = expression.nextAfter(t);
+            stats.tick();
+            if (!t.isValid() || t >= end) break;
+            ++fires;
+        }
+    }
+    QVERIFY(fires > 0);
+}
+
+// 一次性调度10000个任务：编译表达式、计算下一次触发时间并入堆
+void BackendBench::scheduleTasks() {
+    const int tasks = 10000;
+    QList<ProcessInfo::Schedule> schedules = sampleSchedules();
+    QStringList ids;
+    for (int i = 0; i < tasks; ++i) {
+        ids.append(QString("task-%1").arg(i));
+    }
+
+    TaskScheduler scheduler;
+    OpStats stats(QString("scheduleTasks/%1").arg(tasks));
+    QBENCHMARK {
+        scheduler.clear();
+        for (int i = 0; i < tasks; ++i) {
+            scheduler.setTask(ids.at(i), schedules.at(i % schedules.count()));
+        }
+        stats.tick(tasks);
+    }
+    QCOMPARE(scheduler.taskCount(), tasks);
+}
+
+// 10000个任务在堆中时，单个任务触发后重新计算并入堆的开销
+void BackendBench::rescheduleFiredTask() {
+    const int tasks = 10000;
+    QList<ProcessInfo::Schedule> schedules = sampleSchedules();
+    QStringList ids;
+    TaskScheduler scheduler;
+    for (int i = 0; i < tasks; ++i) {
+        ids.append(QString("task-%1").arg(i));
+        scheduler.setTask(ids.at(i), schedules.at(i % schedules.count()));
+    }
+
+    int next = 0;
+    OpStats stats(QString("rescheduleFiredTask/%1").arg(tasks));
+    QBENCHMARK {
+        int i = next++ % tasks;
+        scheduler.setTask(ids.at(i), schedules.at(i % schedules.count()));
+        stats.tick();
+    }
+}
+
+void BackendBench::modelUpdateStatus_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<QString>("filter");
+    QTest::newRow("1000") << 1000 << QString();
+    QTest::newRow("10000") << 10000 << QString();
+    QTest::newRow("10000-filtered") << 10000 << QString("svc-1");
+}
+
+// 模拟指标刷新：每轮更新所有行的CPU/内存，视图按CPU降序排序
+void BackendBench::modelUpdateStatus() {
+    QFETCH(int, rows);
+    QFETCH(QString, filter);
+
+    QList<ProcessInfo> processes;
+    QStringList ids;
+    for (int i = 0; i < rows; ++i) {
+        ProcessInfo p;
+        p.id = QString("svc-%1").arg(i);
+        p.name = QString::fromUtf8("服务 %1").arg(i);
+        p.type = "service";
+        p.command = "/usr/bin/sleep";
+        p.state = ProcessState::Running;
+        p.pid = 1000 + i;
+        processes.append(p);
+        ids.append(p.id);
+    }
+
+    ProcessModel model;
+    ProcessFilterProxy proxy;
+    proxy.setSourceModel(&model);
+    proxy.sort(4, Qt::DescendingOrder);
+    model.updateProcessList(processes);
+    proxy.setFilterText(filter);
+
+    int round = 0;
+    OpStats stats(QString("modelUpdateStatus/%1%2")
+                      .arg(rows)
+                      .arg(filter.isEmpty() ? QString() : "-filtered"));
+    QBENCHMARK {
+        ++round;
+        for (int i = 0; i < rows; ++i) {
+            double cpu = ((i * 7 + round * 13) % 1000) / 10.0;
+            double mem = 100.0 + (i + round) % 50;
+            model.updateProcessStatus(ids.at(i), ProcessState::Running,
+                                      1000 + i, cpu, mem);
+        }
+        stats.tick(rows);
+    }
+}
+
+void BackendBench::groupModelUpdate_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("groups");
+    QTest::newRow("10000/20") << 10000 << 20;
+    QTest::newRow("20000/200") << 20000 << 200;
+}
+
+// 分组汇总：每轮所有服务的CPU/内存都变化，分组合计按差值增量更新，
+// 变化的分组行在本轮结束时统一通知一次
+void BackendBench::groupModelUpdate() {
+    QFETCH(int, rows);
+    QFETCH(int, groups);
+
+    QList<ProcessInfo> processes;
+    QStringList ids;
+    for (int i = 0; i < rows; ++i) {
+        ProcessInfo p;
+        p.id = QString("svc-%1").arg(i);
+        p.name = QString::fromUtf8("服务 %1").arg(i);
+        p.type = "service";
+        p.group = QString("group-%1").arg(i % groups);
+        p.state = ProcessState::Running;
+        processes.append(p);
+        ids.append(p.id);
+    }
+
+    GroupModel model;
+    model.updateProcessList(processes);
+
+    int round = 0;
+    OpStats stats(QString("groupModelUpdate/%1/%2").arg(rows).arg(groups));
+    QBENCHMARK {
+        ++round;
+        for (int i = 0; i < rows; ++i) {
+            double cpu = ((i * 7 + round * 13) % 1000) / 10.0;
+            double mem = 100.0 + (i + round) % 50;
+            model.updateProcessStatus(ids.at(i), ProcessState::Running,
+                                      1000 + i, cpu, mem);
+        }
+        QCoreApplication::processEvents();
+        stats.tick(rows);
+    }
+
+    // 再走一轮并停掉每第三个服务，然后把成员重新求和，和增量维护的分组合计对比
+    ++round;
+    QVector<qint64> cpuSum(groups, 0);
+    QVector<qint64> memSum(groups, 0);
+    QVector<int> runningSum(groups, 0);
+    for (int i = 0; i < rows; ++i) {
+        bool stopped = (i % 3 == 0);
+        double cpu = stopped ? 0.0 : ((i * 7 + round * 13) % 1000) / 10.0;
+        double mem = stopped ? 0.0 : 100.0 + (i + round) % 50;
+        model.updateProcessStatus(ids.at(i),
+                                  stopped ? ProcessState::Stopped
+                                          : ProcessState::Running,
+                                  stopped ? 0 : 1000 + i, cpu, mem);
+        int g = i % groups;
+        cpuSum[g] += qRound64(cpu * 100.0);
+        memSum[g] += qRound64(mem * 10.0);
+        if (!stopped)
+            ++runningSum[g];
+    }
+    QCoreApplication::processEvents();
+
+    QCOMPARE(model.rowCount(), groups);
+    for (int row = 0; row < groups; ++row) {
+        QModelIndex groupIndex = model.index(row, GroupModel::NameColumn);
+        QString name = model.data(groupIndex).toString();
+        QVERIFY(name.startsWith("group-"));
+        int g = name.mid(6).toInt();
+        int total = model.rowCount(groupIndex);
+        QCOMPARE(total, rows / groups + (g < rows % groups ? 1 : 0));
+        QCOMPARE(model.data(model.index(row, GroupModel::RunningColumn)).toString(),
+                 QString("%1/%2").arg(runningSum.at(g)).arg(total));
+        QCOMPARE(model.data(model.index(row, GroupModel::CpuColumn)).toString(),
+                 QString::number(cpuSum.at(g) / 100.0, 'f', 2));
+        QCOMPARE(model.data(model.index(row, GroupModel::MemColumn)).toString(),
+                 QString::number(memSum.at(g) / 10.0, 'f', 1));
+    }
+}
+
+// 联合视图: 20台主机各500个服务，每个周期所有服务的CPU/内存都变化。
+// 每个操作 = 所有主机编码增量 + 界面解码并更新模型(按CPU排序的代理)，不经过套接字
+void BackendBench::federationFanIn() {
+    const int hosts = 20;
+    const int services = 500;
+
+    QList<FederationEncoder *> encoders;
+    QList<FederationDecoder *> decoders;
+    for (int h = 0; h < hosts; ++h) {
+        FederationEncoder *encoder =
+            new FederationEncoder(QString("host-%1").arg(h));
+        for (int i = 0; i < services; ++i) {
+            ProcessInfo p;
+            p.id = QString("svc-%1").arg(i);
+            p.name = QString::fromUtf8("服务 %1").arg(i);
+            p.type = "service";
+            p.state = ProcessState::Running;
+            p.pid = 1000 + i;
+            encoder->setService(p);
+        }
+        encoders.append(encoder);
+        decoders.append(new FederationDecoder());
+    }
+
+    ProcessModel model;
+    ProcessFilterProxy proxy;
+    proxy.setSourceModel(&model);
+    proxy.sort(4, Qt::DescendingOrder);
+
+    // 连接时的快照
+    qint64 snapshotBytes = 0;
+    for (int h = 0; h < hosts; ++h) {
+        QByteArray frame = encoders.at(h)->snapshotFrame();
+        encoders.at(h)->clearDelta();
+        snapshotBytes += frame.size();
+        FederationChanges changes;
+        QVERIFY(decoders.at(h)->feed(frame, &changes));
+        QList<ProcessInfo> updated;
+        for (QSet<quint32>::const_iterator it = changes.updated.constBegin();
+             it != changes.updated.constEnd(); ++it) {
+            updated.append(decoders.at(h)->service(*it));
+        }
+        model.updateHostServices(encoders.at(h)->host(), updated);
+    }
+    QCOMPARE(model.rowCount(), hosts * services);
+
+    int round = 0;
+    qint64 deltaBytes = 0;
+    {
+        OpStats stats(QString("federationFanIn/%1x%2").arg(hosts).arg(services));
+        QBENCHMARK {
+            ++round;
+            for (int h = 0; h < hosts; ++h) {
+                FederationEncoder *encoder = encoders.at(h);
+                for (int i = 0; i < services; ++i) {
+                    double cpu = ((i * 7 + round * 13 + h) % 1000) / 10.0;
+                    double mem = 100.0 + (i + round) % 50;
+                    encoder->setStatus(QString("svc-%1").arg(i),
+                                       ProcessState::Running, 1000 + i, cpu,
+                                       mem);
+                }
+                QByteArray frame = encoder->takeDeltaFrame();
+                deltaBytes += frame.size();
+
+                FederationChanges changes;
+                decoders.at(h)->feed(frame, &changes);
+                QList<ProcessInfo> updated;
+                updated.reserve(changes.updated.count());
+                for (QSet<quint32>::const_iterator it =
+                         changes.updated.constBegin();
+                     it != changes.updated.constEnd(); ++it) {
+                    updated.append(decoders.at(h)->service(*it));
+                }
+                model.updateHostServices(encoder->host(), updated);
+            }
+            stats.tick();
+        }
+    }
+
+    fprintf(stdout,
+            "SIM federationFanIn/%dx%d: snapshot %lld bytes, %lld bytes/tick\n",
+            hosts, services, snapshotBytes, round ? deltaBytes / round : 0LL);
+    fflush(stdout);
+
+    qDeleteAll(encoders);
+    qDeleteAll(decoders);
+}
+
+QList<ProcessInfo> BackendBench::federationServices(const QString &prefix,
+                                                   int count) {
+    QList<ProcessInfo> services;
+    for (int i = 0; i < count; ++i) {
+        ProcessInfo p;
+        p.id = QString("%1-%2").arg(prefix).arg(i);
+        p.name = QString::fromUtf8("服务 %1").arg(i);
+        p.type = "service";
+        p.state = ProcessState::Running;
+        p.pid = 1000 + i;
+        services.append(p);
+    }
+    return services;
+}
+
+int BackendBench::hostRow(const ProcessModel &model, const QString &host,
+                          const QString &id) {
+    for (int row = 0; row < model.rowCount(); ++row) {
+        if (model.data(model.index(row, 0), ProcessModel::IdRole).toString() == id &&
+            model.data(model.index(row, 9), ProcessModel::SortRole).toString() == host) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+int BackendBench::hostRowCount(const ProcessModel &model, const QString &host) {
+    int count = 0;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        if (model.data(model.index(row, 9), ProcessModel::SortRole).toString() == host) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// 两个实例经 unix 套接字推送，界面侧的客户端把它们合并进同一个 ProcessModel：
+// 连接时的快照、之后的增量、积压过多的客户端被断开、对端重启后重连并重置
+void BackendBench::federationLocalSockets() {
+    const int bulk = 5000;
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString addressA = "unix:" + dir.filePath("a.sock");
+    QString addressB = "unix:" + dir.filePath("b.sock");
+
+    FederationServer serverA("host-a");
+    serverA.setServices(federationServices("svc", bulk));
+    QString error;
+    QVERIFY2(serverA.listen(addressA, &error), qPrintable(error));
+    FederationServer *serverB = new FederationServer("host-b");
+    serverB->setServices(federationServices("svc", 3));
+    QVERIFY2(serverB->listen(addressB, &error), qPrintable(error));
+
+    // 同一路径上已有实例在监听时不能抢占
+    FederationServer duplicate("host-dup");
+    QVERIFY(!duplicate.listen(addressA, &error));
+    QVERIFY(serverA.isListening());
+
+    // 客户端随 model 一起析构
+    ProcessModel model;
+    QStringList addresses;
+    addresses << addressA << addressB;
+    for (int i = 0; i < addresses.count(); ++i) {
+        Federation::Address address;
+        QVERIFY(Federation::parseAddress(addresses.at(i), &address, &error));
+        FederationClient *client =
+            new FederationClient(i == 0 ? "a" : "b", address, &model);
+        connect(client, SIGNAL(servicesUpdated(QString, QList<ProcessInfo>)), &model,
+                SLOT(updateHostServices(QString, QList<ProcessInfo>)));
+        connect(client, SIGNAL(servicesRemoved(QString, QStringList)), &model,
+                SLOT(removeHostServices(QString, QStringList)));
+        connect(client, SIGNAL(hostReset(QString)), &model, SLOT(removeHost(QString)));
+        client->start();
+    }
+
+    // 快照
+    QTRY_COMPARE(model.rowCount(), bulk + 3);
+    QCOMPARE(hostRowCount(model, "a"), bulk);
+    QCOMPARE(hostRowCount(model, "b"), 3);
+    int row = hostRow(model, "b", "svc-1");
+    QVERIFY(row >= 0);
+    QCOMPARE(model.data(model.index(row, 2), ProcessModel::SortRole).toLongLong(),
+             (qint64)1001);
+
+    // 增量：状态变化、删除
+    serverB->setStatus("svc-1", ProcessState::Running, 4242, 12.5, 64.0);
+    serverB->removeService("svc-2");
+    serverB->flush();
+    QTRY_COMPARE(hostRowCount(model, "b"), 2);
+    row = hostRow(model, "b", "svc-1");
+    QVERIFY(row >= 0);
+    QCOMPARE(model.data(model.index(row, 2), ProcessModel::SortRole).toLongLong(),
+             (qint64)4242);
+    QCOMPARE(model.data(model.index(row, 4), ProcessModel::SortRole).toDouble(), 12.5);
+    QCOMPARE(hostRowCount(model, "a"), bulk);
+
+    // 只读很少数据就不再读的客户端：积压超过上限后被断开，正常的客户端不受影响
+    QLocalSocket stalled;
+    stalled.setReadBufferSize(4096);
+    stalled.connectToServer(dir.filePath("a.sock"), QIODevice::ReadOnly);
+    QVERIFY(stalled.waitForConnected(1000));
+    QTRY_COMPARE(serverA.clientCount(), 2);
+    int round = 0;
+    while (serverA.clientCount() == 2 && round < 5000) {
+        ++round;
+        for (int i = 0; i < bulk; ++i) {
+            serverA.setStatus(QString("svc-%1").arg(i), ProcessState::Running,
+                              1000 + i, ((i * 7 + round * 13) % 1000) / 10.0,
+                              100.0 + (i + round) % 50);
+        }
+        serverA.flush();
+        QCoreApplication::processEvents();
+    }
+    QCOMPARE(serverA.clientCount(), 1);
+    serverA.setStatus("svc-0", ProcessState::Running, 777, 1.0, 1.0);
+    serverA.flush();
+    QTRY_VERIFY(hostRow(model, "a", "svc-0") >= 0 &&
+                model.data(model.index(hostRow(model, "a", "svc-0"), 2),
+                           ProcessModel::SortRole).toLongLong() == 777);
+
+    // 对端重启：断开时该主机的行全部作废，重连后由新的快照重建
+    delete serverB;
+    QTRY_COMPARE(hostRowCount(model, "b"), 0);
+    serverB = new FederationServer("host-b");
+    serverB->setServices(federationServices("restarted", 4));
+    QVERIFY2(serverB->listen(addressB, &error), qPrintable(error));
+    QTRY_COMPARE_WITH_TIMEOUT(hostRowCount(model, "b"), 4, 15000);
+    QVERIFY(hostRow(model, "b", "svc-1") < 0);
+    QVERIFY(hostRow(model, "b", "restarted-0") >= 0);
+    QCOMPARE(hostRowCount(model, "a"), bulk);
+
+    delete serverB;
+}
+
+// 同一会话的子进程(如 QProcess)归别人等待，不能被收割；
+// 它已退出且排在前面时，后面被收养的孤儿仍要被回收
+void BackendBench::childReaperOrphans() {
+    ChildReaper reaper;
+    QString error;
+    QVERIFY2(reaper.install(&error), qPrintable(error));
+    QSignalSpy exited(&reaper,
+                      SIGNAL(childExited(qint64, int, int, qint64, qint64)));
+
+    // 别人的子进程：退出后保持僵尸状态，直到这里自己 waitpid
+    pid_t foreign = ::fork();
+    QVERIFY(foreign >= 0);
+    if (foreign == 0) {
+        ::_exit(7);
+    }
+    siginfo_t info;
+    QCOMPARE(::waitid(P_PID, foreign, &info, WEXITED | WNOWAIT), 0);
+
+    // 孤儿：中间进程 setsid 后派生孙进程并退出，孙进程被挂到本进程下；
+    // 关闭 release 管道后孙进程退出
+    int pidPipe[2];
+    int releasePipe[2];
+    QCOMPARE(::pipe(pidPipe), 0);
+    QCOMPARE(::pipe(releasePipe), 0);
+    pid_t middle = ::fork();
+    QVERIFY(middle >= 0);
+    if (middle == 0) {
+        ::setsid();
+        pid_t grandchild = ::fork();
+        if (grandchild == 0) {
+            ::close(releasePipe[1]);
+            char byte;
+            while (::read(releasePipe[0], &byte, 1) > 0) {
+            }
+            ::_exit(3);
+        }
+        ssize_t ignored = ::write(pidPipe[1], &grandchild, sizeof(grandchild));
+        (void)ignored;
+        ::_exit(0);
+    }
+    ::close(pidPipe[1]);
+    ::close(releasePipe[0]);
+    pid_t orphan = 0;
+    QCOMPARE(::read(pidPipe[0], &orphan, sizeof(orphan)), (ssize_t)sizeof(orphan));
+    ::close(pidPipe[0]);
+    int status = 0;
+    QCOMPARE(::waitpid(middle, &status, 0), middle);
+    QVERIFY(orphan > 0);
+
+    ::close(releasePipe[1]);
+    QTRY_VERIFY(!exited.isEmpty() &&
+                exited.last().at(0).toLongLong() == (qint64)orphan);
+    QCOMPARE(exited.last().at(1).toInt(), 3);
+
+    for (int i = 0; i < exited.count(); ++i) {
+        QVERIFY(exited.at(i).at(0).toLongLong() != (qint64)foreign);
+    }
+    QCOMPARE(::waitpid(foreign, &status, WNOHANG), foreign);
+    QVERIFY(WIFEXITED(status));
+    QCOMPARE(WEXITSTATUS(status), 7);
+}
+
+QTEST_GUILESS_MAIN(BackendBench)
+
+#include "tst_backendbench.moc"
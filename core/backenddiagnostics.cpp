@@ -0,0 +1,10 @@
+#include "backenddiagnostics.h"
+
+#include <time.h>
+
+qint64 diagnosticsClockUs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (qint64)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
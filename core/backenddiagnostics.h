@@ -0,0 +1,46 @@
+#ifndef BACKENDDIAGNOSTICS_H
+#define BACKENDDIAGNOSTICS_H
+
+#include <QMetaType>
+
+#include "latencyhistogram.h"
+
+// 后台自身的运行状况，每个监控周期结束时随系统指标一起发给界面。
+// 耗时单位为微秒，均为自启动(或上次重置)以来的累计分布
+struct BackendDiagnostics {
+    LatencySummary monitorTick;     // 一个监控周期的耗时
+    LatencySummary schedulerTick;   // 计划任务调度器一次到期处理的耗时
+    LatencySummary syscallsPerTick; // 每个监控周期的读写与信号类系统调用次数
+
+    // 所有服务合计的生命周期耗时(毫秒)
+    LatencySummary startToReady;    // 请求启动到就绪
+    LatencySummary stopToExit;      // 发出停止信号到观察到退出
+    LatencySummary recovery;        // 意外退出到自动重启后再次就绪
+
+    // 本周期结束时的队列深度
+    int services;
+    int pendingRestarts;   // 等待退避结束或等待停止后重启的服务
+    int pendingShutdowns;  // 已发停止信号、尚未退出的进程
+    int pendingTasks;      // 排队等待并发名额的计划任务
+    int runningTasks;
+    int awaitingReady;     // 已启动、尚未就绪的服务
+
+    qint64 sentAtUs;  // 发出时刻(diagnosticsClockUs)，界面据此计算跨线程延迟
+
+    BackendDiagnostics() {
+        services = 0;
+        pendingRestarts = 0;
+        pendingShutdowns = 0;
+        pendingTasks = 0;
+        runningTasks = 0;
+        awaitingReady = 0;
+        sentAtUs = 0;
+    }
+};
+
+// 单调时钟(微秒)，各线程读数可以直接相减
+qint64 diagnosticsClockUs();
+
+Q_DECLARE_METATYPE(BackendDiagnostics)
+
+#endif  // BACKENDDIAGNOSTICS_H
@@ -13,14 +13,112 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMessageBox>
-#include <QProcess>
+#include <QSettings>
+#include <QSysInfo>
 #include <QTextStream>
 #include <QTimer>
 
+#include "bulkexecutor.h"
+#include "childreaper.h"
+#include "federationserver.h"
+#include "healthprober.h"
+#include "pidfile.h"
+#include "processlauncher.h"
+#include "restartbackoff.h"
+#include "shutdownqueue.h"
+#include "taskdispatcher.h"
+#include "taskscheduler.h"
+#include "tracer.h"
+
 // 包含Linux系统调用头文件
 #include <signal.h>
 #include <sys/types.h>
 
+namespace
+{
+
+const int kMonitorIntervalMs = 2000;
+
+// 停止信号可以写成数字，也可以写成名称("SIGINT" 或 "INT")
+int parseSignal(const QJsonValue &value)
+{
+    if (value.isDouble())
+        return value.toInt(0);
+
+    QString name = value.toString().trimmed().toUpper();
+    if (name.startsWith("SIG"))
+        name = name.mid(3);
+
+    if (name == "TERM")
+        return SIGTERM;
+    if (name == "INT")
+        return SIGINT;
+    if (name == "QUIT")
+        return SIGQUIT;
+    if (name == "HUP")
+        return SIGHUP;
+    if (name == "USR1")
+        return SIGUSR1;
+    if (name == "USR2")
+        return SIGUSR2;
+    if (name == "KILL")
+        return SIGKILL;
+    return 0;
+}
+
+// 健康检查判定方式, e.g. {"evaluator": "percentile", "percentile": 95,
+// "windowSeconds": 60}；缺省或无法识别时保持"duration"
+ProcessInfo::HealthWindow parseHealthWindow(const QJsonValue &value)
+{
+    ProcessInfo::HealthWindow window;
+    if (!value.isObject())
+        return window;
+
+    QJsonObject obj = value.toObject();
+    QString evaluator = obj["evaluator"].toString();
+    if (evaluator == "ewma")
+        window.evaluator = ProcessInfo::HealthWindow::Ewma;
+    else if (evaluator == "percentile")
+        window.evaluator = ProcessInfo::HealthWindow::Percentile;
+    window.windowSeconds = qBound(2, obj["windowSeconds"].toInt(60), 3600);
+    window.percentile = qBound(1.0, obj["percentile"].toDouble(95.0), 100.0);
+    window.forSeconds = qBound(0, obj["forSeconds"].toInt(4), 3600);
+    return window;
+}
+
+// 解析空闲时段 "HH:mm-HH:mm"，允许跨越午夜
+bool parseQuietWindow(const QString &text, QTime *start, QTime *end)
+{
+    QStringList parts = text.split('-');
+    if (parts.count() != 2)
+        return false;
+    *start = QTime::fromString(parts.at(0).trimmed(), "HH:mm");
+    *end = QTime::fromString(parts.at(1).trimmed(), "HH:mm");
+    return start->isValid() && end->isValid() && *start != *end;
+}
+
+bool inQuietWindow(const QTime &now, const QTime &start, const QTime &end)
+{
+    if (start < end)
+        return now >= start && now < end;
+    return now >= start || now < end;
+}
+
+// 从 now 起下一个空闲时段的开始时刻；当前已在时段内时返回 now
+QDateTime nextQuietWindow(const QDateTime &now, const QTime &start,
+                          const QTime &end)
+{
+    if (inQuietWindow(now.time(), start, end))
+        return now;
+
+    QDateTime candidate(now.date(), start);
+    if (candidate <= now)
+        candidate = candidate.addDays(1);
+    return candidate;
+}
+
+}  // namespace
+
 BackendWorker::BackendWorker(QObject *parent) : QObject(parent)
 {
     m_prevSystemWorkTime = 0;
@@ -29,18 +127,97 @@ BackendWorker::BackendWorker(QObject *parent) : QObject(parent)
     m_monitorTimer = new QTimer(this);
     connect(m_monitorTimer, SIGNAL(timeout()), this, SLOT(onMonitorTimeout()));
 
-    m_schedulerTimer = new QTimer(this);
-    connect(m_schedulerTimer, SIGNAL(timeout()), this, SLOT(onSchedulerTick()));
-
-    connect(this, SIGNAL(delayedStartSignal()), this, SLOT(onDelayedStart()));
+    m_taskScheduler = new TaskScheduler(this);
+    connect(m_taskScheduler, SIGNAL(taskDue(QString, QDateTime)), this,
+            SLOT(onTaskDue(QString, QDateTime)));
+    connect(m_taskScheduler, SIGNAL(catchUpDue(QString, QDateTime)), this,
+            SLOT(onCatchUpDue(QString, QDateTime)));
+    connect(m_taskScheduler, SIGNAL(logMessage(QString)), this,
+            SIGNAL(logMessage(QString)));
+
+    m_taskDispatcher = new TaskDispatcher(this);
+    connect(m_taskDispatcher, SIGNAL(taskReady(QString, qint64)), this,
+            SLOT(onTaskReady(QString, qint64)));
+    connect(m_taskDispatcher, SIGNAL(logMessage(QString)), this,
+            SIGNAL(logMessage(QString)));
+    m_dispatchWaitMs = 0;
+
+    m_shutdownQueue = new ShutdownQueue(this);
+    connect(m_shutdownQueue,
+            SIGNAL(deadlineExpired(QString, ProcessIdentity, int)), this,
+            SLOT(onShutdownDeadline(QString, ProcessIdentity, int)));
+
+    m_stopAllActive = false;
+    m_stopAllAdvanceTimer = new QTimer(this);
+    m_stopAllAdvanceTimer->setSingleShot(true);
+    m_stopAllAdvanceTimer->setInterval(0);
+    connect(m_stopAllAdvanceTimer, SIGNAL(timeout()), this,
+            SLOT(advanceStopAll()));
+
+    m_monotonic.start();
+
+    m_bulkExecutor = new BulkExecutor(this);
+    connect(m_bulkExecutor, SIGNAL(executeItem(QString, QString)), this,
+            SLOT(onBulkExecuteItem(QString, QString)));
+    connect(m_bulkExecutor,
+            SIGNAL(progress(QString, QString, int, int, int, int)), this,
+            SIGNAL(bulkProgress(QString, QString, int, int, int, int)));
+    connect(m_bulkExecutor,
+            SIGNAL(batchFinished(QString, QString, int, QStringList)), this,
+            SIGNAL(bulkFinished(QString, QString, int, QStringList)));
+    // 批量操作依据状态变化判定每个服务是否完成
+    connect(this,
+            SIGNAL(processStatusChanged(QString, ProcessState::State, qint64,
+                                        double, double)),
+            this, SLOT(onOwnStatusChanged(QString, ProcessState::State)));
+
+    m_readinessTimer = new QTimer(this);
+    m_readinessTimer->setInterval(250);
+    connect(m_readinessTimer, SIGNAL(timeout()), this,
+            SLOT(onReadinessPoll()));
+
+    m_healthProber = new HealthProber(this);
+    connect(m_healthProber, SIGNAL(probeFailed(QString, int, QString)), this,
+            SLOT(onProbeFailed(QString, int, QString)));
+    connect(m_healthProber, SIGNAL(logMessage(QString)), this,
+            SIGNAL(logMessage(QString)));
+
+    m_restartBackoff = new RestartBackoff(this);
+    connect(m_restartBackoff, SIGNAL(restartDue(QString)), this,
+            SLOT(onRestartDue(QString)));
+
+    m_childReaper = new ChildReaper(this);
+    connect(m_childReaper,
+            SIGNAL(childExited(qint64, int, int, qint64, qint64)), this,
+            SLOT(onChildExited(qint64, int, int, qint64, qint64)));
+    connect(m_healthProber, SIGNAL(execSpawned(qint64)), m_childReaper,
+            SLOT(watch(qint64)));
+
+    m_federation = 0;
 }
 
 BackendWorker::~BackendWorker() {}
 
+bool BackendWorker::setProcRoot(const QString &root, bool simulated)
+{
+    m_procFs.setRoot(root);
+    bool ok = m_procFs.setSimulated(simulated);
+    m_listeningSockets.setRoot(m_procFs.root());
+    // 换了数据来源，上个周期的CPU时间不可比
+    m_prevSystemWorkTime = 0;
+    m_prevSystemTotalTime = 0;
+    for (int handle = 0; handle < m_runtime.capacity(); ++handle)
+    {
+        m_runtime.at(handle).hasPrevCpu = false;
+    }
+    return ok;
+}
+
 void BackendWorker::performInitialSetup()
 {
     // --- 1. 初始化日志与pids目录 ---
     emit logMessage(QString::fromUtf8("后台线程：开始初始化设置..."));
+    Tracer::setThreadName("BackendWorker");
 
     QString pidsPath = QCoreApplication::applicationDirPath() + "/pids";
     QDir pidsDir(pidsPath);
@@ -57,6 +234,56 @@ void BackendWorker::performInitialSetup()
         }
     }
 
+    // manager.ini 中 monitor/procRoot 可指向另一个 procfs(例如容器中的 /host/proc)；
+    // 压测时另设 monitor/simulate=true，procRoot 指向模拟的目录树
+    QSettings settings(QCoreApplication::applicationDirPath() + "/manager.ini",
+                       QSettings::IniFormat);
+    if (!setProcRoot(settings.value("monitor/procRoot").toString(),
+                     settings.value("monitor/simulate", false).toBool()))
+    {
+        emit logMessage(QString::fromUtf8(
+            "[错误] monitor/simulate 需要同时设置 monitor/procRoot 指向模拟的目录树，"
+            "已忽略，使用真实的 /proc。"));
+    }
+    if (settings.value("trace/enabled", false).toBool())
+    {
+        Tracer::start();
+        emit logMessage(QString::fromUtf8("后台线程：内部跟踪已开启，可在诊断面板中导出。"));
+    }
+    if (m_procFs.isSimulated())
+    {
+        emit logMessage(
+            QString::fromUtf8("[警告] 使用模拟的 /proc: %1，不会启动或停止任何真实进程。")
+                .arg(m_procFs.root()));
+    }
+    else if (m_procFs.root() != "/proc")
+    {
+        emit logMessage(
+            QString::fromUtf8("后台线程：从 %1 读取进程信息。").arg(m_procFs.root()));
+    }
+    startFederation(settings);
+
+    // 成为子进程收割者：脱离启动的服务退出时由本进程回收并记录退出状态
+    QString reaperError;
+    if (m_childReaper->install(&reaperError))
+    {
+        emit logMessage(QString::fromUtf8("后台线程：已启用子进程回收，将记录运行历史。"));
+    }
+    else
+    {
+        emit logMessage(
+            QString::fromUtf8("[警告] 无法启用子进程回收，运行历史将不可用: %1")
+                .arg(reaperError));
+    }
+
+    QString historyError;
+    if (!m_runHistory.open(QCoreApplication::applicationDirPath() +
+                               "/state/run-history.log",
+                           &historyError))
+    {
+        emit logMessage(QString::fromUtf8("[警告] %1").arg(historyError));
+    }
+
     // --- 2. 查找并解析所有JSON配置文件 ---
     QString configPath = QCoreApplication::applicationDirPath() + "/configs";
     QDir configDir(configPath);
@@ -79,6 +306,7 @@ void BackendWorker::performInitialSetup()
     }
 
     m_processConfigs.clear();
+    m_runtime.clear();
 
     for (int i = 0; i < files.count(); ++i)
     {
@@ -113,116 +341,56 @@ void BackendWorker::performInitialSetup()
             continue;
         }
 
-        QJsonObject obj = doc.object();
-        ProcessInfo p;
-        p.id = obj["id"].toString();
-        p.name = obj["name"].toString();
-        p.type = obj["type"].toString();
-        p.command = obj["command"].toString();
-        p.workingDir = obj["workingDir"].toString();
-        p.autoStart = obj["autoStart"].toBool(false);
-
-        if (obj.contains("args") && obj["args"].isArray())
-        {
-            QJsonArray argsArray = obj["args"].toArray();
-            for (int j = 0; j < argsArray.size(); ++j)
-            {
-                p.args.append(argsArray[j].toString());
-            }
-        }
-
-        QString pidFileFromJson = obj["pidFile"].toString();
-        if (!pidFileFromJson.isEmpty())
-        {
-            QFileInfo fileInfo(pidFileFromJson);
-            if (fileInfo.isRelative())
-            {
-                p.pidFile = pidsDir.filePath(pidFileFromJson);
-            }
-            else
-            {
-                p.pidFile = pidFileFromJson;
-            }
-        }
-
-        if (p.type == "task" && obj.contains("schedule") &&
-            obj["schedule"].isObject())
-        {
-            QJsonObject scheduleObj = obj["schedule"].toObject();
-            p.schedule.type = scheduleObj["type"].toString();
-            p.schedule.dayOfWeek = scheduleObj["dayOfWeek"].toInt(0);
-            p.schedule.dayOfMonth = scheduleObj["dayOfMonth"].toInt(0);
-            p.schedule.hour = scheduleObj["hour"].toInt(-1);
-            p.schedule.minute = scheduleObj["minute"].toInt(-1);
-        }
-
-        if (obj.contains("healthCheck") && obj["healthCheck"].isObject())
-        {
-            QJsonObject healthCheckObj = obj["healthCheck"].toObject();
-            p.healthCheckEnabled = healthCheckObj["enabled"].toBool(false);
-            p.maxCpu = healthCheckObj["maxCpu"].toDouble(0.0);
-            p.maxMem = healthCheckObj["maxMem"].toDouble(0.0);
-        }
-
-        m_processConfigs[p.id] = p;
-    }
-
-    // --- 3. 【核心修正】启动时清理过时的PID文件 ---
-    emit logMessage(
-        QString::fromUtf8("后台线程：执行启动时PID文件健康检查..."));
-    QList<QString> all_ids = m_processConfigs.keys();
-    for (int i = 0; i < all_ids.count(); ++i)
-    {
-        QString id = all_ids.at(i);
-        ProcessInfo config = m_processConfigs.value(id);
-
-        if (config.pidFile.isEmpty() || !QFile::exists(config.pidFile))
-        {
-            continue;
-        }
-
-        QFile pidFile(config.pidFile);
-        pidFile.open(QIODevice::ReadOnly);
-        qint64 pid = pidFile.readAll().trimmed().toLongLong();
-        pidFile.close();
-
-        if (pid <= 0)
-        {
-            emit logMessage(QString::fromUtf8(
-                                "[清理] 服务 %1 的PID文件内容无效，正在删除...")
-                                .arg(id));
-            pidFile.remove();
+        ProcessInfo p = parseProcessConfig(doc.object());
+        if (!checkPidFile(p, files.at(i)))
             continue;
-        }
-
-        if (::kill(pid, 0) != 0)
-        {
-            emit logMessage(
-                QString::fromUtf8(
-                    "[清理] 检测到服务 %1 的过时PID文件 (PID: %2)，正在删除...")
-                    .arg(id)
-                    .arg(pid));
-            pidFile.remove();
-        }
+        registerService(p);
+        m_restartBackoff->setPolicy(p.id, p.restart);
     }
 
+    // --- 3. 接管仍在运行的服务，清理过时的PID文件 ---
+    reattachServices();
+
     // --- 4. 加载数据到UI并启动定时器 ---
     emit logMessage(
         QString::fromUtf8(
             "后台线程：所有配置文件解析完毕，共加载 %1 个服务/任务.")
             .arg(m_processConfigs.count()));
-    emit processListLoaded(m_processConfigs.values());
+    QList<ProcessInfo> snapshots;
+    for (QMap<QString, ProcessInfo>::const_iterator it =
+             m_processConfigs.constBegin();
+         it != m_processConfigs.constEnd(); ++it)
+    {
+        snapshots.append(snapshot(it.key()));
+    }
+    emit processListLoaded(snapshots);
 
-    m_monitorTimer->start(2000);
+    m_monitorTimer->start(kMonitorIntervalMs);
     emit logMessage(QString::fromUtf8("后台线程：资源监控循环已启动。"));
 
-    m_lastSchedulerCheckTime = QDateTime::currentDateTime();
-    m_schedulerTimer->start(20000);
-    emit logMessage(QString::fromUtf8("后台线程：计划任务调度器已启动。"));
+    loadDispatchSettings();
+
+    m_taskScheduler->clear();
+    m_taskScheduler->setStateFile(QCoreApplication::applicationDirPath() +
+                                  "/state/scheduler.json");
+    for (QMap<QString, ProcessInfo>::const_iterator it =
+             m_processConfigs.constBegin();
+         it != m_processConfigs.constEnd(); ++it)
+    {
+        if (it.value().type == "task")
+        {
+            m_taskScheduler->setTask(it.key(), it.value().schedule);
+        }
+    }
+    m_taskScheduler->start();
+    emit logMessage(
+        QString::fromUtf8("后台线程：计划任务调度器已启动，共 %1 个任务。")
+            .arg(m_taskScheduler->taskCount()));
 }
 
 void BackendWorker::startProcess(const QString &id)
 {
+    TraceSpan span("process", "startProcess", id);
     if (!m_processConfigs.contains(id))
     {
         emit logMessage(
@@ -239,15 +407,83 @@ void BackendWorker::startProcess(const QString &id)
         return;
     }
 
+    // 依赖的服务就绪之后再启动；尚未启动的依赖一并启动
+    QStringList unready = unreadyDependencies(id);
+    if (!unready.isEmpty())
+    {
+        if (m_waitingForDeps.contains(id))
+            return;
+
+        // 依赖成环时谁都等不到对方就绪，不能进入等待
+        QStringList cycle = dependencyCycle(id);
+        if (!cycle.isEmpty())
+        {
+            emit logMessage(
+                QString::fromUtf8("[错误] 服务依赖关系存在循环 (%1)，无法启动服务 %2。")
+                    .arg(cycle.join(" -> "))
+                    .arg(id));
+            if (setState(id, ProcessState::Error))
+                emit processStatusChanged(id, ProcessState::Error, -1, 0.0, 0.0);
+            return;
+        }
+
+        m_waitingForDeps.append(id);
+        emit logMessage(QString::fromUtf8("[依赖] 服务 %1 将在 %2 就绪后启动。")
+                            .arg(id)
+                            .arg(unready.join(", ")));
+        for (int i = 0; i < unready.count(); ++i)
+        {
+            ProcessState::State state = stateOf(unready.at(i));
+            if ((state == ProcessState::Stopped || state == ProcessState::Error) &&
+                !m_waitingForDeps.contains(unready.at(i)))
+            {
+                startProcess(unready.at(i));
+            }
+        }
+        return;
+    }
+    m_waitingForDeps.removeAll(id);
+
+    // 手动启动解除隔离，并取消尚未执行的自动重启；
+    // 到期的自动重启两者都不满足，保留退避状态
+    if (m_restartBackoff->isQuarantined(id) || m_restartBackoff->isPending(id))
+    {
+        if (m_restartBackoff->isQuarantined(id))
+        {
+            emit logMessage(
+                QString::fromUtf8("[自愈] 服务 %1 已解除隔离。").arg(id));
+        }
+        m_restartBackoff->release(id);
+    }
+
     emit logMessage(
         QString::fromUtf8("后台线程：收到启动服务请求（脱离模式）: %1")
             .arg(id));
-    emit processStatusChanged(id, "Starting...", 0, 0.0, 0.0);
-    m_processConfigs[id].status = "Starting...";
+    if (!setState(id, ProcessState::Starting))
+        return;
+    emit processStatusChanged(id, ProcessState::Starting, 0, 0.0, 0.0);
 
     qint64 pid = 0;
-    bool success = QProcess::startDetached(config.command, config.args,
-                                           config.workingDir, &pid);
+    QString launchError;
+    QStringList launchWarnings;
+    bool success;
+    if (!m_procFs.isSimulated())
+    {
+        success = ProcessLauncher::startDetached(config, &pid, &launchError,
+                                                 &launchWarnings);
+    }
+    else
+    {
+        // 只有显式开启 monitor/simulate 才会走到这里
+        pid = m_procFs.spawnSimulated(config.command, &launchError);
+        success = pid > 0;
+    }
+
+    for (int i = 0; i < launchWarnings.count(); ++i)
+    {
+        emit logMessage(
+            QString::fromUtf8("[警告] %1").arg(launchWarnings.at(i)));
+    }
 
     if (success && pid > 0)
     {
@@ -255,49 +491,153 @@ void BackendWorker::startProcess(const QString &id)
                             .arg(id)
                             .arg(pid));
 
-        QFile pidFile(config.pidFile);
-        if (!pidFile.open(QIODevice::WriteOnly | QIODevice::Truncate |
-                          QIODevice::Text))
+        // startDetached 在 exec 成功后才返回，此时的命令行已是服务自己的。
+        // 读不到身份说明进程已经退出(并被收割)：不写只有PID的文件，
+        // 否则日后这个PID被复用时无从分辨；没有PID文件的 Starting 由监控周期按启动阶段退出处理
+        ProcessIdentity identity;
+        if (!m_procFs.readIdentity(pid, &identity))
+        {
+            emit logMessage(
+                QString::fromUtf8("[警告] 服务 %1 (PID %2) 启动后立即退出，未写入PID文件。")
+                    .arg(id)
+                    .arg(pid));
+            m_restartBackoff->markStarted(id);
+            return;
+        }
+        QString pidFileError;
+        if (!PidFile::write(config.pidFile, identity, &pidFileError))
         {
             emit logMessage(
                 QString::fromUtf8("[严重错误] 无法为脱离进程创建PID文件 "
-                                  "%1！该进程将无法被管理！")
-                    .arg(config.pidFile));
-            ::kill(pid, SIGKILL);
+                                  "%1！该进程将无法被管理！(%2)")
+                    .arg(config.pidFile)
+                    .arg(pidFileError));
+            m_procFs.sendSignal(pid, SIGKILL);
+            launchFailed(id);
             return;
         }
-        QTextStream out(&pidFile);
-        out << pid;
-        pidFile.close();
+
+        m_restartBackoff->markStarted(id);
+
+        const RuntimeEntry *runtime = m_runtime.find(id);
+        if (runtime && runtime->startRequestedMono > 0)
+        {
+            recordLifecycle(id, LifecycleTimings::Launch,
+                            m_monotonic.elapsed() - runtime->startRequestedMono);
+        }
+
+        if (config.readiness.isEnabled())
+        {
+            m_awaitingReady.insert(id, m_monotonic.elapsed());
+            if (!m_readinessTimer->isActive())
+            {
+                m_readinessTimer->start();
+            }
+        }
+
+        // 模拟的进程不是本进程的子进程，不会被收割
+        if (m_childReaper->isInstalled() && !m_procFs.isSimulated())
+        {
+            RunRecord run;
+            run.id = id;
+            run.startMs = QDateTime::currentMSecsSinceEpoch();
+            run.queueWaitMs = m_dispatchWaitMs;
+            m_activeRuns.insert(pid, run);
+            m_childReaper->watch(pid);
+        }
+    }
+    else
+    {
+        emit logMessage(
+            QString::fromUtf8("[严重错误] 服务 %1 脱离启动失败！原因: %2")
+                .arg(id)
+                .arg(launchError));
+        launchFailed(id);
+    }
+}
+
+void BackendWorker::launchFailed(const QString &id)
+{
+    if (id != m_autoRestartId)
+    {
+        setState(id, ProcessState::Error);
+        emit processStatusChanged(id, ProcessState::Error, -1, 0.0, 0.0);
+        return;
+    }
+
+    // 自动重启时启动失败与崩溃一样计入退避，反复失败同样会被隔离
+    qint64 delayMs = m_restartBackoff->recordFailure(id);
+    Tracer::instant("restart", delayMs < 0 ? "quarantine" : "scheduleRestart", id);
+    ProcessState::State idleState = ProcessState::Stopped;
+    if (delayMs < 0)
+    {
+        const ProcessInfo::RestartPolicy &policy = m_processConfigs[id].restart;
+        emit logMessage(
+            QString::fromUtf8("[自愈] 服务 %1 在 %2 秒内连续失败 %3 次，"
+                              "已隔离，不再自动重启。请检查后手动启动。")
+                .arg(id)
+                .arg(policy.crashLoopWindowSec)
+                .arg(policy.crashLoopCount));
+        idleState = ProcessState::Quarantined;
     }
     else
     {
         emit logMessage(
-            QString::fromUtf8("[严重错误] 服务 %1 脱离启动失败！").arg(id));
-        m_processConfigs[id].status = "Error";
-        emit processStatusChanged(id, "Error", -1, 0.0, 0.0);
+            QString::fromUtf8("[自愈] 服务 %1 将在 %2 秒后再次尝试启动...")
+                .arg(id)
+                .arg(delayMs / 1000.0, 0, 'f', 1));
     }
+    if (setState(id, idleState))
+        emit processStatusChanged(id, idleState, 0, 0.0, 0.0);
 }
 
 void BackendWorker::stopProcess(const QString &id)
 {
+    TraceSpan span("process", "stopProcess", id);
     if (!m_processConfigs.contains(id))
         return;
 
-    ProcessInfo config = m_processConfigs.value(id);
-    if (config.pidFile.isEmpty())
-        return;
+    m_healthProber->unwatch(id);
+    if (m_waitingForDeps.removeAll(id) > 0)
+    {
+        emit logMessage(
+            QString::fromUtf8("[依赖] 已取消服务 %1 的等待启动。").arg(id));
+    }
 
-    qint64 pid = 0;
-    QFile pidFile(config.pidFile);
-    if (pidFile.open(QIODevice::ReadOnly))
+    // 手动停止后不再有"恢复"可计
+    RuntimeEntry *runtime = m_runtime.find(id);
+    if (runtime)
+        runtime->crashedMono = 0;
+
+    // 等待退避的服务没有进程可停，取消重启即可
+    if (m_restartBackoff->isPending(id))
     {
-        pid = pidFile.readAll().trimmed().toLongLong();
-        pidFile.close();
+        m_restartBackoff->cancel(id);
+        emit logMessage(
+            QString::fromUtf8("[自愈] 已取消服务 %1 的自动重启。").arg(id));
     }
 
+    ProcessInfo config = m_processConfigs.value(id);
+    if (config.pidFile.isEmpty())
+        return;
+
+    ProcessIdentity identity;
+    PidFile::read(config.pidFile, &identity);
+    qint64 pid = identity.pid;
     if (pid <= 0)
         return;
+    // 旧格式的PID文件没有 starttime，用监控周期记下的补上
+    if (identity.startTime == 0 && runtime && runtime->pid == pid)
+        identity.startTime = runtime->startTime;
+
+    if (m_shutdownQueue->contains(pid))
+    {
+        emit logMessage(
+            QString::fromUtf8("服务 %1 (PID: %2) 正在停止中，忽略重复的停止请求。")
+                .arg(id)
+                .arg(pid));
+        return;
+    }
 
     emit logMessage(
         QString::fromUtf8(
@@ -305,39 +645,52 @@ void BackendWorker::stopProcess(const QString &id)
             .arg(id)
             .arg(pid));
 
-    emit processStatusChanged(id, "Stopping...", pid, 0.0, 0.0);
-    m_processConfigs[id].status = "Stopping...";
+    if (setState(id, ProcessState::Stopping))
+    {
+        emit processStatusChanged(id, ProcessState::Stopping, pid, 0.0, 0.0);
+    }
 
-    if (::kill(pid, SIGTERM) == 0)
+    // PID已被别的进程复用时绝不能发信号，否则会误杀无关的进程
+    bool sameProcess = m_procFs.isSameProcess(identity);
+    if (sameProcess && m_procFs.sendSignal(pid, config.stopSignal))
     {
         emit logMessage(
-            QString::fromUtf8("成功发送SIGTERM到PID %1。等待10秒...").arg(pid));
-
-        QTimer *shutdownTimer = new QTimer(this);
-        shutdownTimer->setSingleShot(true);
-        shutdownTimer->setObjectName(QString::number(pid));
-
-        m_shutdownPidToIdMap[pid] = id;
-        connect(shutdownTimer, SIGNAL(timeout()), this,
-                SLOT(onGracefulShutdownTimeout()));
-        shutdownTimer->start(10000);
+            QString::fromUtf8("成功发送信号 %1 到PID %2。等待%3秒...")
+                .arg(config.stopSignal)
+                .arg(pid)
+                .arg(config.stopTimeoutSec));
+        m_shutdownQueue->add(id, identity, config.stopTimeoutSec * 1000);
     }
     else
     {
-        emit logMessage(
-            QString::fromUtf8(
-                "[错误] 发送SIGTERM到PID %1 失败。可能进程已不存在或权限不足。")
-                .arg(pid));
-        if (m_processConfigs[id].status != "Stopped")
+        if (!sameProcess)
+        {
+            emit logMessage(
+                QString::fromUtf8(
+                    "[警告] 服务 %1 的进程 (PID: %2) 已退出或PID已被其他进程复用，"
+                    "不发送停止信号。")
+                    .arg(id)
+                    .arg(pid));
+        }
+        else
+        {
+            emit logMessage(
+                QString::fromUtf8(
+                    "[错误] 发送信号 %1 到PID %2 失败。可能进程已不存在或权限不足。")
+                    .arg(config.stopSignal)
+                    .arg(pid));
+        }
+        if (stateOf(id) != ProcessState::Stopped &&
+            setState(id, ProcessState::Stopped))
         {
-            m_processConfigs[id].status = "Stopped";
-            emit processStatusChanged(id, "Stopped", 0, 0.0, 0.0);
+            emit processStatusChanged(id, ProcessState::Stopped, 0, 0.0, 0.0);
         }
     }
 }
 
 void BackendWorker::restartProcess(const QString &id)
 {
+    TraceSpan span("process", "restartProcess", id);
     emit logMessage(QString::fromUtf8("后台线程：收到重启请求: %1。").arg(id));
     if (!m_restartQueue.contains(id))
     {
@@ -347,66 +700,811 @@ void BackendWorker::restartProcess(const QString &id)
     this->stopProcess(id);
 }
 
-void BackendWorker::onDelayedStart()
+void BackendWorker::onRestartDue(const QString &id)
 {
-    if (!m_lastToStartForRestart.isEmpty())
-    {
-        startProcess(m_lastToStartForRestart);
-        m_lastToStartForRestart.clear();
-    }
+    TraceSpan span("restart", "onRestartDue", id);
+    RuntimeEntry *runtime = m_runtime.find(id);
+    if (!runtime || runtime->state != ProcessState::Stopped)
+        return;
+
+    int count = m_restartBackoff->countRestart(id);
+    runtime->restartCount = count;
+    emit restartCountChanged(id, count);
+
+    emit logMessage(
+        QString::fromUtf8("[自愈] 服务 %1 退避结束，执行第 %2 次自动重启...")
+            .arg(id)
+            .arg(count));
+    m_autoRestartId = id;
+    startProcess(id);
+    m_autoRestartId.clear();
 }
 
-void BackendWorker::onGracefulShutdownTimeout()
+void BackendWorker::onProbeFailed(const QString &id, int failures,
+                                  const QString &reason)
 {
-    QTimer *timer = qobject_cast<QTimer *>(sender());
-    if (!timer)
+    m_healthProber->unwatch(id);
+    if (stateOf(id) != ProcessState::Running)
         return;
 
-    qint64 pid = timer->objectName().toLongLong();
-    if (pid <= 0 || !m_shutdownPidToIdMap.contains(pid))
+    emit logMessage(
+        QString::fromUtf8("[自愈] 服务 %1 健康探测连续失败 %2 次(%3)，触发重启。")
+            .arg(id)
+            .arg(failures)
+            .arg(reason));
+    m_healthStates.remove(id);
+    restartProcess(id);
+}
+
+void BackendWorker::onReadinessPoll()
+{
+    if (m_awaitingReady.isEmpty())
     {
-        timer->deleteLater();
+        m_readinessTimer->stop();
         return;
     }
 
-    QString id = m_shutdownPidToIdMap.value(pid);
+    m_listeningSockets.invalidate();
+    QList<QString> ids = m_awaitingReady.keys();
+    for (int i = 0; i < ids.count(); ++i)
+    {
+        qint64 pid = livePid(ids.at(i));
+        if (pid > 0 && checkReadiness(ids.at(i), pid))
+        {
+            emit processStatusChanged(ids.at(i), ProcessState::Running, pid,
+                                      0.0, 0.0);
+        }
+    }
+}
+
+bool BackendWorker::checkReadiness(const QString &id, qint64 pid)
+{
+    QHash<QString, qint64>::iterator it = m_awaitingReady.find(id);
+    if (it == m_awaitingReady.end())
+        return true;
 
-    if (::kill(pid, 0) == 0)
+    const ProcessInfo &config = m_processConfigs[id];
+    qint64 elapsedMs = m_monotonic.elapsed() - it.value();
+    if (m_listeningSockets.isListening(pid, (quint16)config.readiness.port))
     {
         emit logMessage(
-            QString::fromUtf8("[警告] 服务 %1 (PID: %2) "
-                              "未能在10秒内优雅退出。强制终止 (SIGKILL)...")
+            QString::fromUtf8("[就绪] 服务 %1 已在端口 %2 监听，启动耗时 %3 秒。")
                 .arg(id)
-                .arg(pid));
-        ::kill(pid, SIGKILL);
+                .arg(config.readiness.port)
+                .arg(elapsedMs / 1000.0, 0, 'f', 2));
+    }
+    else if (elapsedMs >= config.readiness.timeoutSeconds * 1000LL)
+    {
+        emit logMessage(
+            QString::fromUtf8("[警告] 服务 %1 未能在 %2 秒内监听端口 %3，按已启动处理。")
+                .arg(id)
+                .arg(config.readiness.timeoutSeconds)
+                .arg(config.readiness.port));
+    }
+    else
+    {
+        return false;
     }
 
-    m_shutdownPidToIdMap.remove(pid);
-    timer->deleteLater();
+    m_awaitingReady.erase(it);
+    setState(id, ProcessState::Running);
+    return true;
 }
 
-void BackendWorker::onMonitorTimeout()
+void BackendWorker::registerService(const ProcessInfo &info)
 {
-    // --- 1. 更新系统全局资源 ---
-    QFile memFile("/proc/meminfo");
-    double memPercent = -1.0;
-    if (memFile.open(QIODevice::ReadOnly))
+    m_processConfigs[info.id] = info;
+    m_runtime.acquire(info.id);
+    m_runtime.find(info.id)->pidFile = info.pidFile;
+}
+
+ProcessInfo BackendWorker::snapshot(const QString &id) const
+{
+    ProcessInfo info = m_processConfigs.value(id);
+    const RuntimeEntry *runtime = m_runtime.find(id);
+    if (runtime)
     {
-        QByteArray content = memFile.readAll();
-        memFile.close();
-        if (content.size() > 0)
-        {
-            QString contentStr(content);
-            QStringList lines = contentStr.split('\n');
-            long long memTotal = 0, memAvailable = 0;
-            for (int i = 0; i < lines.count(); ++i)
-            {
-                const QString &line = lines.at(i);
-                if (line.startsWith("MemTotal:"))
-                {
-                    memTotal = line.section(':', 1)
-                                   .trimmed()
-                                   .split(' ')
+        info.state = runtime->state;
+        info.stateSinceMs = runtime->stateSinceMs;
+        info.pid = runtime->pid;
+        info.cpuUsage = runtime->cpuUsage;
+        info.memUsage = runtime->memUsage;
+        info.restartCount = runtime->restartCount;
+    }
+    QHash<QString, LifecycleTimings>::const_iterator timings =
+        m_lifecycleTimings.constFind(id);
+    if (timings != m_lifecycleTimings.constEnd())
+    {
+        info.startLatency = timings->summary(LifecycleTimings::Ready);
+        info.stopLatency = timings->summary(LifecycleTimings::Stop);
+    }
+    return info;
+}
+
+ProcessState::State BackendWorker::stateOf(const QString &id) const
+{
+    const RuntimeEntry *runtime = m_runtime.find(id);
+    return runtime ? runtime->state : ProcessState::Stopped;
+}
+
+bool BackendWorker::setState(const QString &id, ProcessState::State to)
+{
+    RuntimeEntry *runtime = m_runtime.find(id);
+    if (!runtime)
+        return false;
+
+    ProcessState::State from = runtime->state;
+    if (from == to)
+        return true;
+
+    if (!ProcessState::isLegalTransition(from, to))
+    {
+        emit logMessage(
+            QString::fromUtf8("[状态机] 服务 %1 拒绝非法的状态转换 %2 -> %3。")
+                .arg(id)
+                .arg(ProcessState::name(from))
+                .arg(ProcessState::name(to)));
+        return false;
+    }
+
+    qint64 now = m_monotonic.elapsed();
+    qint64 dwellMs = runtime->stateSinceMs > 0 ? now - runtime->stateEnteredMono : 0;
+    runtime->state = to;
+    runtime->stateEnteredMono = now;
+    runtime->stateSinceMs = QDateTime::currentMSecsSinceEpoch();
+
+    onStateExited(id, from, dwellMs);
+    onStateEntered(id, to, from);
+    return true;
+}
+
+void BackendWorker::onStateExited(const QString &id, ProcessState::State from,
+                                  qint64 dwellMs)
+{
+    if (from == ProcessState::Starting)
+    {
+        // 无论就绪、退出还是被停止，都不再等待就绪
+        m_awaitingReady.remove(id);
+    }
+    else if (from == ProcessState::Stopping)
+    {
+        // Stopping 只会转到空闲状态，停留时长即停止信号到观察到退出的耗时
+        recordLifecycle(id, LifecycleTimings::Stop, dwellMs);
+    }
+}
+
+void BackendWorker::onStateEntered(const QString &id, ProcessState::State to,
+                                   ProcessState::State from)
+{
+    RuntimeEntry *runtime = m_runtime.find(id);
+    if (to == ProcessState::Starting && runtime)
+    {
+        runtime->startRequestedMono = runtime->stateEnteredMono;
+        runtime->seenAlive = false;
+    }
+    else if (to == ProcessState::Running && from == ProcessState::Starting)
+    {
+        if (runtime && runtime->startRequestedMono > 0)
+        {
+            qint64 startedMs = runtime->stateEnteredMono - runtime->startRequestedMono;
+            // 由就绪轮询切换时，监控周期还没来得及看到进程
+            if (!runtime->seenAlive)
+            {
+                runtime->seenAlive = true;
+                recordLifecycle(id, LifecycleTimings::FirstSeen, startedMs);
+            }
+            recordLifecycle(id, LifecycleTimings::Ready, startedMs);
+        }
+        if (runtime && runtime->crashedMono > 0)
+        {
+            qint64 recoveryMs = runtime->stateEnteredMono - runtime->crashedMono;
+            runtime->crashedMono = 0;
+            recordLifecycle(id, LifecycleTimings::Recovery, recoveryMs);
+            emit logMessage(
+                QString::fromUtf8("[自愈] 服务 %1 已恢复运行，距意外退出 %2 秒。")
+                    .arg(id)
+                    .arg(recoveryMs / 1000.0, 0, 'f', 1));
+        }
+        onServiceReady(id);
+    }
+    else if (ProcessState::isIdle(to))
+    {
+        // 被隔离后不会再自动恢复
+        if (to == ProcessState::Quarantined && runtime)
+            runtime->crashedMono = 0;
+        if (to == ProcessState::Error || to == ProcessState::Quarantined)
+            failWaitingDependents(id, to);
+
+        // 进程已不存在：结束探测和趋势跟踪，归还计划任务的并发名额
+        m_healthProber->unwatch(id);
+        m_leakStates.remove(id);
+        m_taskDispatcher->taskFinished(id);
+
+        // 停止全部时推迟到本轮事件之后推进，不在监控循环中途发出新的停止
+        if (m_stopAllActive && m_stopAllStopping.remove(id))
+            m_stopAllAdvanceTimer->start();
+    }
+}
+
+void BackendWorker::onServiceReady(const QString &id)
+{
+    Q_UNUSED(id);
+    if (m_waitingForDeps.isEmpty())
+        return;
+
+    QStringList waiting = m_waitingForDeps;
+    for (int i = 0; i < waiting.count(); ++i)
+    {
+        if (m_waitingForDeps.contains(waiting.at(i)) &&
+            unreadyDependencies(waiting.at(i)).isEmpty())
+        {
+            m_waitingForDeps.removeAll(waiting.at(i));
+            startProcess(waiting.at(i));
+        }
+    }
+}
+
+void BackendWorker::failWaitingDependents(const QString &id,
+                                          ProcessState::State state)
+{
+    if (m_waitingForDeps.isEmpty())
+        return;
+
+    QStringList waiting = m_waitingForDeps;
+    for (int i = 0; i < waiting.count(); ++i)
+    {
+        const QString &dependent = waiting.at(i);
+        if (!m_waitingForDeps.contains(dependent) ||
+            !m_processConfigs.value(dependent).dependsOn.contains(id))
+        {
+            continue;
+        }
+
+        m_waitingForDeps.removeAll(dependent);
+        emit logMessage(
+            QString::fromUtf8("[依赖] 服务 %1 所依赖的 %2 已进入 %3 状态，取消启动。")
+                .arg(dependent)
+                .arg(id)
+                .arg(ProcessState::name(state)));
+        // 转为 Error 时会递归处理等待它的服务
+        if (ProcessState::isLegalTransition(stateOf(dependent), ProcessState::Error) &&
+            setState(dependent, ProcessState::Error))
+        {
+            emit processStatusChanged(dependent, ProcessState::Error, -1, 0.0, 0.0);
+        }
+    }
+}
+
+QStringList BackendWorker::unreadyDependencies(const QString &id) const
+{
+    QStringList unready;
+    const QStringList &deps = m_processConfigs.value(id).dependsOn;
+    for (int i = 0; i < deps.count(); ++i)
+    {
+        QMap<QString, ProcessInfo>::const_iterator dep =
+            m_processConfigs.constFind(deps.at(i));
+        if (dep != m_processConfigs.constEnd() && stateOf(deps.at(i)) != ProcessState::Running)
+        {
+            unready.append(deps.at(i));
+        }
+    }
+    return unready;
+}
+
+QStringList BackendWorker::dependencyCycle(const QString &id) const
+{
+    // 深度优先，path 为当前路径；done 中的服务已确认不在环上
+    QStringList path;
+    QList<int> nextDep;
+    QSet<QString> done;
+    path.append(id);
+    nextDep.append(0);
+    while (!path.isEmpty())
+    {
+        const QStringList deps = m_processConfigs.value(path.last()).dependsOn;
+        int &next = nextDep.last();
+        if (next >= deps.count())
+        {
+            done.insert(path.takeLast());
+            nextDep.removeLast();
+            continue;
+        }
+
+        const QString &dep = deps.at(next++);
+        if (!m_processConfigs.contains(dep) || done.contains(dep))
+            continue;
+        int onPath = path.indexOf(dep);
+        if (onPath >= 0)
+        {
+            QStringList cycle = path.mid(onPath);
+            cycle.append(dep);
+            return cycle;
+        }
+        path.append(dep);
+        nextDep.append(0);
+    }
+    return QStringList();
+}
+
+void BackendWorker::evaluateLeakTrend(const ProcessInfo &config, qint64 pid,
+                                      double memMB)
+{
+    const ProcessInfo::LeakDetection &leak = config.leakDetection;
+    double threshold = leak.thresholdMB;
+    if (threshold <= 0.0)
+        threshold = config.maxMem;
+    if (threshold <= 0.0)
+        threshold = (double)config.limits.memoryMaxMB;
+    if (threshold <= 0.0)
+        return;
+
+    QHash<QString, LeakState>::iterator it = m_leakStates.find(config.id);
+    if (it == m_leakStates.end() || it->pid != pid)
+    {
+        LeakState state;
+        state.pid = pid;
+        state.trend = LeakTrend(leak.windowMinutes * 60.0);
+        state.warned = false;
+        state.gaveUp = false;
+        it = m_leakStates.insert(config.id, state);
+    }
+    LeakState &state = it.value();
+
+    state.trend.addSample(m_monotonic.elapsed(), memMB);
+
+    QDateTime now = QDateTime::currentDateTime();
+    if (state.restartAt.isValid() && now >= state.restartAt)
+    {
+        QTime start;
+        QTime end;
+        if (parseQuietWindow(leak.restartWindow, &start, &end) &&
+            inQuietWindow(now.time(), start, end))
+        {
+            emit logMessage(
+                QString::fromUtf8("[泄漏] 服务 %1 已进入空闲时段，执行预测性重启。")
+                    .arg(config.id));
+            m_leakStates.erase(it);
+            restartProcess(config.id);
+            return;
+        }
+        // 错过了时段(例如系统挂起)，顺延到下一个
+        state.restartAt = nextQuietWindow(now, start, end);
+    }
+
+    // 只对明显线性增长的趋势做判断，GC等周期性波动的拟合优度很低
+    if (!state.trend.hasFit() || state.trend.rSquared() < 0.8)
+        return;
+
+    qint64 secondsLeft = state.trend.secondsUntil(threshold);
+    if (secondsLeft < 0)
+        return;
+    double hoursLeft = secondsLeft / 3600.0;
+
+    if (!state.warned && hoursLeft <= leak.warnHours)
+    {
+        state.warned = true;
+        emit logMessage(
+            QString::fromUtf8("[泄漏] 服务 %1 内存持续增长 %2 MB/小时 (R²=%3)，"
+                              "预计 %4 小时后达到 %5 MB。")
+                .arg(config.id)
+                .arg(state.trend.slopePerHour(), 0, 'f', 1)
+                .arg(state.trend.rSquared(), 0, 'f', 2)
+                .arg(hoursLeft, 0, 'f', 1)
+                .arg(threshold));
+    }
+
+    QTime start;
+    QTime end;
+    if (state.restartAt.isValid() || state.gaveUp ||
+        hoursLeft > leak.restartWithinHours ||
+        !parseQuietWindow(leak.restartWindow, &start, &end))
+        return;
+
+    QDateTime windowStart = nextQuietWindow(now, start, end);
+    QDateTime breachAt = now.addSecs(secondsLeft);
+    if (windowStart >= breachAt)
+    {
+        emit logMessage(
+            QString::fromUtf8("[泄漏] 服务 %1 预计在下一个空闲时段(%2)之前即达到阈值，"
+                              "届时将由健康检查处理。")
+                .arg(config.id)
+                .arg(windowStart.toString("yyyy-MM-dd hh:mm")));
+        state.gaveUp = true;  // 不再重复计算
+        return;
+    }
+
+    state.restartAt = windowStart;
+    emit logMessage(
+        QString::fromUtf8("[泄漏] 已安排服务 %1 在 %2 预测性重启。")
+            .arg(config.id)
+            .arg(windowStart.toString("yyyy-MM-dd hh:mm")));
+}
+
+void BackendWorker::runBulkOperation(const QString &action,
+                                     const QStringList &ids)
+{
+    if (action != "start" && action != "stop" && action != "restart" &&
+        action != "delete")
+    {
+        emit logMessage(
+            QString::fromUtf8("[错误] 未知的批量操作: %1").arg(action));
+        return;
+    }
+
+    emit logMessage(
+        QString::fromUtf8("后台线程：收到批量操作 %1，共 %2 个服务，并发 %3。")
+            .arg(action)
+            .arg(ids.count())
+            .arg(m_bulkExecutor->maxParallel()));
+    m_bulkExecutor->submit(action, ids);
+}
+
+// 分组成员在执行时才确定，之后加入该分组的服务不在本批次内
+void BackendWorker::runGroupOperation(const QString &action,
+                                      const QString &group)
+{
+    if (action != "start" && action != "stop" && action != "restart")
+    {
+        emit logMessage(
+            QString::fromUtf8("[错误] 不支持的分组操作: %1").arg(action));
+        return;
+    }
+
+    QStringList ids;
+    for (QMap<QString, ProcessInfo>::const_iterator it =
+             m_processConfigs.constBegin();
+         it != m_processConfigs.constEnd(); ++it)
+    {
+        if (!group.isEmpty() && it.value().group == group)
+        {
+            ids.append(it.key());
+        }
+    }
+    if (ids.isEmpty())
+    {
+        emit logMessage(
+            QString::fromUtf8("[分组] 分组 '%1' 中没有服务。").arg(group));
+        return;
+    }
+
+    emit logMessage(
+        QString::fromUtf8("[分组] 对分组 '%1' 执行 %2，共 %3 个服务，并发 %4。")
+            .arg(group)
+            .arg(action)
+            .arg(ids.count())
+            .arg(m_bulkExecutor->maxParallel()));
+    m_bulkExecutor->submit(action, ids, group);
+}
+
+void BackendWorker::onBulkExecuteItem(const QString &action, const QString &id)
+{
+    if (!m_processConfigs.contains(id))
+    {
+        m_bulkExecutor->itemFinished(id, false, QString::fromUtf8("服务不存在"));
+        return;
+    }
+
+    bool running = livePid(id) > 0;
+    if (action == "start")
+    {
+        if (running)
+        {
+            m_bulkExecutor->itemFinished(id, true);
+            return;
+        }
+        startProcess(id);
+        finishIfNotStarting(id);
+    }
+    else if (action == "stop")
+    {
+        // 没有进程时仍调用 stopProcess，以取消等待中的自动重启/依赖启动
+        stopProcess(id);
+        if (!running)
+        {
+            m_bulkExecutor->itemFinished(id, true);
+        }
+    }
+    else if (action == "restart")
+    {
+        // 未运行的服务直接启动
+        if (running)
+        {
+            restartProcess(id);
+        }
+        else
+        {
+            startProcess(id);
+            finishIfNotStarting(id);
+        }
+    }
+    else if (action == "delete")
+    {
+        if (running)
+        {
+            m_bulkExecutor->itemFinished(id, false,
+                                         QString::fromUtf8("运行中，需先停止"));
+            return;
+        }
+        onDeleteServiceRequested(id);
+        m_bulkExecutor->itemFinished(id, true);
+    }
+}
+
+// startProcess 拒绝启动(例如PID文件残留)时不会有后续状态变化，立即按失败结束
+void BackendWorker::finishIfNotStarting(const QString &id)
+{
+    if (m_processConfigs.contains(id) &&
+        stateOf(id) != ProcessState::Starting &&
+        !m_waitingForDeps.contains(id))
+    {
+        m_bulkExecutor->itemFinished(id, false,
+                                     QString::fromUtf8("未能启动，详见日志"));
+    }
+}
+
+void BackendWorker::onOwnStatusChanged(const QString &id,
+                                       ProcessState::State state)
+{
+    m_bulkExecutor->statusChanged(id, state);
+}
+
+void BackendWorker::onShutdownDeadline(const QString &id,
+                                       const ProcessIdentity &identity,
+                                       int timeoutMs)
+{
+    // 等待期间进程可能已退出、PID又被分配给别的进程，
+    // SIGKILL 之前按发送停止信号时的身份再核对一次
+    qint64 pid = identity.pid;
+    if (m_procFs.isSameProcess(identity))
+    {
+        emit logMessage(
+            QString::fromUtf8("[警告] 服务 %1 (PID: %2) "
+                              "未能在%3秒内优雅退出。强制终止 (SIGKILL)...")
+                .arg(id)
+                .arg(pid)
+                .arg(timeoutMs / 1000));
+        m_procFs.sendSignal(pid, SIGKILL);
+    }
+}
+
+void BackendWorker::stopAllProcesses()
+{
+    m_dependents.clear();
+    m_stopAllPending.clear();
+    m_stopAllStopping.clear();
+    for (QMap<QString, ProcessInfo>::const_iterator it =
+             m_processConfigs.constBegin();
+         it != m_processConfigs.constEnd(); ++it)
+    {
+        const QStringList &deps = it.value().dependsOn;
+        for (int i = 0; i < deps.count(); ++i)
+        {
+            m_dependents[deps.at(i)].append(it.key());
+        }
+        if (livePid(it.key()) > 0)
+        {
+            m_stopAllPending.insert(it.key());
+        }
+    }
+
+    // 正在排队的重启不再执行；停止期间也不派发计划任务
+    m_restartQueue.clear();
+    m_restartBackoff->cancelAll();
+    m_waitingForDeps.clear();
+    m_taskDispatcher->setPaused(true);
+
+    emit logMessage(
+        QString::fromUtf8("后台线程：开始停止全部 %1 个运行中的服务...")
+            .arg(m_stopAllPending.count()));
+
+    m_stopAllActive = true;
+    advanceStopAll();
+}
+
+qint64 BackendWorker::livePid(const QString &id) const
+{
+    QMap<QString, ProcessInfo>::const_iterator it = m_processConfigs.constFind(id);
+    if (it == m_processConfigs.constEnd() || it.value().pidFile.isEmpty())
+        return 0;
+
+    ProcessIdentity identity;
+    if (!PidFile::read(it.value().pidFile, &identity))
+        return 0;
+    return m_procFs.isSameProcess(identity) ? identity.pid : 0;
+}
+
+// 一次列出全部存活的PID，只对PID文件指向存活进程的服务读取 stat 和 cmdline；
+// 身份核对通过的服务直接进入 Running，界面加载时就显示正确的状态和PID，
+// 不必等第一个监控周期
+void BackendWorker::reattachServices()
+{
+    TraceSpan span("monitor", "reattachServices");
+    emit logMessage(QString::fromUtf8("后台线程：正在核对PID文件并接管运行中的服务..."));
+
+    QSet<qint64> live = m_procFs.livePids();
+    int reattached = 0;
+    int cleaned = 0;
+    for (QMap<QString, ProcessInfo>::const_iterator it =
+             m_processConfigs.constBegin();
+         it != m_processConfigs.constEnd(); ++it)
+    {
+        const QString &id = it.key();
+        const ProcessInfo &config = it.value();
+
+        ProcessIdentity recorded;
+        if (config.pidFile.isEmpty() || !PidFile::read(config.pidFile, &recorded))
+            continue;
+
+        ProcessIdentity current;
+        QString stale;
+        if (recorded.pid <= 0)
+        {
+            stale = QString::fromUtf8("内容无效");
+        }
+        else if (!live.contains(recorded.pid) ||
+                 !m_procFs.readIdentity(recorded.pid, &current))
+        {
+            stale = QString::fromUtf8("进程 %1 已不存在").arg(recorded.pid);
+        }
+        else if (recorded.startTime > 0 && current.startTime != recorded.startTime)
+        {
+            stale = QString::fromUtf8("PID %1 已被其他进程复用(启动时刻不符)")
+                        .arg(recorded.pid);
+        }
+        else if (recorded.cmdlineHash != 0 &&
+                 current.cmdlineHash != recorded.cmdlineHash)
+        {
+            stale = QString::fromUtf8("PID %1 已被其他进程复用(命令行不符)")
+                        .arg(recorded.pid);
+        }
+        else if (recorded.startTime == 0)
+        {
+            // 旧格式的PID文件没有身份可核对，至少确认运行的是配置的程序
+            QByteArray cmdline;
+            if (!m_procFs.readCmdline(recorded.pid, &cmdline) ||
+                !ProcFs::cmdlineRuns(cmdline, config.command))
+            {
+                stale = QString::fromUtf8("PID %1 运行的不是 %2(旧格式，命令行不符)")
+                            .arg(recorded.pid)
+                            .arg(config.command);
+            }
+        }
+
+        if (!stale.isEmpty())
+        {
+            emit logMessage(
+                QString::fromUtf8("[清理] 服务 %1 的PID文件已过时: %2，正在删除...")
+                    .arg(id)
+                    .arg(stale));
+            QFile::remove(config.pidFile);
+            ++cleaned;
+            continue;
+        }
+
+        // 旧格式的PID文件补写身份，之后就能完整核对了
+        if (recorded.startTime == 0)
+        {
+            QString error;
+            if (PidFile::write(config.pidFile, current, &error))
+            {
+                emit logMessage(
+                    QString::fromUtf8("[迁移] 服务 %1 的PID文件为旧格式，已补写进程身份。")
+                        .arg(id));
+            }
+            else
+            {
+                emit logMessage(
+                    QString::fromUtf8("[警告] 无法更新服务 %1 的PID文件: %2")
+                        .arg(id)
+                        .arg(error));
+            }
+        }
+
+        RuntimeEntry *runtime = m_runtime.find(id);
+        if (!runtime)
+            continue;
+        runtime->pid = current.pid;
+        runtime->startTime = current.startTime;
+        runtime->hasPrevCpu = false;
+        if (setState(id, ProcessState::Running))
+            ++reattached;
+    }
+
+    emit logMessage(
+        QString::fromUtf8("后台线程：已接管 %1 个运行中的服务，清理 %2 个过时的PID文件。")
+            .arg(reattached)
+            .arg(cleaned));
+}
+
+// 同时向所有不再被依赖的服务发送停止信号；某个服务进入空闲状态后，
+// 它所依赖的服务随之解除阻塞。推进由状态变化触发：本进程的子进程由收割者
+// 立即报告，其余进程的退出由监控周期发现
+void BackendWorker::advanceStopAll()
+{
+    if (!m_stopAllActive)
+        return;
+
+    bool progressed = true;
+    while (progressed && !m_stopAllPending.isEmpty())
+    {
+        progressed = false;
+        QList<QString> pending = m_stopAllPending.values();
+        for (int i = 0; i < pending.count(); ++i)
+        {
+            const QString &id = pending.at(i);
+            bool blocked = false;
+            const QStringList dependents = m_dependents.value(id);
+            for (int j = 0; j < dependents.count() && !blocked; ++j)
+            {
+                blocked = m_stopAllPending.contains(dependents.at(j)) ||
+                          m_stopAllStopping.contains(dependents.at(j));
+            }
+            if (blocked)
+                continue;
+
+            m_stopAllPending.remove(id);
+            stopProcess(id);
+            if (stateOf(id) == ProcessState::Stopping)
+                m_stopAllStopping.insert(id);
+            progressed = true;
+        }
+
+        // 依赖关系成环：没有服务在停止中却仍有服务被阻塞，直接全部停止
+        if (!progressed && !m_stopAllPending.isEmpty() &&
+            m_stopAllStopping.isEmpty())
+        {
+            emit logMessage(QString::fromUtf8(
+                "[警告] 服务依赖关系存在循环，剩余服务将同时停止。"));
+            QList<QString> remaining = m_stopAllPending.values();
+            m_stopAllPending.clear();
+            for (int i = 0; i < remaining.count(); ++i)
+            {
+                stopProcess(remaining.at(i));
+                if (stateOf(remaining.at(i)) == ProcessState::Stopping)
+                    m_stopAllStopping.insert(remaining.at(i));
+            }
+        }
+    }
+
+    if (m_stopAllPending.isEmpty() && m_stopAllStopping.isEmpty())
+    {
+        m_stopAllActive = false;
+        m_stopAllAdvanceTimer->stop();
+        m_taskDispatcher->setPaused(false);
+        emit logMessage(QString::fromUtf8("后台线程：所有服务均已停止。"));
+        emit allProcessesStopped();
+    }
+}
+
+void BackendWorker::onMonitorTimeout()
+{
+    // open/close/stat 不在统计之内
+    QElapsedTimer tickTimer;
+    tickTimer.start();
+    quint64 syscallsBefore = threadSyscalls() + m_procFs.syscallCount();
+    TraceSpan tickSpan("monitor", "onMonitorTimeout");
+
+    TraceSpan systemSpan("monitor", "readSystemStats");
+    // --- 1. 更新系统全局资源 ---
+    QFile memFile(m_procFs.path("meminfo"));
+    double memPercent = -1.0;
+    if (memFile.open(QIODevice::ReadOnly))
+    {
+        QByteArray content = memFile.readAll();
+        memFile.close();
+        if (content.size() > 0)
+        {
+            QString contentStr(content);
+            QStringList lines = contentStr.split('\n');
+            long long memTotal = 0, memAvailable = 0;
+            for (int i = 0; i < lines.count(); ++i)
+            {
+                const QString &line = lines.at(i);
+                if (line.startsWith("MemTotal:"))
+                {
+                    memTotal = line.section(':', 1)
+                                   .trimmed()
+                                   .split(' ')
                                    .at(0)
                                    .toLongLong();
                 }
@@ -427,7 +1525,7 @@ void BackendWorker::onMonitorTimeout()
         }
     }
 
-    QFile statFile("/proc/stat");
+    QFile statFile(m_procFs.path("stat"));
     unsigned long long currentSystemTotalTime = 0;
     unsigned long long currentSystemWorkTime = 0;
     double cpuPercent = 0.0;
@@ -460,33 +1558,79 @@ void BackendWorker::onMonitorTimeout()
         }
     }
     emit systemMetricsUpdated(cpuPercent, memPercent);
+    systemSpan.finish();
 
     // --- 2. 遍历所有已配置的服务，更新状态 ---
-    QList<QString> all_ids = m_processConfigs.keys();
-    for (int i = 0; i < all_ids.count(); ++i)
+    TraceSpan servicesSpan("monitor", "sampleServices");
+    m_listeningSockets.invalidate();
+    // 顺序遍历运行时表；配置只按引用读取，循环中既不分配ID列表也不拷贝 ProcessInfo
+    for (int handle = 0; handle < m_runtime.capacity(); ++handle)
     {
-        QString id = all_ids.at(i);
-        ProcessInfo config = m_processConfigs.value(id);
+        RuntimeEntry &runtime = m_runtime.at(handle);
+        if (!runtime.used || runtime.pidFile.isEmpty())
+            continue;
 
-        if (config.pidFile.isEmpty())
+        QMap<QString, ProcessInfo>::const_iterator configIt =
+            m_processConfigs.constFind(runtime.id);
+        if (configIt == m_processConfigs.constEnd())
             continue;
+        const QString &id = configIt.key();
+        const ProcessInfo &config = configIt.value();
+        TraceSpan sampleSpan("monitor", "sampleService", id);
 
-        qint64 current_pid = 0;
-        QFile pidFile(config.pidFile);
-        if (pidFile.exists() && pidFile.open(QIODevice::ReadOnly))
+        ProcessIdentity identity;
+        PidFile::read(runtime.pidFile, &identity);
+        qint64 current_pid = identity.pid;
+
+        bool process_exists = m_procFs.isAlive(current_pid);
+
+        // stat 先读：其中的 starttime 用来确认PID没有被别的进程复用
+        QStringList statFields;
+        if (process_exists)
         {
-            current_pid = pidFile.readAll().trimmed().toLongLong();
-            pidFile.close();
-        }
+            QByteArray stat;
+            QFile procStatFile(m_procFs.pidPath(current_pid, "stat"));
+            if (procStatFile.open(QIODevice::ReadOnly))
+            {
+                stat = procStatFile.readAll();
+                procStatFile.close();
+                QString content = stat;
+                statFields = content.mid(content.lastIndexOf(')') + 2).split(' ');
+            }
+            unsigned long long startTime = ProcFs::parseStartTime(stat);
+            // 旧格式的PID文件没有记录身份，以接管或第一次看到时的为准
+            unsigned long long expected = identity.startTime;
+            if (expected == 0 && runtime.pid == current_pid)
+                expected = runtime.startTime;
 
-        bool process_exists = (current_pid > 0 && ::kill(current_pid, 0) == 0);
+            if (statFields.isEmpty())
+            {
+                process_exists = false;
+            }
+            else if (expected > 0 && startTime != expected)
+            {
+                emit logMessage(
+                    QString::fromUtf8("[警告] 服务 %1 的PID %2 已被其他进程复用，按已退出处理。")
+                        .arg(id)
+                        .arg(current_pid));
+                QFile::remove(runtime.pidFile);
+                process_exists = false;
+            }
+            // 进程换了(例如被外部重启)，上个周期的CPU时间不可比
+            else if (runtime.pid != current_pid)
+            {
+                runtime.pid = current_pid;
+                runtime.startTime = startTime;
+                runtime.hasPrevCpu = false;
+            }
+        }
 
         if (process_exists)
         {
             double processCpuUsage = 0.0;
             double processMemUsage = 0.0;
 
-            QFile procMemFile(QString("/proc/%1/statm").arg(current_pid));
+            QFile procMemFile(m_procFs.pidPath(current_pid, "statm"));
             if (procMemFile.open(QIODevice::ReadOnly))
             {
                 QStringList parts = QString(procMemFile.readAll()).split(' ');
@@ -497,93 +1641,149 @@ void BackendWorker::onMonitorTimeout()
                 procMemFile.close();
             }
 
-            QFile procStatFile(QString("/proc/%1/stat").arg(current_pid));
-            if (procStatFile.open(QIODevice::ReadOnly))
+            if (statFields.size() > 13)
             {
-                QString content = procStatFile.readAll();
-                procStatFile.close();
-                QStringList parts =
-                    content.mid(content.indexOf(')') + 2).split(' ');
-                if (parts.size() > 13)
+                unsigned long long processTotalTime =
+                    statFields.at(11).toULongLong() + statFields.at(12).toULongLong();
+                if (runtime.hasPrevCpu && m_prevSystemTotalTime > 0 &&
+                    currentSystemTotalTime > m_prevSystemTotalTime)
                 {
-                    unsigned long long processTotalTime =
-                        parts.at(11).toULongLong() + parts.at(12).toULongLong();
-                    if (m_prevProcessTime.contains(id) &&
-                        m_prevSystemTotalTime > 0 &&
-                        currentSystemTotalTime > m_prevSystemTotalTime)
+                    unsigned long long processDelta =
+                        processTotalTime - runtime.prevCpuTicks;
+                    unsigned long long systemDelta =
+                        currentSystemTotalTime - m_prevSystemTotalTime;
+                    if (systemDelta > 0)
                     {
-                        unsigned long long processDelta =
-                            processTotalTime - m_prevProcessTime.value(id);
-                        unsigned long long systemDelta =
-                            currentSystemTotalTime - m_prevSystemTotalTime;
-                        if (systemDelta > 0)
-                        {
-                            processCpuUsage = (double)(processDelta * 100.0) /
-                                              (double)systemDelta;
-                        }
+                        processCpuUsage = (double)(processDelta * 100.0) /
+                                          (double)systemDelta;
                     }
-                    m_prevProcessTime[id] = processTotalTime;
                 }
+                runtime.prevCpuTicks = processTotalTime;
+                runtime.hasPrevCpu = true;
             }
 
-            if (m_processConfigs[id].status != "Running")
+            runtime.cpuUsage = processCpuUsage;
+            runtime.memUsage = processMemUsage;
+
+            QHash<qint64, RunRecord>::iterator run =
+                m_activeRuns.find(current_pid);
+            if (run != m_activeRuns.end())
             {
-                m_processConfigs[id].status = "Running";
+                run->peakCpu = qMax(run->peakCpu, processCpuUsage);
+                run->peakMemMB = qMax(run->peakMemMB, processMemUsage);
+            }
+
+            if (runtime.state == ProcessState::Starting && !runtime.seenAlive &&
+                runtime.startRequestedMono > 0)
+            {
+                runtime.seenAlive = true;
+                recordLifecycle(id, LifecycleTimings::FirstSeen,
+                                m_monotonic.elapsed() - runtime.startRequestedMono);
+            }
+
+            // 未就绪前保持 Starting，也不做健康检查和探测
+            if (m_awaitingReady.contains(id) && !checkReadiness(id, current_pid))
+            {
+                emit processStatusChanged(id, ProcessState::Starting,
+                                          current_pid, processCpuUsage,
+                                          processMemUsage);
+                continue;
+            }
+
+            // 正在停止的进程退出之前保持 Stopping，只更新指标
+            if (runtime.state == ProcessState::Stopping)
+            {
+                emit processStatusChanged(id, ProcessState::Stopping,
+                                          current_pid, processCpuUsage,
+                                          processMemUsage);
+                continue;
+            }
+
+            // 从 Starting 进入 Running 时由进入钩子通知等待依赖的服务
+            setState(id, ProcessState::Running);
+            emit processStatusChanged(id, runtime.state,
+                                      current_pid, processCpuUsage,
+                                      processMemUsage);
+
+            // exec 探针依赖子进程收割者取得退出码
+            if (config.probe.isEnabled() && !m_healthProber->isWatching(id) &&
+                (config.probe.type != "exec" || m_childReaper->isInstalled()))
+            {
+                m_healthProber->watch(id, config.probe);
             }
-            emit processStatusChanged(id, "Running", current_pid,
-                                      processCpuUsage, processMemUsage);
 
             if (config.healthCheckEnabled)
             {
-                bool isBreached = false;
-                QString breachReason;
-                if (config.maxCpu > 0 && processCpuUsage > config.maxCpu)
+                QHash<QString, HealthState>::iterator health =
+                    m_healthStates.find(id);
+                if (health == m_healthStates.end() ||
+                    health->pid != current_pid)
                 {
-                    isBreached = true;
-                    breachReason = "CPU";
-                }
-                else if (config.maxMem > 0 &&
-                         processMemUsage > config.maxMem)
-                {
-                    isBreached = true;
-                    breachReason = "Memory";
+                    HealthState state;
+                    state.pid = current_pid;
+                    state.cpu = HealthEvaluator(config.cpuWindow, config.maxCpu,
+                                                kMonitorIntervalMs);
+                    state.mem = HealthEvaluator(config.memWindow, config.maxMem,
+                                                kMonitorIntervalMs);
+                    health = m_healthStates.insert(id, state);
                 }
 
-                if (isBreached)
-                {
-                    int count = m_breachCounters.value(id, 0) + 1;
-                    m_breachCounters[id] = count;
-                    if (count >= 3)
-                    {
-                        emit logMessage(
-                            QString::fromUtf8(
-                                "[自愈] 服务 %1 因 %2 持续超标，触发重启。")
-                                .arg(id)
-                                .arg(breachReason));
-                        restartProcess(id);
-                        m_breachCounters.remove(id);
-                    }
-                }
-                else
+                // 两个指标都要采样，保持各自窗口连续
+                qint64 nowMs = m_monotonic.elapsed();
+                bool cpuBreached = health->cpu.addSample(nowMs, processCpuUsage);
+                bool memBreached = health->mem.addSample(nowMs, processMemUsage);
+
+                if (cpuBreached || memBreached)
                 {
-                    m_breachCounters.remove(id);
+                    emit logMessage(
+                        QString::fromUtf8(
+                            "[自愈] 服务 %1 因 %2 持续超标(%3)，触发重启。")
+                            .arg(id)
+                            .arg(cpuBreached ? "CPU" : "Memory")
+                            .arg(cpuBreached ? health->cpu.describe()
+                                             : health->mem.describe()));
+                    m_healthStates.erase(health);
+                    restartProcess(id);
                 }
             }
+
+            if (config.leakDetection.enabled)
+            {
+                evaluateLeakTrend(config, current_pid, processMemUsage);
+            }
         }
         else
         {
             // 进程不存在
-            if (config.status == "Running" || config.status == "Stopping...")
+            // 计划任务可能在监控周期内就执行完毕，来不及进入 Running
+            ProcessState::State previous = runtime.state;
+            bool exitedWhileStarting = (previous == ProcessState::Starting);
+            bool wasStopping = (previous == ProcessState::Stopping);
+            bool restartNow = false;
+            runtime.pid = 0;
+            runtime.startTime = 0;
+            runtime.cpuUsage = 0.0;
+            runtime.memUsage = 0.0;
+            runtime.hasPrevCpu = false;
+            if (previous == ProcessState::Running || wasStopping || exitedWhileStarting)
             {
                 // 根据具体状态，打印不同的日志，让信息更清晰
-                if (config.status == "Running")
+                if (config.type == "task" && !wasStopping)
                 {
-                    // 如果是从"Running"状态直接消失，说明是意外终止
+                    emit logMessage(QString::fromUtf8("[调度器] 任务 %1 已执行结束。").arg(id));
+                }
+                else if (previous == ProcessState::Running)
+                {
+                    // 如果是从 Running 状态直接消失，说明是意外终止
                     emit logMessage(QString::fromUtf8("[警告] 正在运行的服务 %1 已意外终止！PID文件或进程已消失。").arg(id));
                 }
+                else if (exitedWhileStarting)
+                {
+                    emit logMessage(QString::fromUtf8("[警告] 服务 %1 在启动阶段即已退出！").arg(id));
+                }
                 else
-                { // config.status == "Stopping..."
-                    // 如果是从"Stopping"状态消失，说明是我们的 kill 命令成功了
+                { // previous == ProcessState::Stopping
+                    // 如果是从 Stopping 状态消失，说明是我们的 kill 命令成功了
                     emit logMessage(QString::fromUtf8("服务 %1 已成功停止。").arg(id));
                 }
 
@@ -597,28 +1797,66 @@ void BackendWorker::onMonitorTimeout()
                     }
                 }
 
+                if (config.limits.needsCgroup())
+                {
+                    ProcessLauncher::releaseCgroup(id);
+                }
+
                 if (m_restartQueue.contains(id))
                 {
                     m_restartQueue.removeAll(id); // 从队列中移除
-                    emit logMessage(QString::fromUtf8("[重启] 服务 %1 已完全停止，现在执行重启操作...").arg(id));
-                    // 直接调用startProcess，因为此时环境一定是干净的
-                    startProcess(id);
+                    restartNow = true;
                 }
-                else if (config.status == "Running" && config.autoStart)
+                else if (config.type != "task" && config.autoStart &&
+                         !wasStopping && !m_stopAllActive)
                 {
-                    emit logMessage(QString::fromUtf8("[自愈] 服务 %1 将自动重启...").arg(id));
-                    // 同样使用重启队列机制，确保逻辑统一
-                    if (!m_restartQueue.contains(id))
+                    qint64 delayMs = m_restartBackoff->recordFailure(id);
+                    Tracer::instant("restart",
+                                    delayMs < 0 ? "quarantine" : "scheduleRestart",
+                                    id);
+                    if (delayMs < 0)
+                    {
+                        emit logMessage(
+                            QString::fromUtf8("[自愈] 服务 %1 在 %2 秒内连续崩溃 %3 次，"
+                                              "已隔离，不再自动重启。请检查后手动启动。")
+                                .arg(id)
+                                .arg(config.restart.crashLoopWindowSec)
+                                .arg(config.restart.crashLoopCount));
+                    }
+                    else
                     {
-                        m_restartQueue.append(id);
+                        emit logMessage(
+                            QString::fromUtf8("[自愈] 服务 %1 将在 %2 秒后自动重启...")
+                                .arg(id)
+                                .arg(delayMs / 1000.0, 0, 'f', 1));
+                        // 重启后又在启动阶段退出时，恢复耗时仍从第一次意外退出算起
+                        if (runtime.crashedMono == 0)
+                            runtime.crashedMono = m_monotonic.elapsed();
                     }
                 }
             }
 
-            if (m_processConfigs[id].status != "Stopped")
+            // 被隔离的服务保持 Quarantined，直到用户手动启动。
+            // 进入空闲状态的钩子负责清理探测、就绪等待和并发名额
+            ProcessState::State idleState = m_restartBackoff->isQuarantined(id)
+                                                ? ProcessState::Quarantined
+                                                : ProcessState::Stopped;
+            if (runtime.state != idleState && setState(id, idleState))
+            {
+                emit processStatusChanged(id, idleState, 0, 0.0, 0.0);
+            }
+
+            if (current_pid > 0)
             {
-                m_processConfigs[id].status = "Stopped";
-                emit processStatusChanged(id, "Stopped", 0, 0.0, 0.0);
+                m_shutdownQueue->remove(current_pid);
+            }
+
+            // 先进入空闲状态再重启，状态序列为 Stopping -> Stopped -> Starting
+            if (restartNow)
+            {
+                emit logMessage(QString::fromUtf8("[重启] 服务 %1 已完全停止，现在执行重启操作...").arg(id));
+                // 直接调用startProcess，因为此时环境一定是干净的
+                startProcess(id);
             }
         }
     }
@@ -626,171 +1864,367 @@ void BackendWorker::onMonitorTimeout()
     // 更新系统时间基准值
     m_prevSystemTotalTime = currentSystemTotalTime;
     m_prevSystemWorkTime = currentSystemWorkTime;
+
+    servicesSpan.finish();
+
+    m_monitorTickLatency.record(tickTimer.nsecsElapsed() / 1000);
+    m_syscallsPerTick.record(threadSyscalls() + m_procFs.syscallCount() -
+                             syscallsBefore);
+    publishDiagnostics();
+}
+
+quint64 BackendWorker::threadSyscalls()
+{
+    QFile ioFile("/proc/thread-self/io");
+    if (!ioFile.open(QIODevice::ReadOnly))
+        return 0;
+    QList<QByteArray> lines = ioFile.readAll().split('\n');
+    ioFile.close();
+
+    quint64 total = 0;
+    for (int i = 0; i < lines.count(); ++i)
+    {
+        const QByteArray &line = lines.at(i);
+        if (line.startsWith("syscr:") || line.startsWith("syscw:"))
+        {
+            total += line.mid(6).trimmed().toULongLong();
+        }
+    }
+    return total;
+}
+
+void BackendWorker::publishDiagnostics()
+{
+    BackendDiagnostics diagnostics;
+    diagnostics.monitorTick = m_monitorTickLatency.summary();
+    diagnostics.schedulerTick = m_taskScheduler->tickLatency().summary();
+    diagnostics.syscallsPerTick = m_syscallsPerTick.summary();
+    diagnostics.startToReady = m_startToReady.summary();
+    diagnostics.stopToExit = m_stopToExit.summary();
+    diagnostics.recovery = m_recoveryTime.summary();
+    diagnostics.services = m_processConfigs.count();
+    diagnostics.pendingRestarts =
+        m_restartQueue.count() + m_restartBackoff->pendingCount();
+    diagnostics.pendingShutdowns = m_shutdownQueue->count();
+    diagnostics.pendingTasks = m_taskDispatcher->pendingCount();
+    diagnostics.runningTasks = m_taskDispatcher->runningCount();
+    diagnostics.awaitingReady = m_awaitingReady.count();
+    diagnostics.sentAtUs = diagnosticsClockUs();
+    emit diagnosticsUpdated(diagnostics);
+}
+
+void BackendWorker::startFederation(const QSettings &settings)
+{
+    QString address = settings.value("federation/listen").toString().trimmed();
+    if (address.isEmpty() || m_federation)
+        return;
+
+    QString host = settings.value("federation/name").toString().trimmed();
+    if (host.isEmpty())
+        host = QSysInfo::machineHostName();
+
+    m_federation = new FederationServer(host, this);
+    connect(m_federation, SIGNAL(logMessage(QString)), this,
+            SIGNAL(logMessage(QString)));
+    QString error;
+    if (!m_federation->listen(address, &error))
+    {
+        emit logMessage(QString::fromUtf8("[错误] 联合视图服务启动失败: %1").arg(error));
+        delete m_federation;
+        m_federation = 0;
+        return;
+    }
+
+    // 同一线程内直接调用；服务列表随后由 processListLoaded 填入
+    connect(this, SIGNAL(processListLoaded(QList<ProcessInfo>)), m_federation,
+            SLOT(setServices(QList<ProcessInfo>)));
+    connect(this, SIGNAL(processInfoAdded(ProcessInfo)), m_federation,
+            SLOT(setService(ProcessInfo)));
+    connect(this, SIGNAL(serviceInfoUpdated(ProcessInfo)), m_federation,
+            SLOT(setService(ProcessInfo)));
+    connect(this, SIGNAL(serviceDeleted(QString)), m_federation,
+            SLOT(removeService(QString)));
+    connect(this,
+            SIGNAL(processStatusChanged(QString, ProcessState::State, qint64,
+                                        double, double)),
+            m_federation,
+            SLOT(setStatus(QString, ProcessState::State, qint64, double,
+                           double)));
+    connect(this, SIGNAL(restartCountChanged(QString, int)), m_federation,
+            SLOT(setRestartCount(QString, int)));
+    connect(this,
+            SIGNAL(lifecycleTimingsChanged(QString, LatencySummary,
+                                           LatencySummary)),
+            m_federation,
+            SLOT(setLifecycleTimings(QString, LatencySummary, LatencySummary)));
+    // 每个监控周期结束时发出一帧增量
+    connect(this, SIGNAL(diagnosticsUpdated(BackendDiagnostics)), m_federation,
+            SLOT(flush()));
+
+    emit logMessage(QString::fromUtf8("后台线程：联合视图服务已在 %1 监听，主机名 %2。")
+                        .arg(address)
+                        .arg(host));
 }
 
-void BackendWorker::onSchedulerTick()
+void BackendWorker::resetDiagnostics()
 {
-    QDateTime now = QDateTime::currentDateTime();
+    m_monitorTickLatency.reset();
+    m_syscallsPerTick.reset();
+    m_taskScheduler->resetTickLatency();
+    // 各服务自己的启停耗时跨重启保留，不随之清空
+    m_startToReady.reset();
+    m_stopToExit.reset();
+    m_recoveryTime.reset();
+    emit logMessage(QString::fromUtf8("后台线程：自检统计已重置。"));
+}
+
+void BackendWorker::recordLifecycle(const QString &id,
+                                    LifecycleTimings::Phase phase, qint64 ms)
+{
+    LifecycleTimings &timings = m_lifecycleTimings[id];
+    timings.record(phase, ms);
 
-    for (QMap<QString, ProcessInfo>::iterator it = m_processConfigs.begin();
-         it != m_processConfigs.end(); ++it)
+    switch (phase)
     {
-        const ProcessInfo &task = it.value();
+        case LifecycleTimings::Ready:
+            m_startToReady.record(ms);
+            break;
+        case LifecycleTimings::Stop:
+            m_stopToExit.record(ms);
+            break;
+        case LifecycleTimings::Recovery:
+            // 恢复总是伴随一次就绪，由就绪通知界面
+            m_recoveryTime.record(ms);
+            return;
+        default:
+            return;
+    }
 
-        if (task.type != "task")
-        {
-            continue;
-        }
+    emit lifecycleTimingsChanged(id, timings.summary(LifecycleTimings::Ready),
+                                 timings.summary(LifecycleTimings::Stop));
+}
 
-        // 检查进程是否已在运行
-        bool isRunning = false;
-        if (!task.pidFile.isEmpty())
-        {
-            QFile pidFile(task.pidFile);
-            if (pidFile.exists() && pidFile.open(QIODevice::ReadOnly))
-            {
-                qint64 pid = pidFile.readAll().trimmed().toLongLong();
-                pidFile.close();
-                if (pid > 0 && ::kill(pid, 0) == 0)
-                {
-                    isRunning = true;
-                }
-            }
-        }
-        if (isRunning)
-            continue;
+void BackendWorker::onTaskDue(const QString &id,
+                              const QDateTime &scheduledTime)
+{
+    TraceSpan span("scheduler", "onTaskDue", id);
+    if (!m_processConfigs.contains(id))
+        return;
 
-        QDateTime nextDueTime =
-            calculateNextDueTime(task.schedule, m_lastSchedulerCheckTime);
+    const ProcessInfo &task = m_processConfigs[id];
+    if (m_stopAllActive)
+    {
+        emit logMessage(
+            QString::fromUtf8("[调度器] 正在停止全部服务，跳过任务 '%1' 本次执行 (%2)。")
+                .arg(task.name)
+                .arg(scheduledTime.toString("yyyy-MM-dd hh:mm")));
+        return;
+    }
 
-        if (!nextDueTime.isNull() && nextDueTime > m_lastSchedulerCheckTime &&
-            nextDueTime <= now)
-        {
-            emit logMessage(QString::fromUtf8(
-                                "[调度器] 任务 '%1' 已到执行时间，正在启动...")
-                                .arg(task.name));
-            startProcess(task.id);
-        }
+    // 手动启动的实例不经过派发队列，这里同样要检查上一次运行是否仍未结束
+    if (livePid(id) > 0)
+    {
+        emit logMessage(
+            QString::fromUtf8(
+                "[调度器] 任务 '%1' 上一次运行尚未结束，跳过本次 (%2)。")
+                .arg(task.name)
+                .arg(scheduledTime.toString("yyyy-MM-dd hh:mm")));
+        return;
     }
 
-    m_lastSchedulerCheckTime = now;
+    m_taskDispatcher->enqueue(id, task.schedule.concurrencyGroup,
+                              task.schedule.jitterSeconds);
 }
 
-QDateTime BackendWorker::calculateNextDueTime(
-    const ProcessInfo::Schedule &schedule, const QDateTime &after)
+void BackendWorker::onCatchUpDue(const QString &id,
+                                 const QDateTime &scheduledTime)
 {
-    if (schedule.hour < 0 || schedule.minute < 0)
-    {
-        return QDateTime();
-    }
+    TraceSpan span("scheduler", "onCatchUpDue", id);
+    if (!m_processConfigs.contains(id))
+        return;
 
-    QDateTime next = after;
-    QDate nextDate = after.date();
-    QTime nextTime(schedule.hour, schedule.minute);
-    next.setTime(nextTime);
+    const ProcessInfo &task = m_processConfigs[id];
+    emit logMessage(
+        QString::fromUtf8("[调度器] 补跑任务 '%1' 原定于 %2 的执行。")
+            .arg(task.name)
+            .arg(scheduledTime.toString("yyyy-MM-dd hh:mm")));
+    m_taskDispatcher->enqueue(id, task.schedule.concurrencyGroup,
+                              task.schedule.jitterSeconds, true);
+}
 
-    if (schedule.type == "daily")
+void BackendWorker::onTaskReady(const QString &id, qint64 waitMs)
+{
+    TraceSpan span("scheduler", "onTaskReady", id);
+    if (!m_processConfigs.contains(id))
     {
-        if (next <= after)
-        {
-            next = next.addDays(1);
-        }
-        return next;
+        m_taskDispatcher->taskFinished(id);
+        return;
     }
-    else if (schedule.type == "weekly")
-    {
-        if (schedule.dayOfWeek < 1 || schedule.dayOfWeek > 7)
-            return QDateTime();
 
-        int daysToAdd = schedule.dayOfWeek - nextDate.dayOfWeek();
-        if (daysToAdd < 0)
-        {
-            daysToAdd += 7;
-        }
-        next = next.addDays(daysToAdd);
+    emit logMessage(QString::fromUtf8(
+                        "[调度器] 任务 '%1' 已到执行时间，正在启动...")
+                        .arg(m_processConfigs[id].name));
+    // 排队等待随本次运行写入运行历史
+    m_dispatchWaitMs = waitMs;
+    startProcess(id);
+    m_dispatchWaitMs = 0;
 
-        if (next <= after)
-        {
-            next = next.addDays(7);
-        }
-        return next;
-    }
-    else if (schedule.type == "monthly")
+    // 启动失败(或PID文件冲突未启动)时立即归还并发名额
+    if (stateOf(id) != ProcessState::Starting)
     {
-        if (schedule.dayOfMonth < 1)
-            return QDateTime();
+        m_taskDispatcher->taskFinished(id);
+    }
+}
 
-        for (int i = 0; i < 12; ++i)
-        {
-            if (schedule.dayOfMonth > nextDate.daysInMonth())
-            {
-                nextDate = nextDate.addMonths(1);
-                nextDate.setDate(nextDate.year(), nextDate.month(), 1);
-                continue;
-            }
-            nextDate.setDate(nextDate.year(), nextDate.month(),
-                             schedule.dayOfMonth);
-            next.setDate(nextDate);
+void BackendWorker::onChildExited(qint64 pid, int exitCode, int signalNumber,
+                                  qint64 cpuTimeMs, qint64 maxRssKB)
+{
+    if (m_healthProber->childExited(pid, exitCode, signalNumber))
+        return;
 
-            if (next > after)
-            {
-                return next;
-            }
+    // 服务自己派生的孤儿进程也会被挂到本进程下，它们只需回收，不做记录
+    QHash<qint64, RunRecord>::iterator it = m_activeRuns.find(pid);
+    if (it == m_activeRuns.end())
+        return;
 
-            nextDate = after.date().addMonths(1);
-            nextDate.setDate(nextDate.year(), nextDate.month(), 1);
-        }
+    RunRecord run = it.value();
+    m_activeRuns.erase(it);
+    m_shutdownQueue->remove(pid);
+
+    run.endMs = QDateTime::currentMSecsSinceEpoch();
+    run.exitCode = exitCode;
+    run.signalNumber = signalNumber;
+    run.cpuSeconds = cpuTimeMs / 1000.0;
+    run.peakMemMB = qMax(run.peakMemMB, maxRssKB / 1024.0);
+
+    QString name = m_processConfigs.contains(run.id)
+                       ? m_processConfigs[run.id].name
+                       : run.id;
+    QString outcome = signalNumber != 0
+                          ? QString::fromUtf8("被信号 %1 终止").arg(signalNumber)
+                          : QString::fromUtf8("退出码 %1").arg(exitCode);
+    emit logMessage(
+        QString::fromUtf8("%1 '%2' (PID: %3) 已退出，%4，运行 %5 秒。")
+            .arg(run.succeeded() ? QString::fromUtf8("[历史]")
+                                 : QString::fromUtf8("[警告]"))
+            .arg(name)
+            .arg(pid)
+            .arg(outcome)
+            .arg(run.durationMs() / 1000.0, 0, 'f', 1));
+
+    QString error;
+    if (!m_runHistory.append(run, &error))
+    {
+        emit logMessage(QString::fromUtf8("[警告] %1").arg(error));
     }
 
-    return QDateTime();
+    if (m_stopAllActive && stateOf(run.id) == ProcessState::Stopping)
+        finishStopped(run.id, pid);
 }
 
-// core/backendworker.cpp
-
-void BackendWorker::onServiceAdded(const QString &newConfigPath)
+void BackendWorker::finishStopped(const QString &id, qint64 pid)
 {
-    emit logMessage(QString::fromUtf8("后台线程：收到新服务添加请求: %1")
-                        .arg(newConfigPath));
+    QMap<QString, ProcessInfo>::const_iterator it = m_processConfigs.constFind(id);
+    if (it == m_processConfigs.constEnd())
+        return;
+    const ProcessInfo &config = it.value();
 
-    QFile file(newConfigPath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-    {
-        emit logMessage(QString::fromUtf8("[错误] 无法读取新添加的配置文件: %1")
-                            .arg(newConfigPath));
+    // 只处理PID文件仍指向的那个进程；与监控周期发现退出时的处理相同
+    ProcessIdentity identity;
+    if (!PidFile::read(config.pidFile, &identity) || identity.pid != pid)
         return;
-    }
 
-    // --- 1. 读取并解析文件 ---
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
-    file.close();
+    emit logMessage(QString::fromUtf8("服务 %1 已成功停止。").arg(id));
+    if (QFile::remove(config.pidFile))
+    {
+        emit logMessage(QString::fromUtf8("PID文件 %1 已被清理。").arg(config.pidFile));
+    }
+    if (config.limits.needsCgroup())
+    {
+        ProcessLauncher::releaseCgroup(id);
+    }
 
-    if (parseError.error != QJsonParseError::NoError)
+    RuntimeEntry *runtime = m_runtime.find(id);
+    if (runtime)
     {
-        emit logMessage(
-            QString::fromUtf8("[错误] 解析新配置文件失败: %1, 错误: %2")
-                .arg(newConfigPath)
-                .arg(parseError.errorString()));
-        return;
+        runtime->pid = 0;
+        runtime->startTime = 0;
+        runtime->cpuUsage = 0.0;
+        runtime->memUsage = 0.0;
+        runtime->hasPrevCpu = false;
     }
-    if (!doc.isObject())
+    if (setState(id, ProcessState::Stopped))
     {
-        emit logMessage(
-            QString::fromUtf8("[错误] 新配置文件的根元素不是一个对象: %1")
-                .arg(newConfigPath));
-        return;
+        emit processStatusChanged(id, ProcessState::Stopped, 0, 0.0, 0.0);
     }
+}
 
-    // --- 2. 填充ProcessInfo结构体 ---
-    QJsonObject obj = doc.object();
-    ProcessInfo p;
+void BackendWorker::onRunHistoryRequested(const QString &id)
+{
+    QString name = m_processConfigs.contains(id) ? m_processConfigs[id].name
+                                                 : id;
+    emit runHistoryReady(name, m_runHistory.recentRuns(id));
+}
+
+void BackendWorker::loadDispatchSettings()
+{
+    QSettings settings(QCoreApplication::applicationDirPath() + "/manager.ini",
+                       QSettings::IniFormat);
+
+    int globalLimit = settings.value("tasks/maxConcurrent", 0).toInt();
+
+    QMap<QString, int> groupLimits;
+    settings.beginGroup("taskGroups");
+    QStringList groups = settings.childKeys();
+    for (int i = 0; i < groups.count(); ++i)
+    {
+        int limit = settings.value(groups.at(i), 0).toInt();
+        if (limit > 0)
+        {
+            groupLimits[groups.at(i)] = limit;
+        }
+    }
+    settings.endGroup();
+
+    m_taskDispatcher->setGlobalLimit(globalLimit);
+    m_taskDispatcher->setGroupLimits(groupLimits);
+
+    // 启动时补跑错过的执行，每两次之间至少间隔的秒数
+    int catchUpInterval =
+        settings.value("tasks/catchUpIntervalSeconds", 5).toInt();
+    m_taskScheduler->setCatchUpInterval(qMax(0, catchUpInterval) * 1000);
+
+    m_bulkExecutor->setMaxParallel(settings.value("bulk/maxParallel", 8).toInt());
+
+    emit logMessage(
+        QString::fromUtf8("后台线程：计划任务并发上限 全局 %1，已配置 %2 个并发组。")
+            .arg(globalLimit > 0 ? QString::number(globalLimit)
+                                 : QString::fromUtf8("不限"))
+            .arg(groupLimits.count()));
+}
+
+bool BackendWorker::checkPidFile(const ProcessInfo &info,
+                                 const QString &configPath)
+{
+    if (!info.pidFile.isEmpty())
+        return true;
+    emit logMessage(
+        QString::fromUtf8("[错误] 配置文件 %1 缺少'pidFile'字段，服务 %2 无法被管理，已忽略。")
+            .arg(configPath)
+            .arg(info.id));
+    return false;
+}
 
+ProcessInfo BackendWorker::parseProcessConfig(const QJsonObject &obj) const
+{
+    ProcessInfo p;
     p.id = obj["id"].toString();
     p.name = obj["name"].toString();
     p.type = obj["type"].toString();
     p.command = obj["command"].toString();
     p.workingDir = obj["workingDir"].toString();
     p.autoStart = obj["autoStart"].toBool(false);
+    p.group = obj["group"].toString().trimmed();
 
     if (obj.contains("args") && obj["args"].isArray())
     {
@@ -801,7 +2235,7 @@ void BackendWorker::onServiceAdded(const QString &newConfigPath)
         }
     }
 
-    // 同样需要处理相对路径
+    // 相对路径的PID文件统一放在程序目录下的pids目录中
     QString pidFileFromJson = obj["pidFile"].toString();
     if (!pidFileFromJson.isEmpty())
     {
@@ -823,10 +2257,111 @@ void BackendWorker::onServiceAdded(const QString &newConfigPath)
     {
         QJsonObject scheduleObj = obj["schedule"].toObject();
         p.schedule.type = scheduleObj["type"].toString();
+        p.schedule.expression = scheduleObj["expression"].toString();
         p.schedule.dayOfWeek = scheduleObj["dayOfWeek"].toInt(0);
         p.schedule.dayOfMonth = scheduleObj["dayOfMonth"].toInt(0);
         p.schedule.hour = scheduleObj["hour"].toInt(-1);
         p.schedule.minute = scheduleObj["minute"].toInt(-1);
+        p.schedule.concurrencyGroup =
+            scheduleObj["concurrencyGroup"].toString();
+        p.schedule.jitterSeconds =
+            qBound(0, scheduleObj["jitterSeconds"].toInt(0), 3600);
+        if (scheduleObj.contains("catchUp"))
+        {
+            p.schedule.catchUp = scheduleObj["catchUp"].toString();
+        }
+        p.schedule.catchUpLimit =
+            qBound(1, scheduleObj["catchUpLimit"].toInt(10), 1000);
+    }
+
+    if (obj.contains("stop") && obj["stop"].isObject())
+    {
+        QJsonObject stopObj = obj["stop"].toObject();
+        int stopSignal = parseSignal(stopObj["signal"]);
+        if (stopSignal > 0)
+        {
+            p.stopSignal = stopSignal;
+        }
+        p.stopTimeoutSec = qBound(1, stopObj["timeoutSeconds"].toInt(10), 3600);
+    }
+
+    if (obj["dependsOn"].isArray())
+    {
+        QJsonArray deps = obj["dependsOn"].toArray();
+        for (int i = 0; i < deps.size(); ++i)
+        {
+            p.dependsOn.append(deps.at(i).toString());
+        }
+    }
+
+    if (obj.contains("restart") && obj["restart"].isObject())
+    {
+        QJsonObject restartObj = obj["restart"].toObject();
+        ProcessInfo::RestartPolicy &policy = p.restart;
+        policy.initialDelayMs = qBound(
+            0, (int)(restartObj["initialDelaySeconds"].toDouble(1.0) * 1000),
+            3600 * 1000);
+        policy.maxDelayMs = qBound(
+            policy.initialDelayMs,
+            (int)(restartObj["maxDelaySeconds"].toDouble(300.0) * 1000),
+            24 * 3600 * 1000);
+        policy.multiplier =
+            qBound(1.0, restartObj["multiplier"].toDouble(2.0), 10.0);
+        policy.jitter = qBound(0.0, restartObj["jitter"].toDouble(0.2), 1.0);
+        policy.crashLoopCount =
+            qBound(0, restartObj["crashLoopCount"].toInt(5), 1000);
+        policy.crashLoopWindowSec =
+            qBound(1, restartObj["crashLoopWindowSeconds"].toInt(120), 86400);
+        policy.resetAfterSec =
+            qBound(1, restartObj["resetAfterSeconds"].toInt(300), 86400);
+    }
+
+    if (obj.contains("probe") && obj["probe"].isObject())
+    {
+        QJsonObject probeObj = obj["probe"].toObject();
+        QString probeType = probeObj["type"].toString();
+        if (probeType == "http" || probeType == "tcp" || probeType == "exec")
+        {
+            p.probe.type = probeType;
+        }
+        p.probe.url = probeObj["url"].toString();
+        p.probe.host = probeObj.contains("host") ? probeObj["host"].toString()
+                                                 : QString("127.0.0.1");
+        p.probe.port = qBound(0, probeObj["port"].toInt(0), 65535);
+        p.probe.command = probeObj["command"].toString();
+        QJsonArray probeArgs = probeObj["args"].toArray();
+        for (int i = 0; i < probeArgs.size(); ++i)
+        {
+            p.probe.args.append(probeArgs.at(i).toString());
+        }
+        p.probe.intervalSeconds =
+            qBound(1, probeObj["intervalSeconds"].toInt(10), 3600);
+        p.probe.timeoutMs = qBound(10, probeObj["timeoutMs"].toInt(2000), 60000);
+        p.probe.failureThreshold =
+            qBound(1, probeObj["failureThreshold"].toInt(3), 100);
+        p.probe.initialDelaySeconds =
+            qBound(0, probeObj["initialDelaySeconds"].toInt(15), 3600);
+    }
+
+    if (obj.contains("readiness") && obj["readiness"].isObject())
+    {
+        QJsonObject readinessObj = obj["readiness"].toObject();
+        p.readiness.port = qBound(0, readinessObj["port"].toInt(0), 65535);
+        p.readiness.timeoutSeconds =
+            qBound(1, readinessObj["timeoutSeconds"].toInt(120), 3600);
+    }
+
+    if (obj.contains("leakDetection") && obj["leakDetection"].isObject())
+    {
+        QJsonObject leakObj = obj["leakDetection"].toObject();
+        ProcessInfo::LeakDetection &leak = p.leakDetection;
+        leak.enabled = leakObj["enabled"].toBool(true);
+        leak.thresholdMB = qMax(0.0, leakObj["thresholdMB"].toDouble(0.0));
+        leak.windowMinutes = qBound(5, leakObj["windowMinutes"].toInt(60), 7 * 24 * 60);
+        leak.warnHours = qMax(0.0, leakObj["warnHours"].toDouble(24.0));
+        leak.restartWindow = leakObj["restartWindow"].toString();
+        leak.restartWithinHours =
+            qMax(0.0, leakObj["restartWithinHours"].toDouble(48.0));
     }
 
     if (obj.contains("healthCheck") && obj["healthCheck"].isObject())
@@ -835,8 +2370,89 @@ void BackendWorker::onServiceAdded(const QString &newConfigPath)
         p.healthCheckEnabled = healthCheckObj["enabled"].toBool(false);
         p.maxCpu = healthCheckObj["maxCpu"].toDouble(0.0);
         p.maxMem = healthCheckObj["maxMem"].toDouble(0.0);
+        p.cpuWindow = parseHealthWindow(healthCheckObj["cpu"]);
+        p.memWindow = parseHealthWindow(healthCheckObj["mem"]);
+    }
+
+    if (obj.contains("limits") && obj["limits"].isObject())
+    {
+        QJsonObject limitsObj = obj["limits"].toObject();
+        p.limits.addressSpaceMB =
+            (qint64)limitsObj["addressSpaceMB"].toDouble(0);
+        p.limits.openFiles = (qint64)limitsObj["openFiles"].toDouble(0);
+        p.limits.cpuMax = limitsObj["cpuMax"].toString();
+        p.limits.memoryMaxMB = (qint64)limitsObj["memoryMaxMB"].toDouble(0);
+        if (limitsObj["ioMax"].isArray())
+        {
+            QJsonArray ioArray = limitsObj["ioMax"].toArray();
+            for (int j = 0; j < ioArray.size(); ++j)
+            {
+                p.limits.ioMax.append(ioArray[j].toString());
+            }
+        }
+        else if (limitsObj["ioMax"].isString())
+        {
+            p.limits.ioMax.append(limitsObj["ioMax"].toString());
+        }
+    }
+
+    if (obj.contains("tuning") && obj["tuning"].isObject())
+    {
+        QJsonObject tuningObj = obj["tuning"].toObject();
+        p.tuning.cpuAffinity = tuningObj["cpuAffinity"].toString();
+        p.tuning.numaNode = tuningObj["numaNode"].toInt(-1);
+        if (tuningObj.contains("nice"))
+        {
+            p.tuning.niceSet = true;
+            p.tuning.nice = tuningObj["nice"].toInt(0);
+        }
+        p.tuning.ioClass = tuningObj["ioClass"].toString();
+        p.tuning.ioPriority = tuningObj["ioPriority"].toInt(4);
+        p.tuning.transparentHugePages =
+            tuningObj["transparentHugePages"].toString();
+        p.tuning.memlockMB = (qint64)tuningObj["memlockMB"].toDouble(-1);
+    }
+
+    return p;
+}
+
+void BackendWorker::onServiceAdded(const QString &newConfigPath)
+{
+    emit logMessage(QString::fromUtf8("后台线程：收到新服务添加请求: %1")
+                        .arg(newConfigPath));
+
+    QFile file(newConfigPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        emit logMessage(QString::fromUtf8("[错误] 无法读取新添加的配置文件: %1")
+                            .arg(newConfigPath));
+        return;
+    }
+
+    // --- 1. 读取并解析文件 ---
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    file.close();
+
+    if (parseError.error != QJsonParseError::NoError)
+    {
+        emit logMessage(
+            QString::fromUtf8("[错误] 解析新配置文件失败: %1, 错误: %2")
+                .arg(newConfigPath)
+                .arg(parseError.errorString()));
+        return;
+    }
+    if (!doc.isObject())
+    {
+        emit logMessage(
+            QString::fromUtf8("[错误] 新配置文件的根元素不是一个对象: %1")
+                .arg(newConfigPath));
+        return;
     }
 
+    // --- 2. 填充ProcessInfo结构体 ---
+    ProcessInfo p = parseProcessConfig(doc.object());
+
     // --- 3. 更新内部状态并通知UI ---
     if (p.id.isEmpty())
     {
@@ -844,12 +2460,19 @@ void BackendWorker::onServiceAdded(const QString &newConfigPath)
             QString::fromUtf8("[错误] 新配置文件缺少必须的'id'字段。"));
         return;
     }
+    if (!checkPidFile(p, newConfigPath))
+        return;
 
     // 将解析出的新服务信息添加到内存中的配置列表
-    m_processConfigs[p.id] = p;
+    registerService(p);
+    m_restartBackoff->setPolicy(p.id, p.restart);
+    if (p.type == "task")
+    {
+        m_taskScheduler->setTask(p.id, p.schedule);
+    }
 
     // 发射信号，通知ProcessModel去UI上插入新的一行
-    emit processInfoAdded(p);
+    emit processInfoAdded(snapshot(p.id));
 }
 
 void BackendWorker::onDeleteServiceRequested(const QString &id)
@@ -891,6 +2514,17 @@ void BackendWorker::onDeleteServiceRequested(const QString &id)
 
     // 3. 从内存中的配置列表里移除
     m_processConfigs.remove(id);
+    m_taskScheduler->removeTask(id);
+    m_runHistory.removeService(id);
+    m_taskDispatcher->cancel(id);
+    m_restartBackoff->removeService(id);
+    m_healthStates.remove(id);
+    m_healthProber->unwatch(id);
+    m_awaitingReady.remove(id);
+    m_waitingForDeps.removeAll(id);
+    m_leakStates.remove(id);
+    m_lifecycleTimings.remove(id);
+    m_runtime.release(id);
 
     // 4. 发射信号，通知UI（ProcessModel）进行刷新
     emit serviceDeleted(id);
@@ -900,10 +2534,8 @@ void BackendWorker::onEditServiceRequested(const QString &id)
 {
     if (m_processConfigs.contains(id))
     {
-        // 在内存中找到对应的配置信息
-        ProcessInfo info = m_processConfigs.value(id);
-        // 发射信号，将数据回传给主窗口
-        emit serviceInfoReadyForEdit(info);
+        // 在内存中找到对应的配置信息，连同当前运行状态回传给主窗口
+        emit serviceInfoReadyForEdit(snapshot(id));
     }
 }
 
@@ -932,69 +2564,35 @@ void BackendWorker::onServiceEdited(const QString &configPath)
     }
 
     // --- 2. 【补全的核心逻辑】填充ProcessInfo结构体 ---
-    QJsonObject obj = doc.object();
-    ProcessInfo p;
-
-    p.id = obj["id"].toString();
-    p.name = obj["name"].toString();
-    p.type = obj["type"].toString();
-    p.command = obj["command"].toString();
-    p.workingDir = obj["workingDir"].toString();
-    p.autoStart = obj["autoStart"].toBool(false);
-
-    if (obj.contains("args") && obj["args"].isArray())
-    {
-        QJsonArray argsArray = obj["args"].toArray();
-        for (int j = 0; j < argsArray.size(); ++j)
-        {
-            p.args.append(argsArray[j].toString());
-        }
-    }
-
-    QString pidFileFromJson = obj["pidFile"].toString();
-    if (!pidFileFromJson.isEmpty())
-    {
-        QFileInfo fileInfo(pidFileFromJson);
-        if (fileInfo.isRelative())
-        {
-            QString pidsPath = QCoreApplication::applicationDirPath() + "/pids";
-            QDir pidsDir(pidsPath);
-            p.pidFile = pidsDir.filePath(pidFileFromJson);
-        }
-        else
-        {
-            p.pidFile = pidFileFromJson;
-        }
-    }
+    ProcessInfo p = parseProcessConfig(doc.object());
 
-    if (p.type == "task" && obj.contains("schedule") && obj["schedule"].isObject())
+    // --- 3. 更新内部状态并通知UI ---
+    if (p.id.isEmpty())
     {
-        QJsonObject scheduleObj = obj["schedule"].toObject();
-        p.schedule.type = scheduleObj["type"].toString();
-        p.schedule.dayOfWeek = scheduleObj["dayOfWeek"].toInt(0);
-        p.schedule.dayOfMonth = scheduleObj["dayOfMonth"].toInt(0);
-        p.schedule.hour = scheduleObj["hour"].toInt(-1);
-        p.schedule.minute = scheduleObj["minute"].toInt(-1);
+        return;
     }
+    if (!checkPidFile(p, configPath))
+        return;
 
-    if (obj.contains("healthCheck") && obj["healthCheck"].isObject())
+    // 在内存中更新(覆盖)配置；修改配置后解除崩溃隔离
+    // 运行时状态保留在运行时表中，不随配置覆盖
+    registerService(p);
+    m_runtime.find(p.id)->restartCount = m_restartBackoff->restartCount(p.id);
+    m_restartBackoff->setPolicy(p.id, p.restart);
+    m_restartBackoff->release(p.id);
+    m_healthStates.remove(p.id);
+    m_healthProber->unwatch(p.id);
+    m_leakStates.remove(p.id);
+    if (p.type == "task")
     {
-        QJsonObject healthCheckObj = obj["healthCheck"].toObject();
-        p.healthCheckEnabled = healthCheckObj["enabled"].toBool(false);
-        p.maxCpu = healthCheckObj["maxCpu"].toDouble(0.0);
-        p.maxMem = healthCheckObj["maxMem"].toDouble(0.0);
+        m_taskScheduler->setTask(p.id, p.schedule);
     }
-
-    // --- 3. 更新内部状态并通知UI ---
-    if (p.id.isEmpty())
+    else
     {
-        return;
+        m_taskScheduler->removeTask(p.id);
     }
-
-    // 在内存中更新(覆盖)配置
-    m_processConfigs[p.id] = p;
     emit logMessage(QString::fromUtf8("后台线程：服务 %1 的内存配置已更新。").arg(p.id));
 
     // 发射信号，通知ProcessModel去UI上更新对应行的数据
-    emit serviceInfoUpdated(p);
+    emit serviceInfoUpdated(snapshot(p.id));
 }
\ No newline at end of file
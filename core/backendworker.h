@@ -2,13 +2,37 @@
 #define BACKENDWORKER_H
 
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QObject>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 
+#include "backenddiagnostics.h"
+#include "healthevaluator.h"
+#include "latencyhistogram.h"
+#include "leaktrend.h"
+#include "lifecycletimings.h"
+#include "listeningsockets.h"
 #include "processinfo.h"
+#include "procfs.h"
+#include "runhistory.h"
+#include "runtimetable.h"
+
+class BulkExecutor;
+class ChildReaper;
+class FederationServer;
+class HealthProber;
+class RestartBackoff;
+class ShutdownQueue;
+class QJsonObject;
+class QSettings;
+class QTimer;
+class TaskDispatcher;
+class TaskScheduler;
 
 class BackendWorker : public QObject {
     Q_OBJECT
@@ -17,16 +41,20 @@ public:
     explicit BackendWorker(QObject *parent = 0);
     ~BackendWorker();
 
+    // /proc 的根目录，空串为真实的 /proc；须在监控开始前、于后台线程内设置。
+    // simulated 为true时根目录是模拟的目录树，不启动、不停止任何真实进程；
+    // 根目录为 /proc 时忽略 simulated 并返回false
+    bool setProcRoot(const QString &root, bool simulated = false);
+
 signals:
     // --- UI通信信号 ---
     void logMessage(const QString &message);
     void processListLoaded(const QList<ProcessInfo> &processes);
-    void processStatusChanged(const QString &id, const QString &status,
+    void processStatusChanged(const QString &id, ProcessState::State state,
                               qint64 pid, double cpu, double mem);
     void systemMetricsUpdated(double cpuPercent, double memPercent);
-
-    // --- 内部逻辑信号，用于延迟重启 ---
-    void delayedStartSignal();
+    // 后台自身的耗时分布与队列深度，每个监控周期结束时发出
+    void diagnosticsUpdated(const BackendDiagnostics &diagnostics);
 
     void processInfoAdded(const ProcessInfo &info);
 
@@ -36,12 +64,36 @@ signals:
 
     void serviceInfoUpdated(const ProcessInfo &info);
 
+    void runHistoryReady(const QString &name, const QList<RunRecord> &runs);
+
+    // stopAllProcesses 发起的全部停止已完成
+    void allProcessesStopped();
+
+    // 自动重启次数变化
+    void restartCountChanged(const QString &id, int count);
+
+    // 服务完成一次启动(就绪)或停止后，最近若干次的启动/停止耗时(ms)
+    void lifecycleTimingsChanged(const QString &id, const LatencySummary &start,
+                                 const LatencySummary &stop);
+
+    // 批量操作进度与结果
+    void bulkProgress(const QString &action, const QString &label, int done,
+                      int failed, int running, int total);
+    void bulkFinished(const QString &action, const QString &label,
+                      int succeeded, const QStringList &failures);
+
 public slots:
     // --- 由主线程调用的核心槽函数 ---
     void performInitialSetup();
     void startProcess(const QString &id);
     void stopProcess(const QString &id);
     void restartProcess(const QString &id);
+    // 并发停止所有服务；定义了依赖关系时，依赖方先于被依赖方停止
+    void stopAllProcesses();
+    // 批量启动/停止/重启/删除，并发数受 manager.ini 中 bulk/maxParallel 限制
+    void runBulkOperation(const QString &action, const QStringList &ids);
+    // 对分组内的全部服务执行 "start"/"stop"/"restart"，并发上限同批量操作
+    void runGroupOperation(const QString &action, const QString &group);
 
     void onServiceAdded(const QString &newConfigPath);
 
@@ -51,41 +103,157 @@ public slots:
 
     void onServiceEdited(const QString &configPath);
 
+    void onRunHistoryRequested(const QString &id);
+
+    // 清空自检直方图，重新开始统计
+    void resetDiagnostics();
+
 private slots:
     // --- 定时器触发的槽函数 ---
     void onMonitorTimeout();
-    void onSchedulerTick();
+    void onTaskDue(const QString &id, const QDateTime &scheduledTime);
+    void onCatchUpDue(const QString &id, const QDateTime &scheduledTime);
+    void onTaskReady(const QString &id, qint64 waitMs);
+
+    // --- 子进程回收 ---
+    void onChildExited(qint64 pid, int exitCode, int signalNumber,
+                       qint64 cpuTimeMs, qint64 maxRssKB);
 
     // --- 优雅关闭和延迟重启的辅助槽函数 ---
-    void onGracefulShutdownTimeout();
-    void onDelayedStart();
+    void onShutdownDeadline(const QString &id, const ProcessIdentity &identity,
+                            int timeoutMs);
+    void advanceStopAll();
+    void onRestartDue(const QString &id);
+    void onProbeFailed(const QString &id, int failures, const QString &reason);
+    void onReadinessPoll();
+
+    // --- 批量操作 ---
+    void onBulkExecuteItem(const QString &action, const QString &id);
+    void onOwnStatusChanged(const QString &id, ProcessState::State state);
 
 private:
     // --- 核心数据和定时器 ---
+    // 静态配置；其中的运行时字段不维护，发给界面前由 snapshot() 从运行时表填入
     QMap<QString, ProcessInfo> m_processConfigs;
+    RuntimeTable m_runtime;  // PID、状态、指标等每个周期都会更新的数据
     QTimer *m_monitorTimer;
-    QTimer *m_schedulerTimer;
-    QDateTime m_lastSchedulerCheckTime;
+    TaskScheduler *m_taskScheduler;
+    TaskDispatcher *m_taskDispatcher;
+
+    // --- 运行历史 ---
+    ChildReaper *m_childReaper;
+    RunHistory m_runHistory;
+    QHash<qint64, RunRecord> m_activeRuns;  // PID -> 进行中的运行
+
+    ProcFs m_procFs;  // 所有 /proc 读取、存活检查与信号都经过这里
+
+    // --- 自检 ---
+    LatencyHistogram m_monitorTickLatency;  // 微秒
+    LatencyHistogram m_syscallsPerTick;
+
+    // --- 生命周期耗时 ---
+    QHash<QString, LifecycleTimings> m_lifecycleTimings;  // 跨重启保留，删除服务时清除
+    LatencyHistogram m_startToReady;  // 毫秒，所有服务合计
+    LatencyHistogram m_stopToExit;
+    LatencyHistogram m_recoveryTime;
 
     // --- CPU计算辅助成员 ---
     unsigned long long m_prevSystemWorkTime;
     unsigned long long m_prevSystemTotalTime;
-    QMap<QString, unsigned long long> m_prevProcessTime;
 
     QStringList m_restartQueue;
+    RestartBackoff *m_restartBackoff;
+    QString m_autoRestartId;  // 正在由 onRestartDue 启动的服务
+    qint64 m_dispatchWaitMs;  // 正在由 onTaskReady 启动的任务的排队等待时间
 
     // --- 健康检查辅助成员 ---
-    QMap<QString, int> m_breachCounters;
+    struct HealthState {
+        qint64 pid;  // 进程重启后窗口重新开始
+        HealthEvaluator cpu;
+        HealthEvaluator mem;
+    };
+    QHash<QString, HealthState> m_healthStates;
+    QElapsedTimer m_monotonic;
+    HealthProber *m_healthProber;
+
+    // --- 就绪检测与依赖启动 ---
+    ListeningSockets m_listeningSockets;
+    QHash<QString, qint64> m_awaitingReady;  // 服务ID -> 启动时刻(单调时钟)
+    QTimer *m_readinessTimer;
+    QStringList m_waitingForDeps;  // 等待依赖就绪后再启动的服务
+
+    // --- 内存泄漏趋势 ---
+    struct LeakState {
+        qint64 pid;
+        LeakTrend trend;
+        bool warned;
+        bool gaveUp;          // 空闲时段之前就会超限，留给健康检查处理
+        QDateTime restartAt;  // 已安排的预测性重启(空闲时段开始时刻)
+    };
+    QHash<QString, LeakState> m_leakStates;
+
+    BulkExecutor *m_bulkExecutor;
+
+    // --- 联合视图 ---
+    FederationServer *m_federation;  // 未配置 federation/listen 时为0
 
     // --- 优雅关闭辅助成员 ---
-    QMap<qint64, QString> m_shutdownPidToIdMap;
+    ShutdownQueue *m_shutdownQueue;
 
-    // --- 延迟重启辅助成员 ---
-    QString m_lastToStartForRestart;
+    // --- 全部停止 ---
+    bool m_stopAllActive;
+    QSet<QString> m_stopAllPending;   // 等待依赖方先退出的服务
+    QSet<QString> m_stopAllStopping;  // 已发出停止信号、尚未退出的服务
+    QHash<QString, QStringList> m_dependents;  // 服务ID -> 依赖它的服务
+    QTimer *m_stopAllAdvanceTimer;  // 合并同一轮事件中的多次推进
 
     // --- 私有辅助函数 ---
-    QDateTime calculateNextDueTime(const ProcessInfo::Schedule &schedule,
-                                   const QDateTime &after);
+    // 加入或覆盖服务配置，并为其分配运行时表句柄(已有的保持不变)
+    void registerService(const ProcessInfo &info);
+    // 配置加上当前运行时数据，用于发给界面
+    ProcessInfo snapshot(const QString &id) const;
+    ProcessState::State stateOf(const QString &id) const;
+    // 按转换表切换状态并执行退出/进入钩子；非法转换记录日志并拒绝，返回false。
+    // 不发射 processStatusChanged，由调用方连同PID和指标一起发射
+    bool setState(const QString &id, ProcessState::State to);
+    // dwellMs 为离开的状态持续的时长
+    void onStateExited(const QString &id, ProcessState::State from,
+                       qint64 dwellMs);
+    void onStateEntered(const QString &id, ProcessState::State to,
+                        ProcessState::State from);
+    // 将JSON配置对象解析为ProcessInfo(初始加载/新增/编辑共用)
+    ProcessInfo parseProcessConfig(const QJsonObject &obj) const;
+    // 没有PID文件的服务无法被监控和停止；不合格时记录错误并返回false
+    bool checkPidFile(const ProcessInfo &info, const QString &configPath);
+    // 启动失败后离开 Starting：手动启动进入 Error，自动重启计入退避
+    void launchFailed(const QString &id);
+    // 从 manager.ini 读取计划任务的全局/分组并发上限
+    void loadDispatchSettings();
+    // 读取PID文件并核对进程身份；进程已退出或PID已被复用时返回0
+    qint64 livePid(const QString &id) const;
+    // 管理器启动时接管PID文件指向的、身份核对通过的进程，清理其余PID文件
+    void reattachServices();
+    // 检查等待就绪的服务；就绪(或超时)时切换到 Running 并返回true
+    bool checkReadiness(const QString &id, qint64 pid);
+    void onServiceReady(const QString &id);
+    // 依赖的服务失败或被隔离：等待它的服务不会再启动，转为 Error
+    void failWaitingDependents(const QString &id, ProcessState::State state);
+    QStringList unreadyDependencies(const QString &id) const;
+    // 从 id 出发沿依赖查找环，返回环上的服务(首尾相同)；无环时返回空列表
+    QStringList dependencyCycle(const QString &id) const;
+    void finishIfNotStarting(const QString &id);
+    // 停止全部期间由收割者得知停止中的服务已退出：不等监控周期，直接进入 Stopped
+    void finishStopped(const QString &id, qint64 pid);
+    void evaluateLeakTrend(const ProcessInfo &config, qint64 pid, double memMB);
+    // 记入服务自己的样本和全体服务的直方图；启动/停止完成时通知界面
+    void recordLifecycle(const QString &id, LifecycleTimings::Phase phase,
+                         qint64 ms);
+    // 本线程累计的 read/write 类系统调用数(/proc/thread-self/io)，
+    // 读的总是真实的 /proc；不可用时返回0
+    static quint64 threadSyscalls();
+    void publishDiagnostics();
+    // 按 manager.ini 的 federation/listen 开始向远程界面推送状态
+    void startFederation(const QSettings &settings);
 };
 
 #endif  // BACKENDWORKER_H
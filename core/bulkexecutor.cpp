@@ -0,0 +1,191 @@
+#include "bulkexecutor.h"
+
+#include <QTimer>
+
+namespace
+{
+
+// 单个服务的操作超过该时长仍无结果即按失败处理，避免整批卡住
+const qint64 kItemTimeoutMs = 10 * 60 * 1000;
+
+}  // namespace
+
+BulkExecutor::BulkExecutor(QObject *parent) : QObject(parent)
+{
+    m_maxParallel = 8;
+    m_dispatching = false;
+
+    m_tickTimer = new QTimer(this);
+    m_tickTimer->setInterval(1000);
+    connect(m_tickTimer, SIGNAL(timeout()), this, SLOT(onTick()));
+
+    m_clock.start();
+}
+
+void BulkExecutor::setMaxParallel(int maxParallel)
+{
+    m_maxParallel = qMax(1, maxParallel);
+}
+
+void BulkExecutor::submit(const QString &action, const QStringList &ids,
+                          const QString &label)
+{
+    Batch batch;
+    batch.action = action;
+    batch.label = label;
+    for (int i = 0; i < ids.count(); ++i)
+    {
+        if (!batch.pending.contains(ids.at(i)))
+        {
+            batch.pending.append(ids.at(i));
+        }
+    }
+    batch.total = batch.pending.count();
+    batch.succeeded = 0;
+    if (batch.total == 0)
+        return;
+
+    m_batches.append(batch);
+    if (!m_tickTimer->isActive())
+    {
+        m_tickTimer->start();
+    }
+    dispatch();
+}
+
+void BulkExecutor::statusChanged(const QString &id, ProcessState::State state)
+{
+    QHash<QString, Item>::iterator it = m_inFlight.find(id);
+    if (it == m_inFlight.end() || m_batches.isEmpty())
+        return;
+
+    const QString &action = m_batches.first().action;
+    if (action == "stop")
+    {
+        if (ProcessState::isIdle(state))
+        {
+            finish(id, true, QString());
+        }
+        return;
+    }
+
+    if (action == "start" || action == "restart")
+    {
+        if (state == ProcessState::Starting)
+        {
+            it->sawStarting = true;
+        }
+        else if (state == ProcessState::Running && it->sawStarting)
+        {
+            finish(id, true, QString());
+        }
+        else if (state == ProcessState::Error ||
+                 state == ProcessState::Quarantined)
+        {
+            finish(id, false, QString::fromUtf8("启动失败"));
+        }
+        else if (state == ProcessState::Stopped && it->sawStarting)
+        {
+            finish(id, false, QString::fromUtf8("启动后立即退出"));
+        }
+    }
+}
+
+void BulkExecutor::itemFinished(const QString &id, bool success,
+                                const QString &reason)
+{
+    if (m_inFlight.contains(id))
+    {
+        finish(id, success, reason);
+    }
+}
+
+void BulkExecutor::dispatch()
+{
+    // executeItem 的接收方可能同步报告结果，由最外层的这次调用继续派发
+    if (m_dispatching)
+        return;
+    m_dispatching = true;
+
+    while (!m_batches.isEmpty())
+    {
+        Batch &batch = m_batches.first();
+        while (!batch.pending.isEmpty() && m_inFlight.count() < m_maxParallel)
+        {
+            QString id = batch.pending.takeFirst();
+            Item item;
+            item.startedMs = m_clock.elapsed();
+            item.sawStarting = false;
+            m_inFlight.insert(id, item);
+            emit executeItem(batch.action, id);
+        }
+
+        if (!batch.pending.isEmpty() || !m_inFlight.isEmpty())
+            break;
+
+        // 当前批次全部完成
+        Batch done = m_batches.takeFirst();
+        emit progress(done.action, done.label, done.total,
+                      done.failures.count(), 0, done.total);
+        emit batchFinished(done.action, done.label, done.succeeded,
+                           done.failures);
+    }
+
+    m_dispatching = false;
+
+    if (m_batches.isEmpty())
+    {
+        m_tickTimer->stop();
+    }
+}
+
+void BulkExecutor::onTick()
+{
+    qint64 now = m_clock.elapsed();
+    QStringList expired;
+    for (QHash<QString, Item>::const_iterator it = m_inFlight.constBegin();
+         it != m_inFlight.constEnd(); ++it)
+    {
+        if (now - it->startedMs >= kItemTimeoutMs)
+        {
+            expired.append(it.key());
+        }
+    }
+    for (int i = 0; i < expired.count(); ++i)
+    {
+        finish(expired.at(i), false, QString::fromUtf8("超时"));
+    }
+
+    reportProgress();
+}
+
+void BulkExecutor::finish(const QString &id, bool success,
+                          const QString &reason)
+{
+    if (m_inFlight.remove(id) == 0 || m_batches.isEmpty())
+        return;
+
+    Batch &batch = m_batches.first();
+    if (success)
+    {
+        ++batch.succeeded;
+    }
+    else
+    {
+        batch.failures.append(QString("%1: %2").arg(id).arg(reason));
+    }
+
+    dispatch();
+    reportProgress();
+}
+
+void BulkExecutor::reportProgress()
+{
+    if (m_batches.isEmpty())
+        return;
+
+    const Batch &batch = m_batches.first();
+    int done = batch.succeeded + batch.failures.count();
+    emit progress(batch.action, batch.label, done, batch.failures.count(),
+                  m_inFlight.count(), batch.total);
+}
@@ -0,0 +1,83 @@
+#ifndef BULKEXECUTOR_H
+#define BULKEXECUTOR_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include "processstate.h"
+
+class QTimer;
+
+// 批量操作执行器：对一批服务执行同一操作("start"/"stop"/"restart"/"delete")，
+// 同时进行的数量不超过 maxParallel。
+// 单个服务的操作由接收 executeItem 信号的一方执行，完成与否根据随后的状态变化判定：
+// 启动/重启要等到服务真正进入 Running，停止要等到进程退出。
+// 批次按提交顺序依次执行，前一批结束后才开始下一批。
+class BulkExecutor : public QObject {
+    Q_OBJECT
+
+public:
+    explicit BulkExecutor(QObject *parent = 0);
+
+    void setMaxParallel(int maxParallel);
+    int maxParallel() const { return m_maxParallel; }
+
+    // label 是分组操作传入的分组名，随进度和结果信号带出；普通批量操作为空
+    void submit(const QString &action, const QStringList &ids,
+                const QString &label = QString());
+
+    // 由调用方转发服务状态变化
+    void statusChanged(const QString &id, ProcessState::State state);
+
+    // 不需要等待状态变化的结果(已在运行、删除等)由调用方直接报告
+    void itemFinished(const QString &id, bool success,
+                      const QString &reason = QString());
+
+    bool isBusy() const { return !m_batches.isEmpty(); }
+
+signals:
+    // 应立即对该服务执行 action；可以在处理中同步调用 itemFinished
+    void executeItem(const QString &action, const QString &id);
+
+    void progress(const QString &action, const QString &label, int done,
+                  int failed, int running, int total);
+    // failures 的每一项为 "服务ID: 原因"
+    void batchFinished(const QString &action, const QString &label,
+                       int succeeded, const QStringList &failures);
+
+private slots:
+    void dispatch();
+    void onTick();
+
+private:
+    struct Item {
+        qint64 startedMs;
+        bool sawStarting;  // 启动/重启：已经看到 Starting
+    };
+
+    struct Batch {
+        QString action;
+        QString label;
+        QStringList pending;
+        int total;
+        int succeeded;
+        QStringList failures;
+    };
+
+    void finish(const QString &id, bool success, const QString &reason);
+    void reportProgress();
+
+    QList<Batch> m_batches;          // 第一个为正在执行的批次
+    QHash<QString, Item> m_inFlight;
+    int m_maxParallel;
+    bool m_dispatching;
+
+    QTimer *m_tickTimer;  // 进度刷新与超时检查
+    QElapsedTimer m_clock;
+};
+
+#endif  // BULKEXECUTOR_H
@@ -0,0 +1,248 @@
+#include "childreaper.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <QDir>
+#include <QFile>
+#include <QList>
+#include <QSocketNotifier>
+#include <QStringList>
+
+#ifndef PR_SET_CHILD_SUBREAPER
+#define PR_SET_CHILD_SUBREAPER 36
+#endif
+
+namespace
+{
+
+int g_signalPipe[2] = {-1, -1};
+
+// 信号处理函数中只能做异步信号安全的操作
+void onSigChld(int)
+{
+    int savedErrno = errno;
+    char byte = 1;
+    // 管道是非阻塞的，写满时丢弃即可：只要有一个字节未读，回收就会发生
+    ssize_t ignored = ::write(g_signalPipe[1], &byte, 1);
+    (void)ignored;
+    errno = savedErrno;
+}
+
+qint64 timevalToMs(const struct timeval &tv)
+{
+    return (qint64)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+}  // namespace
+
+ChildReaper::ChildReaper(QObject *parent) : QObject(parent)
+{
+    m_notifier = 0;
+    m_session = ::getsid(0);
+}
+
+ChildReaper::~ChildReaper()
+{
+    // 信号处理函数与管道属于整个进程，随进程结束一起释放
+}
+
+bool ChildReaper::install(QString *errorMessage)
+{
+    if (m_notifier)
+        return true;
+
+    if (g_signalPipe[0] >= 0)
+    {
+        *errorMessage = QString::fromUtf8("SIGCHLD处理函数已被安装");
+        return false;
+    }
+
+    if (::pipe2(g_signalPipe, O_CLOEXEC | O_NONBLOCK) != 0)
+    {
+        *errorMessage =
+            QString::fromUtf8("创建信号管道失败: %1").arg(strerror(errno));
+        return false;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSigChld;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    if (::sigaction(SIGCHLD, &action, 0) != 0)
+    {
+        *errorMessage = QString::fromUtf8("安装SIGCHLD处理函数失败: %1")
+                            .arg(strerror(errno));
+        return false;
+    }
+
+    if (::prctl(PR_SET_CHILD_SUBREAPER, 1, 0, 0, 0) != 0)
+    {
+        *errorMessage = QString::fromUtf8("设置子进程收割者失败: %1")
+                            .arg(strerror(errno));
+        return false;
+    }
+
+    m_notifier =
+        new QSocketNotifier(g_signalPipe[0], QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), this,
+            SLOT(onSignalPipeReadable()));
+
+    // 安装之前就已退出的子进程不会再有SIGCHLD，先回收一次
+    reapAll();
+    return true;
+}
+
+void ChildReaper::onSignalPipeReadable()
+{
+    char buf[64];
+    while (::read(g_signalPipe[0], buf, sizeof(buf)) > 0)
+    {
+    }
+    reapAll();
+}
+
+void ChildReaper::watch(qint64 pid)
+{
+    if (pid > 0)
+        m_watched.insert(pid);
+}
+
+// 先逐个回收登记过的进程，再回收服务自己派生、被挂到管理器下的孤儿进程。
+// 孤儿进程从 /proc/self/task/*/children 逐个列出并按PID回收，
+// 不归本类管理的子进程只是跳过，不会挡住排在它后面的孤儿。
+void ChildReaper::reapAll()
+{
+    QList<qint64> watched = m_watched.toList();
+    for (int i = 0; i < watched.count(); ++i)
+    {
+        reap(watched.at(i));
+    }
+
+    QList<qint64> children;
+    if (!listChildren(&children))
+    {
+        reapOrphansByPeek();
+        return;
+    }
+    for (int i = 0; i < children.count(); ++i)
+    {
+        qint64 pid = children.at(i);
+        if (!m_watched.contains(pid) && isAdoptedOrphan(pid))
+            reap(pid);
+    }
+}
+
+// 子进程挂在创建它的线程名下，被收养的孤儿可能挂在任意线程名下，所以要列出全部线程。
+// 内核未开启 CONFIG_PROC_CHILDREN 时没有这些文件，返回false
+bool ChildReaper::listChildren(QList<qint64> *children) const
+{
+    QStringList tasks = QDir("/proc/self/task").entryList(QDir::Dirs |
+                                                          QDir::NoDotAndDotDot);
+    if (tasks.isEmpty())
+        return false;
+
+    for (int i = 0; i < tasks.count(); ++i)
+    {
+        QFile file(QString("/proc/self/task/%1/children").arg(tasks.at(i)));
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            // 线程刚好退出时文件消失，跳过即可；第一个都打不开说明内核不支持
+            if (i == 0)
+                return false;
+            continue;
+        }
+        QList<QByteArray> pids = file.readAll().split(' ');
+        for (int j = 0; j < pids.count(); ++j)
+        {
+            qint64 pid = pids.at(j).trimmed().toLongLong();
+            if (pid > 0)
+                children->append(pid);
+        }
+    }
+    return true;
+}
+
+// 退路：用 WNOWAIT 查看任意一个已退出的子进程而不回收。
+// 遇到不归本类管理的子进程只能停止，留给它的所有者等待；
+// 排在它后面的孤儿要等所有者回收之后、下一次 SIGCHLD 时再处理
+void ChildReaper::reapOrphansByPeek()
+{
+    for (;;)
+    {
+        siginfo_t info;
+        memset(&info, 0, sizeof(info));
+        if (::waitid(P_ALL, 0, &info, WEXITED | WNOHANG | WNOWAIT) != 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;  // ECHILD: 没有子进程了
+        }
+        if (info.si_pid == 0)
+            break;  // 还有子进程，但都未退出
+        if (!m_watched.contains(info.si_pid) && !isAdoptedOrphan(info.si_pid))
+            break;
+        if (!reap(info.si_pid))
+            break;
+    }
+}
+
+// 脱离启动的服务都调用过 setsid，它们及其后代与管理器不在同一会话；
+// 僵尸进程在被回收之前仍可查询会话号
+bool ChildReaper::isAdoptedOrphan(qint64 pid) const
+{
+    pid_t session = ::getsid((pid_t)pid);
+    return session >= 0 && (qint64)session != m_session;
+}
+
+// glibc 的 waitid 不返回资源用量，这里直接使用带 rusage 参数的系统调用。
+// 进程已被回收时返回true
+bool ChildReaper::reap(qint64 pid)
+{
+    for (;;)
+    {
+        siginfo_t info;
+        struct rusage usage;
+        memset(&info, 0, sizeof(info));
+        memset(&usage, 0, sizeof(usage));
+
+        long ret = ::syscall(SYS_waitid, P_PID, (pid_t)pid, &info,
+                             WEXITED | WNOHANG, &usage);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            // ECHILD: 不是(或已不是)本进程的子进程
+            m_watched.remove(pid);
+            return false;
+        }
+        if (info.si_pid == 0)
+            return false;  // 尚未退出
+        m_watched.remove(pid);
+
+        int exitCode = -1;
+        int signalNumber = 0;
+        if (info.si_code == CLD_EXITED)
+        {
+            exitCode = info.si_status;
+        }
+        else
+        {
+            signalNumber = info.si_status;
+        }
+
+        emit childExited(info.si_pid, exitCode, signalNumber,
+                         timevalToMs(usage.ru_utime) +
+                             timevalToMs(usage.ru_stime),
+                         usage.ru_maxrss);
+        return true;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef CHILDREAPER_H
+#define CHILDREAPER_H
+
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+class QSocketNotifier;
+
+// 将管理器设为子进程收割者(PR_SET_CHILD_SUBREAPER)并回收退出的子进程。
+// 脱离启动(double fork)的服务进程在中间进程退出后会被重新挂到管理器下，
+// 因此管理器能够通过 waitid 拿到它们的退出状态和资源用量。
+// SIGCHLD 处理函数只向自管道写一个字节，实际的回收在所属线程的事件循环中完成。
+// 只回收登记过的PID和被挂过来的孤儿进程(与管理器不在同一会话)；
+// 管理器自己直接创建、由别处等待的子进程(如 QProcess)不会被抢先回收。
+class ChildReaper : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ChildReaper(QObject *parent = 0);
+    ~ChildReaper();
+
+    // 每个进程只能安装一次；失败时返回false并给出原因
+    bool install(QString *errorMessage);
+    bool isInstalled() const { return m_notifier != 0; }
+
+public slots:
+    // 登记由管理器启动、需要回收的进程；进程被回收后自动注销
+    void watch(qint64 pid);
+
+signals:
+    // exitCode 在被信号终止时为-1，此时 signalNumber 为终止信号
+    void childExited(qint64 pid, int exitCode, int signalNumber,
+                     qint64 cpuTimeMs, qint64 maxRssKB);
+
+private slots:
+    void onSignalPipeReadable();
+
+private:
+    void reapAll();
+    bool listChildren(QList<qint64> *children) const;
+    void reapOrphansByPeek();
+    bool reap(qint64 pid);
+    bool isAdoptedOrphan(qint64 pid) const;
+
+    QSocketNotifier *m_notifier;
+    QSet<qint64> m_watched;
+    qint64 m_session;  // 管理器所在的会话
+};
+
+#endif  // CHILDREAPER_H
@@ -0,0 +1,54 @@
+# 后台核心代码(不依赖界面)，主程序和基准测试共用
+
+INCLUDEPATH += $$PWD
+
+SOURCES += $$PWD/backendworker.cpp \
+           $$PWD/processlauncher.cpp \
+           $$PWD/taskscheduler.cpp \
+           $$PWD/cronexpression.cpp \
+           $$PWD/taskdispatcher.cpp \
+           $$PWD/childreaper.cpp \
+           $$PWD/runhistory.cpp \
+           $$PWD/shutdownqueue.cpp \
+           $$PWD/restartbackoff.cpp \
+           $$PWD/healthevaluator.cpp \
+           $$PWD/healthprober.cpp \
+           $$PWD/listeningsockets.cpp \
+           $$PWD/leaktrend.cpp \
+           $$PWD/processstate.cpp \
+           $$PWD/runtimetable.cpp \
+           $$PWD/bulkexecutor.cpp \
+           $$PWD/procfs.cpp \
+           $$PWD/pidfile.cpp \
+           $$PWD/latencyhistogram.cpp \
+           $$PWD/backenddiagnostics.cpp \
+           $$PWD/tracer.cpp \
+           $$PWD/lifecycletimings.cpp \
+           $$PWD/federationprotocol.cpp \
+           $$PWD/federationserver.cpp
+
+HEADERS += $$PWD/backendworker.h \
+           $$PWD/processinfo.h \
+           $$PWD/processlauncher.h \
+           $$PWD/taskscheduler.h \
+           $$PWD/cronexpression.h \
+           $$PWD/taskdispatcher.h \
+           $$PWD/childreaper.h \
+           $$PWD/runhistory.h \
+           $$PWD/shutdownqueue.h \
+           $$PWD/restartbackoff.h \
+           $$PWD/healthevaluator.h \
+           $$PWD/healthprober.h \
+           $$PWD/listeningsockets.h \
+           $$PWD/leaktrend.h \
+           $$PWD/processstate.h \
+           $$PWD/runtimetable.h \
+           $$PWD/bulkexecutor.h \
+           $$PWD/procfs.h \
+           $$PWD/pidfile.h \
+           $$PWD/latencyhistogram.h \
+           $$PWD/backenddiagnostics.h \
+           $$PWD/tracer.h \
+           $$PWD/lifecycletimings.h \
+           $$PWD/federationprotocol.h \
+           $$PWD/federationserver.h
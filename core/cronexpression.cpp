@@ -0,0 +1,409 @@
+#include "cronexpression.h"
+
+#include <QRegExp>
+#include <QStringList>
+
+namespace
+{
+
+// 只有 2月29日 这类表达式会长时间不触发(最长8年，如2096→2104)
+const int kMaxSearchYears = 9;
+
+const char *const kMonthNames[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+                                   "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
+const char *const kWeekdayNames[] = {"SUN", "MON", "TUE", "WED",
+                                     "THU", "FRI", "SAT"};
+
+// 返回 bits 中不小于 from 的最低置位，没有则返回-1
+int nextBit(quint64 bits, int from)
+{
+    if (from > 63)
+        return -1;
+    quint64 masked = bits & (~(quint64)0 << from);
+    if (masked == 0)
+        return -1;
+    return __builtin_ctzll(masked);
+}
+
+quint64 rangeBits(int low, int high)
+{
+    quint64 bits = 0;
+    for (int i = low; i <= high; ++i)
+        bits |= (quint64)1 << i;
+    return bits;
+}
+
+bool parseValue(const QString &text, int nameBase, const char *const *names,
+                int nameCount, int *value)
+{
+    bool ok = false;
+    *value = text.toInt(&ok);
+    if (ok)
+        return true;
+
+    for (int i = 0; i < nameCount; ++i)
+    {
+        if (text.compare(QLatin1String(names[i]), Qt::CaseInsensitive) == 0)
+        {
+            *value = nameBase + i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 解析单个字段(逗号分隔的列表，每项为 * / a / a-b，可带 /step)
+bool parseField(const QString &field, int min, int max, int nameBase,
+                const char *const *names, int nameCount, quint64 *bits,
+                bool *isWildcard, QString *errorMessage)
+{
+    *bits = 0;
+    *isWildcard = field.startsWith('*');
+
+    QStringList items = field.split(',');
+    for (int i = 0; i < items.size(); ++i)
+    {
+        const QString &item = items.at(i);
+        QString rangePart = item;
+        int step = 1;
+
+        int slash = item.indexOf('/');
+        if (slash >= 0)
+        {
+            bool ok = false;
+            step = item.mid(slash + 1).toInt(&ok);
+            if (!ok || step <= 0)
+            {
+                *errorMessage =
+                    QString::fromUtf8("步长 '%1' 无效").arg(item);
+                return false;
+            }
+            rangePart = item.left(slash);
+        }
+
+        int low = min;
+        int high = max;
+        if (rangePart != "*")
+        {
+            int dash = rangePart.indexOf('-');
+            QString lowText = dash >= 0 ? rangePart.left(dash) : rangePart;
+            if (!parseValue(lowText, nameBase, names, nameCount, &low))
+            {
+                *errorMessage =
+                    QString::fromUtf8("无法识别的取值 '%1'").arg(item);
+                return false;
+            }
+
+            if (dash >= 0)
+            {
+                if (!parseValue(rangePart.mid(dash + 1), nameBase, names,
+                                nameCount, &high))
+                {
+                    *errorMessage =
+                        QString::fromUtf8("无法识别的取值 '%1'").arg(item);
+                    return false;
+                }
+            }
+            else if (slash < 0)
+            {
+                high = low;
+            }
+            // "a/n" 按惯例表示从a开始到字段最大值，每n个取一个
+        }
+
+        if (low < min || high > max || low > high)
+        {
+            *errorMessage = QString::fromUtf8("'%1' 超出范围 %2-%3")
+                                .arg(item)
+                                .arg(min)
+                                .arg(max);
+            return false;
+        }
+
+        for (int v = low; v <= high; v += step)
+            *bits |= (quint64)1 << v;
+    }
+
+    return true;
+}
+
+}  // namespace
+
+CronExpression::CronExpression()
+{
+    m_minutes = 0;
+    m_hours = 0;
+    m_days = 0;
+    m_months = 0;
+    m_weekdays = 0;
+    m_dayRestricted = false;
+    m_weekdayRestricted = false;
+    m_valid = false;
+}
+
+CronExpression CronExpression::parse(const QString &text,
+                                     QString *errorMessage)
+{
+    QString dummy;
+    if (!errorMessage)
+        errorMessage = &dummy;
+
+    QString expr = text.trimmed();
+    if (expr.startsWith('@'))
+    {
+        QString macro = expr.toLower();
+        if (macro == "@hourly")
+            expr = "0 * * * *";
+        else if (macro == "@daily" || macro == "@midnight")
+            expr = "0 0 * * *";
+        else if (macro == "@weekly")
+            expr = "0 0 * * 0";
+        else if (macro == "@monthly")
+            expr = "0 0 1 * *";
+        else if (macro == "@yearly" || macro == "@annually")
+            expr = "0 0 1 1 *";
+        else
+        {
+            *errorMessage = QString::fromUtf8("不支持的宏 '%1'").arg(expr);
+            return CronExpression();
+        }
+    }
+
+    QStringList fields = expr.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+    if (fields.size() != 5)
+    {
+        *errorMessage =
+            QString::fromUtf8("需要5个字段(分 时 日 月 周)，实际为 %1 个")
+                .arg(fields.size());
+        return CronExpression();
+    }
+
+    CronExpression result;
+    quint64 bits = 0;
+    bool wildcard = false;
+
+    if (!parseField(fields.at(0), 0, 59, 0, 0, 0, &bits, &wildcard,
+                    errorMessage))
+        return CronExpression();
+    result.m_minutes = bits;
+
+    if (!parseField(fields.at(1), 0, 23, 0, 0, 0, &bits, &wildcard,
+                    errorMessage))
+        return CronExpression();
+    result.m_hours = (quint32)bits;
+
+    if (!parseField(fields.at(2), 1, 31, 0, 0, 0, &bits, &wildcard,
+                    errorMessage))
+        return CronExpression();
+    result.m_days = (quint32)bits;
+    result.m_dayRestricted = !wildcard;
+
+    if (!parseField(fields.at(3), 1, 12, 1, kMonthNames, 12, &bits,
+                    &wildcard, errorMessage))
+        return CronExpression();
+    result.m_months = (quint32)bits;
+
+    if (!parseField(fields.at(4), 0, 7, 0, kWeekdayNames, 7, &bits,
+                    &wildcard, errorMessage))
+        return CronExpression();
+    // 7 与 0 都表示周日
+    if (bits & ((quint64)1 << 7))
+        bits = (bits | 1) & ~((quint64)1 << 7);
+    result.m_weekdays = (quint32)bits;
+    result.m_weekdayRestricted = !wildcard;
+
+    result.m_valid = true;
+    return result;
+}
+
+CronExpression CronExpression::fromSchedule(
+    const ProcessInfo::Schedule &schedule, QString *errorMessage)
+{
+    QString dummy;
+    if (!errorMessage)
+        errorMessage = &dummy;
+
+    if (schedule.type == "cron")
+    {
+        return parse(schedule.expression, errorMessage);
+    }
+
+    if (schedule.hour < 0 || schedule.hour > 23 || schedule.minute < 0 ||
+        schedule.minute > 59)
+    {
+        *errorMessage = QString::fromUtf8("执行时间未设置或无效");
+        return CronExpression();
+    }
+
+    CronExpression result;
+    result.m_minutes = (quint64)1 << schedule.minute;
+    result.m_hours = (quint32)1 << schedule.hour;
+    result.m_days = (quint32)rangeBits(1, 31);
+    result.m_months = (quint32)rangeBits(1, 12);
+    result.m_weekdays = (quint32)rangeBits(0, 6);
+
+    if (schedule.type == "daily")
+    {
+        // 所有日期均可触发
+    }
+    else if (schedule.type == "weekly")
+    {
+        if (schedule.dayOfWeek < 1 || schedule.dayOfWeek > 7)
+        {
+            *errorMessage = QString::fromUtf8("星期取值 %1 无效")
+                                .arg(schedule.dayOfWeek);
+            return CronExpression();
+        }
+        result.m_weekdays = (quint32)1 << (schedule.dayOfWeek % 7);
+        result.m_weekdayRestricted = true;
+    }
+    else if (schedule.type == "monthly")
+    {
+        if (schedule.dayOfMonth < 1 || schedule.dayOfMonth > 31)
+        {
+            *errorMessage = QString::fromUtf8("日期取值 %1 无效")
+                                .arg(schedule.dayOfMonth);
+            return CronExpression();
+        }
+        // 没有该日期的月份(如31号)自然被跳过
+        result.m_days = (quint32)1 << schedule.dayOfMonth;
+        result.m_dayRestricted = true;
+    }
+    else
+    {
+        *errorMessage =
+            QString::fromUtf8("未知的调度类型 '%1'").arg(schedule.type);
+        return CronExpression();
+    }
+
+    result.m_valid = true;
+    return result;
+}
+
+// 计算某年某月中可触发日期的位集合(第1~31位)
+quint32 CronExpression::dayMaskForMonth(int year, int month) const
+{
+    int daysInMonth = QDate(year, month, 1).daysInMonth();
+    quint32 monthDays = (quint32)rangeBits(1, daysInMonth);
+
+    // 把7位的星期掩码按本月1号是星期几旋转，再平铺到整月
+    int firstWeekday = QDate(year, month, 1).dayOfWeek() % 7;  // 0=周日
+    quint32 week = ((m_weekdays >> firstWeekday) |
+                    (m_weekdays << (7 - firstWeekday))) &
+                   0x7f;
+    quint32 weekdayDays =
+        ((week | (week << 7) | (week << 14) | (week << 21) | (week << 28))
+         << 1) &
+        monthDays;
+    quint32 dayDays = m_days & monthDays;
+
+    if (m_dayRestricted && m_weekdayRestricted)
+        return dayDays | weekdayDays;
+    if (m_weekdayRestricted)
+        return weekdayDays;
+    return dayDays;
+}
+
+QDateTime CronExpression::nextAfter(const QDateTime &after) const
+{
+    if (!m_valid || !after.isValid())
+        return QDateTime();
+
+    // 从 after 所在分钟的下一分钟开始搜索
+    QDateTime start =
+        QDateTime(after.date(),
+                  QTime(after.time().hour(), after.time().minute()))
+            .addSecs(60);
+
+    int year = start.date().year();
+    int month = start.date().month();
+    int day = start.date().day();
+    int hour = start.time().hour();
+    int minute = start.time().minute();
+    const int lastYear = year + kMaxSearchYears;
+
+    while (year <= lastYear)
+    {
+        // 月
+        int m = nextBit(m_months, month);
+        if (m < 0)
+        {
+            ++year;
+            month = 1;
+            day = 1;
+            hour = 0;
+            minute = 0;
+            continue;
+        }
+        if (m != month)
+        {
+            month = m;
+            day = 1;
+            hour = 0;
+            minute = 0;
+        }
+
+        // 日
+        int d = nextBit(dayMaskForMonth(year, month), day);
+        if (d < 0)
+        {
+            if (++month > 12)
+            {
+                ++year;
+                month = 1;
+            }
+            day = 1;
+            hour = 0;
+            minute = 0;
+            continue;
+        }
+        if (d != day)
+        {
+            day = d;
+            hour = 0;
+            minute = 0;
+        }
+
+        // 时
+        int h = nextBit(m_hours, hour);
+        if (h < 0)
+        {
+            ++day;
+            hour = 0;
+            minute = 0;
+            continue;
+        }
+        if (h != hour)
+        {
+            hour = h;
+            minute = 0;
+        }
+
+        // 分
+        int mi = nextBit(m_minutes, minute);
+        if (mi < 0)
+        {
+            ++hour;
+            minute = 0;
+            continue;
+        }
+
+        QDate date(year, month, day);
+        QTime time(hour, mi);
+        QDateTime next(date, time);
+        if (!next.isValid())
+        {
+            // 落在夏令时跳过的那一小时内，顺延一小时
+            next = QDateTime(date, time.addSecs(3600));
+        }
+        if (next > after)
+        {
+            return next;
+        }
+
+        // 夏令时回拨时同一本地时间出现两次，已触发过的那次不再重复
+        minute = mi + 1;
+    }
+
+    return QDateTime();
+}
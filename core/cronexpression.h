@@ -0,0 +1,49 @@
+#ifndef CRONEXPRESSION_H
+#define CRONEXPRESSION_H
+
+#include <QDateTime>
+#include <QString>
+
+#include "processinfo.h"
+
+// 编译后的cron调度表达式。
+// 标准五字段语法：分 时 日 月 周，支持 * , - / 、月份/星期英文缩写
+// (JAN-DEC, SUN-SAT) 以及 @hourly/@daily/@weekly/@monthly/@yearly 宏。
+// 表达式只在解析时编译一次为各字段的位集合，
+// 计算下一次触发时间时逐字段做位扫描，而不是按天/按分钟步进。
+class CronExpression {
+public:
+    CronExpression();
+
+    // 解析失败时返回无效表达式，errorMessage给出原因
+    static CronExpression parse(const QString &text,
+                                QString *errorMessage = 0);
+
+    // 将任务调度配置编译为表达式：type为"cron"时解析expression，
+    // daily/weekly/monthly 转换为等价的位集合
+    static CronExpression fromSchedule(const ProcessInfo::Schedule &schedule,
+                                       QString *errorMessage = 0);
+
+    bool isValid() const { return m_valid; }
+
+    // 严格晚于 after 的下一次触发时间(本地时间，精确到分钟)，
+    // 表达式无效或在可预见的年份内不会触发时返回空QDateTime
+    QDateTime nextAfter(const QDateTime &after) const;
+
+private:
+    quint64 m_minutes;   // 第0~59位
+    quint32 m_hours;     // 第0~23位
+    quint32 m_days;      // 第1~31位
+    quint32 m_months;    // 第1~12位
+    quint32 m_weekdays;  // 第0~6位, 0=周日
+
+    // 日与周字段都被限定时，按cron惯例两者满足其一即可；
+    // 只有一个被限定时以它为准
+    bool m_dayRestricted;
+    bool m_weekdayRestricted;
+    bool m_valid;
+
+    quint32 dayMaskForMonth(int year, int month) const;
+};
+
+#endif  // CRONEXPRESSION_H
@@ -0,0 +1,538 @@
+#include "federationprotocol.h"
+
+#include <QDataStream>
+#include <QIODevice>
+
+namespace
+{
+
+const int kStreamVersion = QDataStream::Qt_5_12;
+
+quint16 quantizeCpu(double cpu)
+{
+    return (quint16)qBound(0, qRound(cpu * 100.0), 65535);
+}
+
+quint32 quantizeMem(double memMB)
+{
+    return (quint32)qMax((qint64)0, (qint64)qRound64(memMB * 10.0));
+}
+
+quint32 clampMs(qint64 ms)
+{
+    return (quint32)qBound((qint64)0, ms, (qint64)0xffffffffLL);
+}
+
+// 长度前缀 + 消息
+QByteArray finishFrame(const QByteArray &payload)
+{
+    QByteArray frame;
+    frame.reserve(payload.size() + 4);
+    {
+        QDataStream out(&frame, QIODevice::WriteOnly);
+        out << (quint32)payload.size();
+    }
+    frame += payload;
+    return frame;
+}
+
+} // namespace
+
+namespace Federation
+{
+
+QString Address::toString() const
+{
+    if (local)
+        return QString("unix:%1").arg(path);
+    if (host.isEmpty())
+        return QString("tcp:%1").arg(port);
+    return QString("tcp:%1:%2").arg(host).arg(port);
+}
+
+bool parseAddress(const QString &text, Address *address, QString *error)
+{
+    QString trimmed = text.trimmed();
+    Address result;
+    if (trimmed.startsWith("unix:"))
+    {
+        result.local = true;
+        result.path = trimmed.mid(5);
+        if (result.path.isEmpty())
+        {
+            *error = QString::fromUtf8("地址 '%1' 缺少套接字路径").arg(text);
+            return false;
+        }
+        *address = result;
+        return true;
+    }
+
+    if (!trimmed.startsWith("tcp:"))
+    {
+        *error = QString::fromUtf8("地址 '%1' 应以 tcp: 或 unix: 开头").arg(text);
+        return false;
+    }
+
+    QString rest = trimmed.mid(4);
+    int colon = rest.lastIndexOf(':');
+    if (colon >= 0)
+    {
+        result.host = rest.left(colon);
+        rest = rest.mid(colon + 1);
+    }
+    if (result.host.isEmpty())
+        result.host = "127.0.0.1";
+    bool ok = false;
+    int port = rest.toInt(&ok);
+    if (!ok || port <= 0 || port > 65535)
+    {
+        *error = QString::fromUtf8("地址 '%1' 的端口无效").arg(text);
+        return false;
+    }
+    result.port = (quint16)port;
+    *address = result;
+    return true;
+}
+
+} // namespace Federation
+
+FederationEncoder::Status::Status()
+{
+    state = ProcessState::Stopped;
+    pid = 0;
+    cpu = 0;
+    mem = 0;
+    restarts = 0;
+    for (int i = 0; i < 6; ++i)
+        latency[i] = 0;
+}
+
+namespace
+{
+
+// 按掩码写出字段；Add 消息总是写全部字段
+template <typename Status>
+void writeFields(QDataStream &out, const Status &status, quint8 fields)
+{
+    if (fields & Federation::StateField)
+        out << status.state;
+    if (fields & Federation::PidField)
+        out << status.pid;
+    if (fields & Federation::CpuField)
+        out << status.cpu;
+    if (fields & Federation::MemField)
+        out << status.mem;
+    if (fields & Federation::RestartsField)
+        out << status.restarts;
+    if (fields & Federation::LatencyField)
+    {
+        for (int i = 0; i < 6; ++i)
+            out << status.latency[i];
+    }
+}
+
+void readLatency(QDataStream &in, LatencySummary *summary)
+{
+    quint32 count = 0;
+    quint32 p50 = 0;
+    quint32 p99 = 0;
+    in >> count >> p50 >> p99;
+    *summary = LatencySummary();
+    summary->count = count;
+    summary->p50 = p50;
+    summary->p99 = p99;
+}
+
+void readFields(QDataStream &in, ProcessInfo *info, quint8 fields)
+{
+    if (fields & Federation::StateField)
+    {
+        quint8 state = 0;
+        in >> state;
+        info->state = state < ProcessState::Count ? (ProcessState::State)state
+                                                  : ProcessState::Error;
+    }
+    if (fields & Federation::PidField)
+    {
+        qint64 pid = 0;
+        in >> pid;
+        info->pid = pid;
+    }
+    if (fields & Federation::CpuField)
+    {
+        quint16 cpu = 0;
+        in >> cpu;
+        info->cpuUsage = cpu / 100.0;
+    }
+    if (fields & Federation::MemField)
+    {
+        quint32 mem = 0;
+        in >> mem;
+        info->memUsage = mem / 10.0;
+    }
+    if (fields & Federation::RestartsField)
+    {
+        quint32 restarts = 0;
+        in >> restarts;
+        info->restartCount = (int)restarts;
+    }
+    if (fields & Federation::LatencyField)
+    {
+        readLatency(in, &info->startLatency);
+        readLatency(in, &info->stopLatency);
+    }
+}
+
+} // namespace
+
+// --- FederationEncoder ---
+
+FederationEncoder::FederationEncoder(const QString &host) : m_host(host)
+{
+}
+
+FederationEncoder::Record *FederationEncoder::find(const QString &id)
+{
+    QHash<QString, quint32>::const_iterator it = m_handles.constFind(id);
+    return it == m_handles.constEnd() ? 0 : &m_records[(int)it.value()];
+}
+
+void FederationEncoder::markDirty(quint32 handle, quint8 fields)
+{
+    Record &record = m_records[(int)handle];
+    record.dirtyFields |= fields;
+    if (!record.queued)
+    {
+        record.queued = true;
+        m_dirty.append(handle);
+    }
+}
+
+void FederationEncoder::setService(const ProcessInfo &info)
+{
+    quint32 handle;
+    QHash<QString, quint32>::const_iterator it = m_handles.constFind(info.id);
+    if (it != m_handles.constEnd())
+    {
+        handle = it.value();
+    }
+    else if (!m_freeHandles.isEmpty())
+    {
+        handle = m_freeHandles.last();
+        m_freeHandles.removeLast();
+    }
+    else
+    {
+        handle = (quint32)m_records.size();
+        m_records.append(Record());
+    }
+
+    if (it == m_handles.constEnd())
+    {
+        Record &record = m_records[(int)handle];
+        record.id = info.id;
+        record.status = Status();
+        record.dirtyFields = 0;
+        record.used = true;
+        m_handles.insert(info.id, handle);
+    }
+
+    Record &record = m_records[(int)handle];
+    record.name = info.name;
+    record.type = info.type;
+    record.added = true;
+    markDirty(handle, 0);
+
+    setStatus(info.id, info.state, info.pid, info.cpuUsage, info.memUsage);
+    setRestartCount(info.id, info.restartCount);
+    setLifecycle(info.id, info.startLatency, info.stopLatency);
+}
+
+void FederationEncoder::removeService(const QString &id)
+{
+    QHash<QString, quint32>::iterator it = m_handles.find(id);
+    if (it == m_handles.end())
+        return;
+
+    quint32 handle = it.value();
+    m_handles.erase(it);
+    Record &record = m_records[(int)handle];
+    record.id.clear();
+    record.name.clear();
+    record.type.clear();
+    record.dirtyFields = 0;
+    record.added = false;
+    record.used = false;
+    // 句柄可能在同一周期内被复用，Remove 总是先于 Add/Change 发出
+    m_removed.append(handle);
+    m_freeHandles.append(handle);
+}
+
+void FederationEncoder::setStatus(const QString &id, ProcessState::State state,
+                                  qint64 pid, double cpu, double mem)
+{
+    Record *record = find(id);
+    if (!record)
+        return;
+
+    Status &status = record->status;
+    quint8 fields = 0;
+    if (status.state != (quint8)state)
+    {
+        status.state = (quint8)state;
+        fields |= Federation::StateField;
+    }
+    if (status.pid != pid)
+    {
+        status.pid = pid;
+        fields |= Federation::PidField;
+    }
+    quint16 cpuValue = quantizeCpu(cpu);
+    if (status.cpu != cpuValue)
+    {
+        status.cpu = cpuValue;
+        fields |= Federation::CpuField;
+    }
+    quint32 memValue = quantizeMem(mem);
+    if (status.mem != memValue)
+    {
+        status.mem = memValue;
+        fields |= Federation::MemField;
+    }
+    if (fields)
+        markDirty(m_handles.value(id), fields);
+}
+
+void FederationEncoder::setRestartCount(const QString &id, int count)
+{
+    Record *record = find(id);
+    if (!record || record->status.restarts == (quint32)qMax(0, count))
+        return;
+    record->status.restarts = (quint32)qMax(0, count);
+    markDirty(m_handles.value(id), Federation::RestartsField);
+}
+
+void FederationEncoder::setLifecycle(const QString &id,
+                                     const LatencySummary &start,
+                                     const LatencySummary &stop)
+{
+    Record *record = find(id);
+    if (!record)
+        return;
+
+    quint32 latency[6] = {
+        (quint32)qMin(start.count, (quint64)0xffffffffULL), clampMs(start.p50),
+        clampMs(start.p99),
+        (quint32)qMin(stop.count, (quint64)0xffffffffULL), clampMs(stop.p50),
+        clampMs(stop.p99)};
+    bool changed = false;
+    for (int i = 0; i < 6; ++i)
+    {
+        if (record->status.latency[i] != latency[i])
+        {
+            record->status.latency[i] = latency[i];
+            changed = true;
+        }
+    }
+    if (changed)
+        markDirty(m_handles.value(id), Federation::LatencyField);
+}
+
+QByteArray FederationEncoder::snapshotFrame() const
+{
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(kStreamVersion);
+        out << (quint8)Federation::HelloMessage << Federation::ProtocolVersion
+            << m_host;
+        for (int handle = 0; handle < m_records.size(); ++handle)
+        {
+            const Record &record = m_records.at(handle);
+            if (!record.used)
+                continue;
+            out << (quint8)Federation::AddMessage << (quint32)handle
+                << record.id << record.name << record.type;
+            writeFields(out, record.status, Federation::AllFields);
+        }
+    }
+    return finishFrame(payload);
+}
+
+QByteArray FederationEncoder::takeDeltaFrame()
+{
+    if (m_dirty.isEmpty() && m_removed.isEmpty())
+        return QByteArray();
+
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(kStreamVersion);
+        for (int i = 0; i < m_removed.size(); ++i)
+            out << (quint8)Federation::RemoveMessage << m_removed.at(i);
+
+        for (int i = 0; i < m_dirty.size(); ++i)
+        {
+            quint32 handle = m_dirty.at(i);
+            Record &record = m_records[(int)handle];
+            record.queued = false;
+            if (!record.used)
+                continue;
+
+            if (record.added)
+            {
+                out << (quint8)Federation::AddMessage << handle << record.id
+                    << record.name << record.type;
+                writeFields(out, record.status, Federation::AllFields);
+            }
+            else if (record.dirtyFields)
+            {
+                out << (quint8)Federation::ChangeMessage << handle
+                    << record.dirtyFields;
+                writeFields(out, record.status, record.dirtyFields);
+            }
+            record.added = false;
+            record.dirtyFields = 0;
+        }
+    }
+    m_removed.clear();
+    m_dirty.clear();
+
+    if (payload.isEmpty())
+        return QByteArray();
+    return finishFrame(payload);
+}
+
+void FederationEncoder::clearDelta()
+{
+    for (int i = 0; i < m_dirty.size(); ++i)
+    {
+        Record &record = m_records[(int)m_dirty.at(i)];
+        record.queued = false;
+        record.added = false;
+        record.dirtyFields = 0;
+    }
+    m_dirty.clear();
+    m_removed.clear();
+}
+
+// --- FederationDecoder ---
+
+FederationDecoder::FederationDecoder()
+{
+}
+
+const ProcessInfo &FederationDecoder::service(quint32 handle) const
+{
+    QHash<quint32, ProcessInfo>::const_iterator it = m_services.constFind(handle);
+    Q_ASSERT(it != m_services.constEnd());
+    return it.value();
+}
+
+bool FederationDecoder::feed(const QByteArray &data, FederationChanges *changes)
+{
+    m_buffer += data;
+
+    int offset = 0;
+    bool ok = true;
+    while (m_buffer.size() - offset >= 4)
+    {
+        quint32 length = 0;
+        QDataStream header(m_buffer.mid(offset, 4));
+        header >> length;
+        if (length > (quint32)Federation::MaxFrameBytes)
+        {
+            ok = false;
+            break;
+        }
+        if ((quint32)(m_buffer.size() - offset - 4) < length)
+            break;
+
+        if (!decodeFrame(m_buffer.mid(offset + 4, (int)length), changes))
+        {
+            ok = false;
+            break;
+        }
+        offset += 4 + (int)length;
+    }
+
+    if (!ok)
+    {
+        m_buffer.clear();
+        return false;
+    }
+    m_buffer.remove(0, offset);
+    return true;
+}
+
+bool FederationDecoder::decodeFrame(const QByteArray &frame,
+                                    FederationChanges *changes)
+{
+    QDataStream in(frame);
+    in.setVersion(kStreamVersion);
+
+    while (!in.atEnd())
+    {
+        quint8 type = 0;
+        in >> type;
+
+        if (type == Federation::HelloMessage)
+        {
+            quint16 version = 0;
+            in >> version >> m_host;
+            if (version != Federation::ProtocolVersion)
+                return false;
+            m_services.clear();
+            changes->reset = true;
+            changes->updated.clear();
+            changes->removed.clear();
+        }
+        else if (type == Federation::AddMessage)
+        {
+            quint32 handle = 0;
+            ProcessInfo info;
+            in >> handle >> info.id >> info.name >> info.type;
+            readFields(in, &info, Federation::AllFields);
+            if (in.status() != QDataStream::Ok)
+                return false;
+
+            // 句柄被另一个服务复用而 Remove 已在之前的帧中处理过时，这里直接覆盖
+            QHash<quint32, ProcessInfo>::iterator existing = m_services.find(handle);
+            if (existing != m_services.end() && existing->id != info.id)
+                changes->removed.append(existing->id);
+            m_services.insert(handle, info);
+            changes->updated.insert(handle);
+        }
+        else if (type == Federation::ChangeMessage)
+        {
+            quint32 handle = 0;
+            quint8 fields = 0;
+            in >> handle >> fields;
+            QHash<quint32, ProcessInfo>::iterator it = m_services.find(handle);
+            if (it == m_services.end())
+                return false;
+            readFields(in, &it.value(), fields);
+            changes->updated.insert(handle);
+        }
+        else if (type == Federation::RemoveMessage)
+        {
+            quint32 handle = 0;
+            in >> handle;
+            QHash<quint32, ProcessInfo>::iterator it = m_services.find(handle);
+            if (it != m_services.end())
+            {
+                changes->removed.append(it->id);
+                changes->updated.remove(handle);
+                m_services.erase(it);
+            }
+        }
+        else
+        {
+            return false;
+        }
+
+        if (in.status() != QDataStream::Ok)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,163 @@
+#ifndef FEDERATIONPROTOCOL_H
+#define FEDERATIONPROTOCOL_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "processinfo.h"
+
+// 多个管理器实例之间的状态流协议。
+// 每个实例把自己的服务状态推给连接上来的界面，界面把多台主机合并到一张表里。
+//
+// 数据按帧发送: quint32 长度 + 若干条消息(QDataStream，大端)。
+// 连接建立后先发一帧快照(Hello + 每个服务一条 Add)，
+// 之后每个监控周期最多一帧，只含有变化的服务和有变化的字段。
+// 服务在连接内用整数句柄标识，变化消息里不再重复服务ID。
+// CPU 精确到0.01%、内存精确到0.1MB，低于精度的抖动不会产生消息。
+namespace Federation
+{
+
+const quint16 ProtocolVersion = 1;
+const int MaxFrameBytes = 64 * 1024 * 1024;
+
+enum MessageType
+{
+    HelloMessage = 1,   // quint16 版本, QString 主机名；之前收到的服务全部作废
+    AddMessage = 2,     // 句柄, ID, 名称, 类型, 全部字段；句柄已存在时覆盖
+    ChangeMessage = 3,  // 句柄, quint8 字段掩码, 掩码中的字段
+    RemoveMessage = 4   // 句柄
+};
+
+enum Field
+{
+    StateField = 0x01,     // quint8
+    PidField = 0x02,       // qint64
+    CpuField = 0x04,       // quint16, 0.01%
+    MemField = 0x08,       // quint32, 0.1MB
+    RestartsField = 0x10,  // quint32
+    LatencyField = 0x20,   // 启动、停止各 quint32 次数/P50/P99 (ms)
+    AllFields = 0x3f
+};
+
+// "tcp:端口"、"tcp:地址:端口" 或 "unix:路径"。
+// 只写端口时为本机(127.0.0.1)，对外监听需写明地址，例如 "tcp:0.0.0.0:端口"
+struct Address {
+    bool local;     // unix 套接字
+    QString host;   // tcp
+    quint16 port;
+    QString path;   // unix
+
+    Address() {
+        local = false;
+        port = 0;
+    }
+
+    QString toString() const;
+};
+
+bool parseAddress(const QString &text, Address *address, QString *error);
+
+}  // namespace Federation
+
+// 服务端：跟踪本实例所有服务的最新状态，生成快照帧和增量帧。
+// 所有客户端共用同一份增量，每个监控周期编码一次。
+class FederationEncoder {
+public:
+    explicit FederationEncoder(const QString &host);
+
+    QString host() const { return m_host; }
+    int serviceCount() const { return m_handles.count(); }
+
+    // 新增服务或配置变化(名称、类型)
+    void setService(const ProcessInfo &info);
+    void removeService(const QString &id);
+    void setStatus(const QString &id, ProcessState::State state, qint64 pid,
+                   double cpu, double mem);
+    void setRestartCount(const QString &id, int count);
+    void setLifecycle(const QString &id, const LatencySummary &start,
+                      const LatencySummary &stop);
+
+    // Hello + 所有服务的当前状态，发给新连接的客户端
+    QByteArray snapshotFrame() const;
+    // 自上次调用以来的变化；没有变化时返回空
+    QByteArray takeDeltaFrame();
+    // 没有客户端时丢弃累积的变化，不做编码
+    void clearDelta();
+
+private:
+    struct Status {
+        quint8 state;
+        qint64 pid;
+        quint16 cpu;
+        quint32 mem;
+        quint32 restarts;
+        quint32 latency[6];  // 启动次数/P50/P99，停止次数/P50/P99
+
+        Status();
+    };
+
+    struct Record {
+        QString id;
+        QString name;
+        QString type;
+        Status status;
+        quint8 dirtyFields;
+        bool added;   // 自上次增量以来新增或配置变化，需整条重发
+        bool queued;  // 已在 m_dirty 中
+        bool used;
+
+        Record() {
+            dirtyFields = 0;
+            added = false;
+            queued = false;
+            used = false;
+        }
+    };
+
+    Record *find(const QString &id);
+    void markDirty(quint32 handle, quint8 fields);
+
+    QString m_host;
+    QVector<Record> m_records;  // 按句柄索引
+    QVector<quint32> m_freeHandles;
+    QHash<QString, quint32> m_handles;
+    QVector<quint32> m_dirty;
+    QVector<quint32> m_removed;
+};
+
+// 一次 feed() 带来的变化
+struct FederationChanges {
+    bool reset;              // 收到 Hello：对端(重新)连接，之前的服务全部作废
+    QSet<quint32> updated;   // 新增或有变化的服务句柄
+    QStringList removed;     // 被删除的服务ID
+
+    FederationChanges() { reset = false; }
+};
+
+// 客户端：把收到的字节拆成帧，维护对端服务的镜像。
+class FederationDecoder {
+public:
+    FederationDecoder();
+
+    // 追加收到的数据并处理其中所有完整的帧；数据损坏时返回false，连接应断开
+    bool feed(const QByteArray &data, FederationChanges *changes);
+
+    QString host() const { return m_host; }
+    bool contains(quint32 handle) const { return m_services.contains(handle); }
+    // 只有ID、名称、类型和动态字段有效；启停耗时只有次数、P50、P99
+    const ProcessInfo &service(quint32 handle) const;
+    int serviceCount() const { return m_services.count(); }
+
+private:
+    bool decodeFrame(const QByteArray &frame, FederationChanges *changes);
+
+    QByteArray m_buffer;
+    QString m_host;
+    QHash<quint32, ProcessInfo> m_services;
+};
+
+#endif  // FEDERATIONPROTOCOL_H
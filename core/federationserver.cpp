@@ -0,0 +1,200 @@
+#include "federationserver.h"
+
+#include <QHostAddress>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+FederationServer::FederationServer(const QString &host, QObject *parent)
+    : QObject(parent), m_encoder(host)
+{
+    m_tcpServer = 0;
+    m_localServer = 0;
+}
+
+bool FederationServer::listen(const QString &address, QString *error)
+{
+    Federation::Address parsed;
+    if (!Federation::parseAddress(address, &parsed, error))
+        return false;
+
+    if (parsed.local)
+    {
+        // 上次异常退出留下的套接字文件会让 listen 失败；
+        // 但不能删掉另一个仍在运行的实例的套接字
+        QLocalSocket probe;
+        probe.connectToServer(parsed.path);
+        if (probe.waitForConnected(500))
+        {
+            probe.abort();
+            *error = QString::fromUtf8("%1 已有其他实例在监听")
+                         .arg(parsed.toString());
+            return false;
+        }
+        QLocalServer::removeServer(parsed.path);
+        m_localServer = new QLocalServer(this);
+        connect(m_localServer, SIGNAL(newConnection()), this,
+                SLOT(onNewConnection()));
+        if (!m_localServer->listen(parsed.path))
+        {
+            *error = QString::fromUtf8("无法监听 %1: %2")
+                         .arg(parsed.toString())
+                         .arg(m_localServer->errorString());
+            delete m_localServer;
+            m_localServer = 0;
+            return false;
+        }
+        return true;
+    }
+
+    QHostAddress bindAddress(parsed.host);
+    if (bindAddress.isNull())
+    {
+        *error = QString::fromUtf8("无法监听 %1: 监听地址必须是IP地址")
+                     .arg(parsed.toString());
+        return false;
+    }
+
+    m_tcpServer = new QTcpServer(this);
+    connect(m_tcpServer, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+    if (!m_tcpServer->listen(bindAddress, parsed.port))
+    {
+        *error = QString::fromUtf8("无法监听 %1: %2")
+                     .arg(parsed.toString())
+                     .arg(m_tcpServer->errorString());
+        delete m_tcpServer;
+        m_tcpServer = 0;
+        return false;
+    }
+    return true;
+}
+
+bool FederationServer::isListening() const
+{
+    return (m_tcpServer && m_tcpServer->isListening()) ||
+           (m_localServer && m_localServer->isListening());
+}
+
+void FederationServer::setServices(const QList<ProcessInfo> &processes)
+{
+    for (int i = 0; i < processes.count(); ++i)
+    {
+        m_encoder.setService(processes.at(i));
+    }
+}
+
+void FederationServer::setService(const ProcessInfo &info)
+{
+    m_encoder.setService(info);
+}
+
+void FederationServer::removeService(const QString &id)
+{
+    m_encoder.removeService(id);
+}
+
+void FederationServer::setStatus(const QString &id, ProcessState::State state,
+                                 qint64 pid, double cpu, double mem)
+{
+    m_encoder.setStatus(id, state, pid, cpu, mem);
+}
+
+void FederationServer::setRestartCount(const QString &id, int count)
+{
+    m_encoder.setRestartCount(id, count);
+}
+
+void FederationServer::setLifecycleTimings(const QString &id,
+                                           const LatencySummary &start,
+                                           const LatencySummary &stop)
+{
+    m_encoder.setLifecycle(id, start, stop);
+}
+
+void FederationServer::flush()
+{
+    if (m_clients.isEmpty())
+    {
+        m_encoder.clearDelta();
+        return;
+    }
+
+    QByteArray frame = m_encoder.takeDeltaFrame();
+    if (frame.isEmpty())
+        return;
+
+    // dropClient 会修改列表
+    QList<QIODevice *> clients = m_clients;
+    for (int i = 0; i < clients.count(); ++i)
+    {
+        QIODevice *socket = clients.at(i);
+        if (socket->bytesToWrite() > MaxBacklogBytes)
+        {
+            dropClient(socket, QString::fromUtf8("接收太慢，积压超过 %1 MB")
+                                   .arg(MaxBacklogBytes / (1024 * 1024)));
+            continue;
+        }
+        socket->write(frame);
+    }
+}
+
+void FederationServer::onNewConnection()
+{
+    if (m_tcpServer)
+    {
+        while (m_tcpServer->hasPendingConnections())
+        {
+            QTcpSocket *socket = m_tcpServer->nextPendingConnection();
+            socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            addClient(socket, QString("%1:%2")
+                                  .arg(socket->peerAddress().toString())
+                                  .arg(socket->peerPort()));
+        }
+    }
+    if (m_localServer)
+    {
+        while (m_localServer->hasPendingConnections())
+        {
+            addClient(m_localServer->nextPendingConnection(),
+                      m_localServer->fullServerName());
+        }
+    }
+}
+
+void FederationServer::addClient(QIODevice *socket, const QString &peer)
+{
+    connect(socket, SIGNAL(disconnected()), this, SLOT(onClientDisconnected()));
+    socket->setObjectName(peer);
+    m_clients.append(socket);
+
+    // 快照之前累积的增量已包含在快照里，对其他客户端照常发出
+    socket->write(m_encoder.snapshotFrame());
+    emit logMessage(QString::fromUtf8("[联合视图] 客户端 %1 已连接，已发送 %2 个服务的快照。")
+                        .arg(peer)
+                        .arg(m_encoder.serviceCount()));
+}
+
+void FederationServer::dropClient(QIODevice *socket, const QString &reason)
+{
+    if (!m_clients.removeOne(socket))
+        return;
+
+    emit logMessage(QString::fromUtf8("[联合视图] 断开客户端 %1: %2")
+                        .arg(socket->objectName())
+                        .arg(reason));
+    socket->disconnect(this);
+    socket->close();
+    socket->deleteLater();
+}
+
+void FederationServer::onClientDisconnected()
+{
+    QIODevice *socket = qobject_cast<QIODevice *>(sender());
+    if (!socket || !m_clients.removeOne(socket))
+        return;
+
+    emit logMessage(QString::fromUtf8("[联合视图] 客户端 %1 已断开。")
+                        .arg(socket->objectName()));
+    socket->deleteLater();
+}
@@ -0,0 +1,60 @@
+#ifndef FEDERATIONSERVER_H
+#define FEDERATIONSERVER_H
+
+#include <QList>
+#include <QObject>
+
+#include "federationprotocol.h"
+
+class QIODevice;
+class QLocalServer;
+class QTcpServer;
+
+// 把本实例的服务状态推送给远程界面(见 federationprotocol.h)。
+// 与 BackendWorker 同属后台线程，直接接收它的状态信号；
+// 每个监控周期结束时 flush() 一次，把这一周期的增量发给所有客户端。
+// 客户端接收太慢、积压超过 MaxBacklogBytes 时断开它，重连后会重新收到快照。
+class FederationServer : public QObject {
+    Q_OBJECT
+
+public:
+    static const int MaxBacklogBytes = 8 * 1024 * 1024;
+
+    explicit FederationServer(const QString &host, QObject *parent = 0);
+
+    // address 见 Federation::parseAddress。unix 套接字文件已存在时先尝试连接，
+    // 没有进程应答(上次异常退出留下的)才删除；仍有实例在监听时返回false
+    bool listen(const QString &address, QString *error);
+    bool isListening() const;
+    int clientCount() const { return m_clients.count(); }
+
+public slots:
+    void setServices(const QList<ProcessInfo> &processes);
+    void setService(const ProcessInfo &info);
+    void removeService(const QString &id);
+    void setStatus(const QString &id, ProcessState::State state, qint64 pid,
+                   double cpu, double mem);
+    void setRestartCount(const QString &id, int count);
+    void setLifecycleTimings(const QString &id, const LatencySummary &start,
+                             const LatencySummary &stop);
+    // 发出本周期的增量
+    void flush();
+
+signals:
+    void logMessage(const QString &message);
+
+private slots:
+    void onNewConnection();
+    void onClientDisconnected();
+
+private:
+    void addClient(QIODevice *socket, const QString &peer);
+    void dropClient(QIODevice *socket, const QString &reason);
+
+    FederationEncoder m_encoder;
+    QTcpServer *m_tcpServer;
+    QLocalServer *m_localServer;
+    QList<QIODevice *> m_clients;
+};
+
+#endif  // FEDERATIONSERVER_H
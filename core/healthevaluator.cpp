@@ -0,0 +1,151 @@
+#include "healthevaluator.h"
+
+#include <algorithm>
+#include <cmath>
+
+HealthEvaluator::HealthEvaluator()
+{
+    m_threshold = 0.0;
+    reset();
+}
+
+HealthEvaluator::HealthEvaluator(const ProcessInfo::HealthWindow &window,
+                                 double threshold, int sampleIntervalMs)
+{
+    m_window = window;
+    m_threshold = threshold;
+    if (m_window.evaluator == ProcessInfo::HealthWindow::Percentile)
+    {
+        // 窗口内的样本数加上两个余量，容纳定时器抖动造成的略密采样
+        int capacity = (int)((qint64)m_window.windowSeconds * 1000 /
+                             qMax(1, sampleIntervalMs)) + 2;
+        m_samples.resize(capacity);
+        m_scratch.reserve(capacity);
+    }
+    reset();
+}
+
+void HealthEvaluator::reset()
+{
+    m_head = 0;
+    m_count = 0;
+    m_ewma = 0.0;
+    m_lastSampleMs = -1;
+    m_aboveSinceMs = -1;
+    m_firstSampleMs = -1;
+    m_statistic = 0.0;
+}
+
+bool HealthEvaluator::addSample(qint64 nowMs, double value)
+{
+    if (m_threshold <= 0.0)
+        return false;
+
+    if (m_firstSampleMs < 0)
+        m_firstSampleMs = nowMs;
+    qint64 windowMs = (qint64)m_window.windowSeconds * 1000;
+
+    if (m_window.evaluator == ProcessInfo::HealthWindow::Ewma)
+    {
+        // 按实际采样间隔换算平滑系数，采样抖动不影响时间常数
+        if (m_lastSampleMs < 0)
+        {
+            m_ewma = value;
+        }
+        else
+        {
+            double dt = (double)qMax((qint64)0, nowMs - m_lastSampleMs);
+            double alpha = 1.0 - std::exp(-dt / qMax((qint64)1, windowMs));
+            m_ewma += alpha * (value - m_ewma);
+        }
+        m_lastSampleMs = nowMs;
+        m_statistic = m_ewma;
+
+        // 至少观察满一个时间常数的一半，避免首个样本即触发
+        return nowMs - m_firstSampleMs >= windowMs / 2 &&
+               m_ewma > m_threshold;
+    }
+
+    if (m_window.evaluator == ProcessInfo::HealthWindow::Percentile)
+    {
+        int capacity = m_samples.size();
+        int index = (m_head + m_count) % capacity;
+        if (m_count == capacity)
+        {
+            m_head = (m_head + 1) % capacity;
+        }
+        else
+        {
+            ++m_count;
+        }
+        m_samples[index].timeMs = nowMs;
+        m_samples[index].value = value;
+
+        while (m_count > 0 && m_samples[m_head].timeMs <= nowMs - windowMs)
+        {
+            m_head = (m_head + 1) % capacity;
+            --m_count;
+        }
+
+        m_statistic = percentileOfWindow();
+
+        // 窗口尚未填满时样本不足以代表整体分布
+        return nowMs - m_firstSampleMs >= windowMs &&
+               m_statistic > m_threshold;
+    }
+
+    // duration(默认)
+    m_statistic = value;
+    if (value <= m_threshold)
+    {
+        m_aboveSinceMs = -1;
+        return false;
+    }
+    if (m_aboveSinceMs < 0)
+    {
+        m_aboveSinceMs = nowMs;
+    }
+    return nowMs - m_aboveSinceMs >= (qint64)m_window.forSeconds * 1000;
+}
+
+QString HealthEvaluator::describe() const
+{
+    if (m_window.evaluator == ProcessInfo::HealthWindow::Ewma)
+    {
+        return QString::fromUtf8("%1秒EWMA %2 > 阈值 %3")
+            .arg(m_window.windowSeconds)
+            .arg(m_statistic, 0, 'f', 1)
+            .arg(m_threshold);
+    }
+    if (m_window.evaluator == ProcessInfo::HealthWindow::Percentile)
+    {
+        return QString::fromUtf8("%1秒窗口 P%2 = %3 > 阈值 %4")
+            .arg(m_window.windowSeconds)
+            .arg(m_window.percentile)
+            .arg(m_statistic, 0, 'f', 1)
+            .arg(m_threshold);
+    }
+    return QString::fromUtf8("持续 %1 秒高于阈值 %2 (当前 %3)")
+        .arg(m_window.forSeconds)
+        .arg(m_threshold)
+        .arg(m_statistic, 0, 'f', 1);
+}
+
+double HealthEvaluator::percentileOfWindow()
+{
+    if (m_count == 0)
+        return 0.0;
+
+    m_scratch.resize(m_count);
+    for (int i = 0; i < m_count; ++i)
+    {
+        m_scratch[i] = m_samples[(m_head + i) % m_samples.size()].value;
+    }
+
+    // 最近秩法：第 ceil(p/100 * n) 小的样本
+    int rank = (int)std::ceil(m_window.percentile / 100.0 * m_count);
+    rank = qBound(1, rank, m_count);
+    std::nth_element(m_scratch.begin(), m_scratch.begin() + (rank - 1),
+                     m_scratch.end());
+    return m_scratch[rank - 1];
+}
@@ -0,0 +1,58 @@
+#ifndef HEALTHEVALUATOR_H
+#define HEALTHEVALUATOR_H
+
+#include <QString>
+#include <QVector>
+
+#include "processinfo.h"
+
+// 单个指标(CPU或内存)的滑动窗口健康判定，内存占用固定。
+// - duration:   连续超过阈值的时长达到 forSeconds 即判定超标
+// - ewma:       以 windowSeconds 为时间常数的指数加权均值超过阈值
+// - percentile: 最近 windowSeconds 内样本的第 percentile 百分位超过阈值
+// 样本时间间隔不要求固定。percentile 的环形缓冲区按窗口长度和预期采样间隔
+// 分配，比预期更密的采样使缓冲区写满时丢弃最旧的样本。
+class HealthEvaluator {
+public:
+    HealthEvaluator();
+    HealthEvaluator(const ProcessInfo::HealthWindow &window, double threshold,
+                    int sampleIntervalMs);
+
+    // 加入一个样本并返回当前是否判定为超标
+    bool addSample(qint64 nowMs, double value);
+
+    // 最近一次判定所用的统计量(用于日志)
+    double statistic() const { return m_statistic; }
+    QString describe() const;
+
+    void reset();
+
+private:
+    struct Sample {
+        qint64 timeMs;
+        double value;
+    };
+
+    double percentileOfWindow();
+
+    ProcessInfo::HealthWindow m_window;
+    double m_threshold;
+
+    // percentile: 环形缓冲区，容量即 m_samples.size()
+    QVector<Sample> m_samples;
+    QVector<double> m_scratch;
+    int m_head;
+    int m_count;
+
+    // ewma
+    double m_ewma;
+    qint64 m_lastSampleMs;
+
+    // duration
+    qint64 m_aboveSinceMs;
+
+    qint64 m_firstSampleMs;
+    double m_statistic;
+};
+
+#endif  // HEALTHEVALUATOR_H
@@ -0,0 +1,356 @@
+#include "healthprober.h"
+
+#include <QList>
+#include <QRandomGenerator>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QVector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <sys/types.h>
+
+extern char **environ;
+
+HealthProber::HealthProber(QObject *parent) : QObject(parent)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+
+    m_clock.start();
+}
+
+HealthProber::~HealthProber()
+{
+    for (QHash<QString, Target>::iterator it = m_targets.begin();
+         it != m_targets.end(); ++it)
+    {
+        cancelProbe(it.value());
+    }
+}
+
+void HealthProber::watch(const QString &id, const ProcessInfo::Probe &probe)
+{
+    unwatch(id);
+
+    Target target;
+    target.probe = probe;
+    m_targets.insert(id, target);
+
+    // 首次探测在初始延迟之后的一个探测周期内随机分布，避免大量服务同时探测
+    qint64 spreadMs =
+        QRandomGenerator::global()->bounded(probe.intervalSeconds * 1000 + 1);
+    schedule(id, m_targets[id],
+             m_clock.elapsed() + probe.initialDelaySeconds * 1000LL + spreadMs);
+    rearm();
+}
+
+void HealthProber::unwatch(const QString &id)
+{
+    QHash<QString, Target>::iterator it = m_targets.find(id);
+    if (it == m_targets.end())
+        return;
+
+    cancelProbe(it.value());
+    if (it->nextEventMs >= 0)
+    {
+        m_events.remove(it->nextEventMs, id);
+    }
+    m_targets.erase(it);
+    rearm();
+}
+
+bool HealthProber::isWatching(const QString &id) const
+{
+    return m_targets.contains(id);
+}
+
+bool HealthProber::childExited(qint64 pid, int exitCode, int signalNumber)
+{
+    QHash<qint64, QString>::iterator pidIt = m_execPids.find(pid);
+    if (pidIt == m_execPids.end())
+        return false;
+
+    QString id = pidIt.value();
+    m_execPids.erase(pidIt);
+
+    // 超时后被杀掉的探针进程，结果已经按失败记录过
+    QHash<QString, Target>::iterator it = m_targets.find(id);
+    if (it == m_targets.end() || !it->inFlight || it->execPid != pid)
+        return true;
+
+    it->execPid = 0;
+    if (signalNumber != 0)
+    {
+        finishProbe(id, false,
+                    QString::fromUtf8("探测命令被信号 %1 终止").arg(signalNumber));
+    }
+    else
+    {
+        finishProbe(id, exitCode == 0,
+                    QString::fromUtf8("探测命令退出码 %1").arg(exitCode));
+    }
+    return true;
+}
+
+void HealthProber::onTimeout()
+{
+    qint64 now = m_clock.elapsed();
+
+    QStringList due;
+    QMultiMap<qint64, QString>::iterator it = m_events.begin();
+    while (it != m_events.end() && it.key() <= now)
+    {
+        due.append(it.value());
+        m_targets[it.value()].nextEventMs = -1;
+        it = m_events.erase(it);
+    }
+
+    for (int i = 0; i < due.count(); ++i)
+    {
+        QHash<QString, Target>::iterator target = m_targets.find(due.at(i));
+        if (target == m_targets.end())
+            continue;
+
+        if (target->inFlight)
+        {
+            finishProbe(due.at(i), false,
+                        QString::fromUtf8("%1 毫秒内无响应")
+                            .arg(target->probe.timeoutMs));
+        }
+        else
+        {
+            startProbe(due.at(i), target.value());
+        }
+    }
+
+    rearm();
+}
+
+void HealthProber::startProbe(const QString &id, Target &target)
+{
+    const ProcessInfo::Probe &probe = target.probe;
+    target.inFlight = true;
+    target.response.clear();
+    schedule(id, target, m_clock.elapsed() + probe.timeoutMs);
+
+    if (probe.type == "exec")
+    {
+        qint64 pid = 0;
+        QString error;
+        if (!spawnExec(probe, &pid, &error))
+        {
+            finishProbe(id, false, error);
+            return;
+        }
+        target.execPid = pid;
+        m_execPids.insert(pid, id);
+        emit execSpawned(pid);
+        return;
+    }
+
+    QString host = probe.host;
+    int port = probe.port;
+    if (probe.type == "http")
+    {
+        QUrl url(probe.url);
+        host = url.host();
+        port = url.port(80);
+    }
+
+    QTcpSocket *socket = new QTcpSocket(this);
+    target.socket = socket;
+    m_sockets.insert(socket, id);
+    connect(socket, SIGNAL(connected()), this, SLOT(onSocketConnected()));
+    connect(socket, SIGNAL(readyRead()), this, SLOT(onSocketReadyRead()));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(onSocketClosed()));
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this,
+            SLOT(onSocketClosed()));
+    socket->connectToHost(host, (quint16)port);
+}
+
+bool HealthProber::spawnExec(const ProcessInfo::Probe &probe, qint64 *pid,
+                             QString *error) const
+{
+    QList<QByteArray> argStorage;
+    argStorage.append(probe.command.toLocal8Bit());
+    for (int i = 0; i < probe.args.count(); ++i)
+    {
+        argStorage.append(probe.args.at(i).toLocal8Bit());
+    }
+    QVector<char *> argv;
+    for (int i = 0; i < argStorage.count(); ++i)
+    {
+        argv.append(argStorage[i].data());
+    }
+    argv.append(0);
+
+    // 探针命令的输出没有用处，全部丢弃
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+
+    pid_t child = 0;
+    int rc = posix_spawnp(&child, argv[0], &actions, 0, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (rc != 0)
+    {
+        *error = QString::fromUtf8("无法执行探测命令 %1: %2")
+                     .arg(probe.command)
+                     .arg(QString::fromLocal8Bit(strerror(rc)));
+        return false;
+    }
+    *pid = child;
+    return true;
+}
+
+void HealthProber::onSocketConnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    QString id = m_sockets.value(socket);
+    if (id.isEmpty())
+        return;
+
+    const ProcessInfo::Probe &probe = m_targets[id].probe;
+    if (probe.type == "tcp")
+    {
+        finishProbe(id, true, QString());
+        return;
+    }
+
+    // HTTP/1.0 + Connection: close，读到状态行即可判定
+    QUrl url(probe.url);
+    QString path = url.path().isEmpty() ? QString("/") : url.path();
+    if (!url.query().isEmpty())
+    {
+        path += "?" + url.query();
+    }
+    QByteArray request = QByteArray("GET ") + path.toUtf8() + " HTTP/1.0\r\n";
+    request += QByteArray("Host: ") + url.host().toUtf8() + "\r\n";
+    request += "User-Agent: ProcessManager-probe\r\n";
+    request += "Connection: close\r\n\r\n";
+    socket->write(request);
+}
+
+void HealthProber::onSocketReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    QString id = m_sockets.value(socket);
+    if (id.isEmpty())
+        return;
+
+    Target &target = m_targets[id];
+    target.response += socket->readAll();
+
+    int lineEnd = target.response.indexOf("\r\n");
+    if (lineEnd < 0)
+    {
+        if (target.response.size() > 4096)
+        {
+            finishProbe(id, false, QString::fromUtf8("HTTP响应无效"));
+        }
+        return;
+    }
+
+    // 状态行: HTTP/1.1 200 OK
+    QList<QByteArray> parts = target.response.left(lineEnd).split(' ');
+    int status = parts.count() > 1 ? parts.at(1).toInt() : 0;
+    finishProbe(id, status >= 200 && status < 400,
+                QString::fromUtf8("HTTP状态码 %1").arg(status));
+}
+
+void HealthProber::onSocketClosed()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    QString id = m_sockets.value(socket);
+    if (id.isEmpty())
+        return;
+
+    finishProbe(id, false, socket->errorString());
+}
+
+void HealthProber::finishProbe(const QString &id, bool success,
+                               const QString &reason)
+{
+    QHash<QString, Target>::iterator it = m_targets.find(id);
+    if (it == m_targets.end() || !it->inFlight)
+        return;
+
+    Target &target = it.value();
+    cancelProbe(target);
+    schedule(id, target,
+             m_clock.elapsed() + target.probe.intervalSeconds * 1000LL);
+    rearm();
+
+    if (success)
+    {
+        if (target.failures > 0)
+        {
+            emit logMessage(
+                QString::fromUtf8("[探测] 服务 %1 健康探测已恢复。").arg(id));
+        }
+        target.failures = 0;
+        return;
+    }
+
+    ++target.failures;
+    if (target.failures < target.probe.failureThreshold)
+        return;
+
+    int failures = target.failures;
+    target.failures = 0;
+    // 接收方通常会 unwatch，发射之后不能再访问 target
+    emit probeFailed(id, failures, reason);
+}
+
+void HealthProber::cancelProbe(Target &target)
+{
+    if (target.socket)
+    {
+        QTcpSocket *socket = target.socket;
+        target.socket = 0;
+        m_sockets.remove(socket);
+        // 先断开连接，abort() 发出的 disconnected 不应再回到这里
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+
+    if (target.execPid > 0)
+    {
+        // 保留在 m_execPids 中，回收时识别为过期的探针进程
+        ::kill(target.execPid, SIGKILL);
+        target.execPid = 0;
+    }
+
+    target.inFlight = false;
+}
+
+void HealthProber::schedule(const QString &id, Target &target, qint64 atMs)
+{
+    if (target.nextEventMs >= 0)
+    {
+        m_events.remove(target.nextEventMs, id);
+    }
+    target.nextEventMs = atMs;
+    m_events.insert(atMs, id);
+}
+
+void HealthProber::rearm()
+{
+    if (m_events.isEmpty())
+    {
+        m_timer->stop();
+        return;
+    }
+
+    qint64 delay = m_events.firstKey() - m_clock.elapsed();
+    m_timer->start((int)qMax((qint64)0, delay));
+}
@@ -0,0 +1,84 @@
+#ifndef HEALTHPROBER_H
+#define HEALTHPROBER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QString>
+
+#include "processinfo.h"
+
+class QTcpSocket;
+class QTimer;
+
+// 主动健康探测：HTTP GET、TCP连接和执行命令三种探针。
+// 所有探测都在所属线程的事件循环中异步进行，互不阻塞；
+// 每个服务的下一次探测或当前探测的超时都登记在同一个按时间排序的队列里，
+// 只用一个定时器驱动，服务数量增加时开销只随正在进行的探测数增长。
+// exec 探针的子进程由 ChildReaper 回收：启动后经 execSpawned() 登记，
+// 退出状态需通过 childExited() 转交。
+class HealthProber : public QObject {
+    Q_OBJECT
+
+public:
+    explicit HealthProber(QObject *parent = 0);
+    ~HealthProber();
+
+    // 开始/停止探测某个服务；重复 watch 同一服务会替换探针配置
+    void watch(const QString &id, const ProcessInfo::Probe &probe);
+    void unwatch(const QString &id);
+    bool isWatching(const QString &id) const;
+
+    // 交给探测器处理的子进程退出；不是探针进程时返回false
+    bool childExited(qint64 pid, int exitCode, int signalNumber);
+
+signals:
+    // 连续失败达到 failureThreshold，服务应被重启
+    void probeFailed(const QString &id, int failures, const QString &reason);
+    // exec 探针进程已启动，需要由子进程收割者回收
+    void execSpawned(qint64 pid);
+    void logMessage(const QString &message);
+
+private slots:
+    void onTimeout();
+    void onSocketConnected();
+    void onSocketReadyRead();
+    void onSocketClosed();
+
+private:
+    struct Target {
+        ProcessInfo::Probe probe;
+        qint64 nextEventMs;  // 下一次探测时刻，探测进行中时为超时时刻
+        int failures;        // 连续失败次数
+        bool inFlight;
+        QTcpSocket *socket;
+        QByteArray response;
+        qint64 execPid;
+
+        Target() {
+            nextEventMs = -1;
+            failures = 0;
+            inFlight = false;
+            socket = 0;
+            execPid = 0;
+        }
+    };
+
+    void startProbe(const QString &id, Target &target);
+    bool spawnExec(const ProcessInfo::Probe &probe, qint64 *pid,
+                   QString *error) const;
+    void finishProbe(const QString &id, bool success, const QString &reason);
+    void cancelProbe(Target &target);
+    void schedule(const QString &id, Target &target, qint64 atMs);
+    void rearm();
+
+    QHash<QString, Target> m_targets;
+    QMultiMap<qint64, QString> m_events;  // 时刻 -> 服务ID
+    QHash<QTcpSocket *, QString> m_sockets;
+    QHash<qint64, QString> m_execPids;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+};
+
+#endif  // HEALTHPROBER_H
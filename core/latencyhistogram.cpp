@@ -0,0 +1,104 @@
+#include "latencyhistogram.h"
+
+#include <math.h>
+
+namespace
+{
+
+const int kLinearBuckets = 64;  // 0-63 精确计数
+const int kSubBucketBits = 5;   // 之后每个2的幂区间分32个桶
+const int kSubBuckets = 1 << kSubBucketBits;
+const int kMaxBit = 40;         // 最高有效位超过它的值都计入最后一个桶
+const int kBucketCount =
+    kLinearBuckets + (kMaxBit - kSubBucketBits) * kSubBuckets;
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+{
+    m_counts.fill(0, kBucketCount);
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0.0;
+}
+
+void LatencyHistogram::record(qint64 value)
+{
+    if (value < 0)
+        value = 0;
+
+    ++m_counts[bucketOf(value)];
+    if (m_count == 0 || value < m_min)
+        m_min = value;
+    if (value > m_max)
+        m_max = value;
+    ++m_count;
+    m_sum += value;
+}
+
+void LatencyHistogram::reset()
+{
+    m_counts.fill(0);
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0.0;
+}
+
+qint64 LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (m_count == 0)
+        return 0;
+
+    quint64 target = (quint64)ceil(qBound(0.0, percentile, 100.0) / 100.0 * m_count);
+    target = qMax(target, (quint64)1);
+
+    quint64 seen = 0;
+    for (int i = 0; i < m_counts.size(); ++i)
+    {
+        seen += m_counts.at(i);
+        if (seen >= target)
+            return qBound(m_min, bucketMidpoint(i), m_max);
+    }
+    return m_max;
+}
+
+LatencySummary LatencyHistogram::summary() const
+{
+    LatencySummary summary;
+    summary.count = m_count;
+    summary.min = min();
+    summary.p50 = valueAtPercentile(50.0);
+    summary.p90 = valueAtPercentile(90.0);
+    summary.p99 = valueAtPercentile(99.0);
+    summary.max = m_max;
+    summary.mean = mean();
+    return summary;
+}
+
+int LatencyHistogram::bucketOf(qint64 value)
+{
+    if (value < kLinearBuckets)
+        return (int)value;
+
+    int bit = 63 - __builtin_clzll((unsigned long long)value);
+    if (bit > kMaxBit)
+        return kBucketCount - 1;
+
+    // 取最高位之后的5位作为区间内的序号
+    int sub = (int)(value >> (bit - kSubBucketBits)) - kSubBuckets;
+    return kLinearBuckets + (bit - kSubBucketBits - 1) * kSubBuckets + sub;
+}
+
+qint64 LatencyHistogram::bucketMidpoint(int index)
+{
+    if (index < kLinearBuckets)
+        return index;
+
+    int octave = (index - kLinearBuckets) / kSubBuckets;
+    int sub = (index - kLinearBuckets) % kSubBuckets;
+    int shift = octave + 1;
+    qint64 lower = (qint64)(kSubBuckets + sub) << shift;
+    return lower + ((qint64)1 << shift) / 2;
+}
@@ -0,0 +1,61 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QMetaType>
+#include <QVector>
+
+// 直方图的摘要，跨线程传给界面显示
+struct LatencySummary {
+    quint64 count;
+    qint64 min;
+    qint64 p50;
+    qint64 p90;
+    qint64 p99;
+    qint64 max;
+    double mean;
+
+    LatencySummary() {
+        count = 0;
+        min = 0;
+        p50 = 0;
+        p90 = 0;
+        p99 = 0;
+        max = 0;
+        mean = 0.0;
+    }
+};
+
+// HDR 风格的对数-线性直方图，用于后台给自己的热点路径计时。
+// 0-63 每个值一个桶；之后每个2的幂区间等分为32个桶，相对误差约3%。
+// 记录一个值只需一次位扫描和一次数组自增，不分配内存；
+// 单位由调用方决定(微秒、次数等)，超过 2^41 的值计入最后一个桶。
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(qint64 value);
+    void reset();
+
+    quint64 count() const { return m_count; }
+    qint64 min() const { return m_count ? m_min : 0; }
+    qint64 max() const { return m_max; }
+    double mean() const { return m_count ? m_sum / m_count : 0.0; }
+
+    // percentile 取 0-100，返回所在桶的中点(不超出实际的最小/最大值)
+    qint64 valueAtPercentile(double percentile) const;
+    LatencySummary summary() const;
+
+private:
+    static int bucketOf(qint64 value);
+    static qint64 bucketMidpoint(int index);
+
+    QVector<quint32> m_counts;
+    quint64 m_count;
+    qint64 m_min;
+    qint64 m_max;
+    double m_sum;
+};
+
+Q_DECLARE_METATYPE(LatencySummary)
+
+#endif  // LATENCYHISTOGRAM_H
@@ -0,0 +1,107 @@
+#include "leaktrend.h"
+
+#include <cmath>
+
+namespace
+{
+
+const int kMinSamples = 30;
+
+}  // namespace
+
+LeakTrend::LeakTrend(double windowSeconds)
+{
+    m_tauHours = qMax(60.0, windowSeconds) / 3600.0;
+    m_firstMs = -1;
+    m_lastMs = -1;
+    m_samples = 0;
+    m_w = 0.0;
+    m_wx = 0.0;
+    m_wy = 0.0;
+    m_wxx = 0.0;
+    m_wxy = 0.0;
+    m_wyy = 0.0;
+}
+
+void LeakTrend::addSample(qint64 timeMs, double valueMB)
+{
+    if (m_lastMs >= 0)
+    {
+        double dtHours = qMax((qint64)0, timeMs - m_lastMs) / 3600000.0;
+
+        // 原点平移到新样本: x' = x - dt
+        m_wxx += -2.0 * dtHours * m_wx + dtHours * dtHours * m_w;
+        m_wxy -= dtHours * m_wy;
+        m_wx -= dtHours * m_w;
+
+        double decay = std::exp(-dtHours / m_tauHours);
+        m_w *= decay;
+        m_wx *= decay;
+        m_wy *= decay;
+        m_wxx *= decay;
+        m_wxy *= decay;
+        m_wyy *= decay;
+    }
+    else
+    {
+        m_firstMs = timeMs;
+    }
+
+    // 新样本位于 x = 0
+    m_w += 1.0;
+    m_wy += valueMB;
+    m_wyy += valueMB * valueMB;
+
+    m_lastMs = timeMs;
+    ++m_samples;
+}
+
+bool LeakTrend::hasFit() const
+{
+    // 至少覆盖四分之一个时间常数，否则短时波动会被当成趋势
+    return m_samples >= kMinSamples &&
+           (m_lastMs - m_firstMs) >= (qint64)(m_tauHours * 3600000.0 / 4);
+}
+
+double LeakTrend::slopePerHour() const
+{
+    double denominator = m_w * m_wxx - m_wx * m_wx;
+    if (denominator <= 0.0)
+        return 0.0;
+    return (m_w * m_wxy - m_wx * m_wy) / denominator;
+}
+
+double LeakTrend::fittedValue() const
+{
+    if (m_w <= 0.0)
+        return 0.0;
+    // 截距即 x = 0 (最近样本) 处的拟合值
+    return (m_wy - slopePerHour() * m_wx) / m_w;
+}
+
+double LeakTrend::rSquared() const
+{
+    if (m_w <= 0.0)
+        return 0.0;
+
+    double meanX = m_wx / m_w;
+    double meanY = m_wy / m_w;
+    double varX = m_wxx / m_w - meanX * meanX;
+    double varY = m_wyy / m_w - meanY * meanY;
+    double cov = m_wxy / m_w - meanX * meanY;
+    if (varX <= 0.0 || varY <= 0.0)
+        return 0.0;
+    return qMin(1.0, cov * cov / (varX * varY));
+}
+
+qint64 LeakTrend::secondsUntil(double thresholdMB) const
+{
+    double slope = slopePerHour();
+    if (slope <= 0.0)
+        return -1;
+
+    double remaining = thresholdMB - fittedValue();
+    if (remaining <= 0.0)
+        return 0;
+    return (qint64)(remaining / slope * 3600.0);
+}
@@ -0,0 +1,40 @@
+#ifndef LEAKTREND_H
+#define LEAKTREND_H
+
+#include <QtGlobal>
+
+// 内存增长趋势的在线线性回归，每个服务只保存几个累加量(O(1)内存)。
+// 旧样本按时间常数 windowSeconds 指数衰减，趋势跟随最近的行为；
+// 每加入一个样本都把时间原点平移到该样本，避免长时间运行后的数值抵消。
+class LeakTrend {
+public:
+    explicit LeakTrend(double windowSeconds = 3600.0);
+
+    void addSample(qint64 timeMs, double valueMB);
+
+    // 样本数量和覆盖时长是否足以给出可信的趋势
+    bool hasFit() const;
+
+    double slopePerHour() const;   // MB/小时
+    double fittedValue() const;    // 回归直线在最近一个样本处的值(MB)
+    double rSquared() const;       // 拟合优度, 0~1
+
+    // 按当前趋势到达 thresholdMB 还需多少秒；不在增长时返回-1
+    qint64 secondsUntil(double thresholdMB) const;
+
+private:
+    double m_tauHours;
+    qint64 m_firstMs;
+    qint64 m_lastMs;
+    int m_samples;
+
+    // 加权累加量，x 为相对最近样本的小时数(<=0)
+    double m_w;
+    double m_wx;
+    double m_wy;
+    double m_wxx;
+    double m_wxy;
+    double m_wyy;
+};
+
+#endif  // LEAKTREND_H
@@ -0,0 +1,46 @@
+#include "lifecycletimings.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+LifecycleTimings::LifecycleTimings()
+{
+    for (int i = 0; i < PhaseCount; ++i)
+        m_counts[i] = 0;
+}
+
+void LifecycleTimings::record(Phase phase, qint64 ms)
+{
+    quint32 value = (quint32)qBound((qint64)0, ms, (qint64)0xffffffffLL);
+    QVector<quint32> &samples = m_samples[phase];
+    if (samples.size() < kWindow)
+        samples.append(value);
+    else
+        samples[(int)(m_counts[phase] % kWindow)] = value;
+    ++m_counts[phase];
+}
+
+LatencySummary LifecycleTimings::summary(Phase phase) const
+{
+    LatencySummary summary;
+    summary.count = m_counts[phase];
+    if (m_samples[phase].isEmpty())
+        return summary;
+
+    QVector<quint32> sorted = m_samples[phase];
+    std::sort(sorted.begin(), sorted.end());
+
+    // 最近邻秩法：第 ceil(p% * n) 个样本
+    int n = sorted.size();
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i)
+        sum += sorted.at(i);
+    summary.min = sorted.first();
+    summary.max = sorted.last();
+    summary.p50 = sorted.at(qMax(0, (int)ceil(0.50 * n) - 1));
+    summary.p90 = sorted.at(qMax(0, (int)ceil(0.90 * n) - 1));
+    summary.p99 = sorted.at(qMax(0, (int)ceil(0.99 * n) - 1));
+    summary.mean = sum / n;
+    return summary;
+}
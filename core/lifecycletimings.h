@@ -0,0 +1,37 @@
+#ifndef LIFECYCLETIMINGS_H
+#define LIFECYCLETIMINGS_H
+
+#include <QVector>
+
+#include "latencyhistogram.h"
+
+// 单个服务生命周期各阶段的耗时(毫秒)，跨重启累计。
+// 启停很少发生，每个阶段只保留最近 kWindow 次的样本，分位数按样本精确计算；
+// 上万个服务时给每个服务配完整的 LatencyHistogram 太占内存。
+// 从未记录过的阶段不分配内存。
+class LifecycleTimings {
+public:
+    enum Phase {
+        Launch,     // 请求启动 -> exec 成功
+        FirstSeen,  // 请求启动 -> 第一次观察到进程存活
+        Ready,      // 请求启动 -> 就绪(进入 Running)
+        Stop,       // 发出停止信号 -> 观察到进程退出
+        Recovery,   // 意外退出 -> 自动重启后再次就绪
+        PhaseCount
+    };
+
+    static const int kWindow = 32;
+
+    LifecycleTimings();
+
+    void record(Phase phase, qint64 ms);
+
+    // count 为累计次数，其余统计量只针对最近 kWindow 次
+    LatencySummary summary(Phase phase) const;
+
+private:
+    QVector<quint32> m_samples[PhaseCount];  // 写满后按环形覆盖
+    quint64 m_counts[PhaseCount];
+};
+
+#endif  // LIFECYCLETIMINGS_H
@@ -0,0 +1,155 @@
+#include "listeningsockets.h"
+
+#include <QFile>
+
+#include <dirent.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+ListeningSockets::ListeningSockets()
+{
+    m_fresh = false;
+    setRoot("/proc");
+}
+
+void ListeningSockets::setRoot(const QString &root)
+{
+    m_root = root;
+    m_rootLocal = QFile::encodeName(root);
+    m_tcp = Table();
+    m_tcp6 = Table();
+    m_fresh = false;
+}
+
+bool ListeningSockets::isListening(qint64 pid, quint16 port)
+{
+    if (pid <= 0 || port == 0)
+        return false;
+
+    refresh();
+
+    QList<quint64> inodes = m_tcp.ports.value(port);
+    inodes += m_tcp6.ports.value(port);
+    if (inodes.isEmpty())
+        return false;  // 没有任何进程在该端口监听，无需扫描fd
+
+    return processOwnsInode(pid, inodes);
+}
+
+void ListeningSockets::refresh()
+{
+    if (m_fresh)
+        return;
+
+    refreshTable(m_root + "/net/tcp", m_tcp);
+    refreshTable(m_root + "/net/tcp6", m_tcp6);
+    m_fresh = true;
+}
+
+void ListeningSockets::refreshTable(const QString &path, Table &table)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        table.raw.clear();
+        table.ports.clear();
+        return;
+    }
+    QByteArray raw = file.readAll();
+    file.close();
+
+    if (raw == table.raw)
+        return;
+
+    table.raw = raw;
+    table.ports.clear();
+
+    // 行格式:
+    //   sl  local_address rem_address   st tx_queue:rx_queue tr:tm->when retrnsmt uid timeout inode
+    //   0: 00000000:1F90 00000000:0000 0A 00000000:00000000 00:00000000 00000000 1000 0 123456 ...
+    const char *data = raw.constData();
+    int length = raw.size();
+    int lineStart = raw.indexOf('\n') + 1;  // 跳过表头
+    while (lineStart > 0 && lineStart < length)
+    {
+        int lineEnd = raw.indexOf('\n', lineStart);
+        if (lineEnd < 0)
+            lineEnd = length;
+
+        // 按空白切分，只取需要的字段: 1=local_address 3=st 9=inode
+        const char *fields[10];
+        int fieldLengths[10];
+        int fieldCount = 0;
+        int pos = lineStart;
+        while (pos < lineEnd && fieldCount < 10)
+        {
+            while (pos < lineEnd && data[pos] == ' ')
+                ++pos;
+            if (pos >= lineEnd)
+                break;
+            int start = pos;
+            while (pos < lineEnd && data[pos] != ' ')
+                ++pos;
+            fields[fieldCount] = data + start;
+            fieldLengths[fieldCount] = pos - start;
+            ++fieldCount;
+        }
+
+        if (fieldCount == 10 && fieldLengths[3] == 2 &&
+            fields[3][0] == '0' && fields[3][1] == 'A')
+        {
+            QByteArray local(fields[1], fieldLengths[1]);
+            int colon = local.lastIndexOf(':');
+            bool portOk = false;
+            bool inodeOk = false;
+            quint16 port = (quint16)local.mid(colon + 1).toUInt(&portOk, 16);
+            quint64 inode =
+                QByteArray(fields[9], fieldLengths[9]).toULongLong(&inodeOk);
+            if (colon > 0 && portOk && inodeOk && inode != 0)
+            {
+                table.ports[port].append(inode);
+            }
+        }
+
+        lineStart = lineEnd + 1;
+    }
+}
+
+bool ListeningSockets::processOwnsInode(qint64 pid,
+                                        const QList<quint64> &inodes) const
+{
+    char dirPath[PATH_MAX];
+    snprintf(dirPath, sizeof(dirPath), "%s/%lld/fd", m_rootLocal.constData(),
+             (long long)pid);
+    DIR *dir = opendir(dirPath);
+    if (!dir)
+        return false;
+
+    bool found = false;
+    char linkPath[PATH_MAX];
+    char target[64];
+    struct dirent *entry;
+    while (!found && (entry = readdir(dir)) != 0)
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        snprintf(linkPath, sizeof(linkPath), "%s/%s", dirPath, entry->d_name);
+        ssize_t n = readlink(linkPath, target, sizeof(target) - 1);
+        if (n <= 0)
+            continue;
+        target[n] = '\0';
+
+        // socket:[123456]
+        if (strncmp(target, "socket:[", 8) != 0)
+            continue;
+        quint64 inode = strtoull(target + 8, 0, 10);
+        found = inodes.contains(inode);
+    }
+
+    closedir(dir);
+    return found;
+}
@@ -0,0 +1,43 @@
+#ifndef LISTENINGSOCKETS_H
+#define LISTENINGSOCKETS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+// 判断进程是否已在某个TCP端口上监听。
+// 先在 /proc/net/tcp 与 /proc/net/tcp6 中找出该端口上处于LISTEN状态的socket inode，
+// 再与 /proc/<pid>/fd 中的 socket:[inode] 比对，因此不会把别的进程占用的端口误判为就绪。
+// 两张表在一个检查周期内只读取一次；内容与上次相同时沿用上次的解析结果，
+// 只有表发生变化时才重新解析，且只解析LISTEN行。
+class ListeningSockets {
+public:
+    ListeningSockets();
+
+    // /proc 的根目录，见 ProcFs
+    void setRoot(const QString &root);
+
+    // 开始新的检查周期，下一次查询会重新读取 /proc/net
+    void invalidate() { m_fresh = false; }
+
+    bool isListening(qint64 pid, quint16 port);
+
+private:
+    struct Table {
+        QByteArray raw;                       // 上次解析的原始内容
+        QHash<quint16, QList<quint64> > ports;  // 端口 -> LISTEN socket inode
+    };
+
+    void refresh();
+    static void refreshTable(const QString &path, Table &table);
+    bool processOwnsInode(qint64 pid, const QList<quint64> &inodes) const;
+
+    QString m_root;
+    QByteArray m_rootLocal;
+    Table m_tcp;
+    Table m_tcp6;
+    bool m_fresh;
+};
+
+#endif  // LISTENINGSOCKETS_H
@@ -0,0 +1,52 @@
+#include "pidfile.h"
+
+#include <QFile>
+#include <QList>
+#include <QSaveFile>
+
+bool PidFile::read(const QString &path, ProcessIdentity *identity)
+{
+    *identity = ProcessIdentity();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QList<QByteArray> lines = file.readAll().split('\n');
+    file.close();
+
+    identity->pid = qMax(lines.at(0).trimmed().toLongLong(), (qint64)0);
+    if (identity->pid > 0 && lines.count() > 1)
+    {
+        QList<QByteArray> fields = lines.at(1).simplified().split(' ');
+        if (fields.count() == 2)
+        {
+            identity->startTime = fields.at(0).toULongLong();
+            identity->cmdlineHash = fields.at(1).toUInt(0, 16);
+        }
+    }
+    return true;
+}
+
+bool PidFile::write(const QString &path, const ProcessIdentity &identity,
+                    QString *error)
+{
+    QByteArray content = QByteArray::number(identity.pid);
+    content += '\n';
+    if (identity.startTime > 0)
+    {
+        content += QByteArray::number(identity.startTime);
+        content += ' ';
+        content += QByteArray::number(identity.cmdlineHash, 16);
+        content += '\n';
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(content) != content.size() || !file.commit())
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
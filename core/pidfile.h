@@ -0,0 +1,21 @@
+#ifndef PIDFILE_H
+#define PIDFILE_H
+
+#include <QString>
+
+#include "procfs.h"
+
+// 服务的PID文件。
+// 第一行是PID，外部脚本用 `head -n1` 或 `read pid <` 读取的结果与旧格式相同；
+// 第二行是 "<starttime> <命令行哈希>"，用于确认该PID仍是当初启动的那个进程。
+// 只有一行的旧格式仍可读取，此时 startTime 和 cmdlineHash 为0。
+class PidFile {
+public:
+    // 文件不存在或无法读取时返回false；内容无效时返回true但 identity->pid 为0
+    static bool read(const QString &path, ProcessIdentity *identity);
+    // 先写临时文件再改名，监控周期不会读到写了一半的内容
+    static bool write(const QString &path, const ProcessIdentity &identity,
+                      QString *error);
+};
+
+#endif  // PIDFILE_H
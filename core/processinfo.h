@@ -3,6 +3,9 @@
 #include <QString>
 #include <QStringList>
 
+#include "latencyhistogram.h"
+#include "processstate.h"
+
 struct ProcessInfo {
     // 来自配置文件的静态信息
     QString id;    // 唯一标识符, e.g., "user-center-api"
@@ -14,41 +17,212 @@ struct ProcessInfo {
     QString pidFile;
 
     struct Schedule {
-        QString type;    // "daily", "weekly", "monthly"
+        QString type;    // "daily", "weekly", "monthly", "cron"
+        QString expression;  // type为"cron"时的表达式, e.g. "*/15 9-17 * * 1-5"
         int dayOfWeek;   // 1=周一, ..., 7=周日
         int dayOfMonth;  // 1-31
         int hour;        // 0-23
         int minute;      // 0-59
 
+        QString concurrencyGroup;  // 并发组，同组任务共享组内并发上限
+        int jitterSeconds;         // 到期后随机延后 0~N 秒再排队，分散负载
+
+        // 管理器停机/系统挂起期间错过的执行如何补跑:
+        // "skip"(默认,不补跑), "run-once"(只补跑一次),
+        // "run-all-bounded"(逐次补跑,最多catchUpLimit次)；旧名 "once"/"all" 仍可用
+        QString catchUp;
+        int catchUpLimit;
+
         Schedule() {
             dayOfWeek = 0;
             dayOfMonth = 0;
             hour = -1;
             minute = -1;
+            jitterSeconds = 0;
+            catchUp = "skip";
+            catchUpLimit = 10;
+        }
+    };
+
+    // 资源硬限制：启动时在子进程中由内核强制执行，0/空 表示不限制
+    struct ResourceLimits {
+        qint64 addressSpaceMB;  // RLIMIT_AS (MB)
+        qint64 openFiles;       // RLIMIT_NOFILE
+        QString cpuMax;         // cgroup cpu.max, e.g. "50000 100000"
+        qint64 memoryMaxMB;     // cgroup memory.max (MB)
+        QStringList ioMax;      // cgroup io.max, e.g. "8:0 rbps=10485760"
+
+        ResourceLimits() {
+            addressSpaceMB = 0;
+            openFiles = 0;
+            memoryMaxMB = 0;
+        }
+
+        // 是否需要为该服务创建独立的cgroup
+        bool needsCgroup() const {
+            return !cpuMax.isEmpty() || memoryMaxMB > 0 || !ioMax.isEmpty();
+        }
+    };
+
+    // 调度与内存放置参数：同样在子进程exec之前应用，失败时只记录警告
+    struct Tuning {
+        QString cpuAffinity;  // CPU列表, e.g. "0-3,8"
+        int numaNode;         // 绑定的NUMA节点, -1 = 不绑定
+        bool niceSet;
+        int nice;             // -20 ~ 19
+        QString ioClass;      // "realtime", "best-effort", "idle"
+        int ioPriority;       // 0(最高) ~ 7(最低), idle类忽略
+        QString transparentHugePages;  // "never" 禁用THP, 空 = 系统默认
+        qint64 memlockMB;     // RLIMIT_MEMLOCK (MB), -1 = 不修改
+
+        Tuning() {
+            numaNode = -1;
+            niceSet = false;
+            nice = 0;
+            ioPriority = 4;
+            memlockMB = -1;
+        }
+    };
+
+    // autoStart 服务意外退出后的重启策略：指数退避 + 抖动，频繁崩溃时隔离
+    struct RestartPolicy {
+        int initialDelayMs;      // 第一次重启前的等待
+        int maxDelayMs;          // 退避上限
+        double multiplier;       // 每次失败后等待时间的倍数
+        double jitter;           // 随机抖动比例, 0.2 = ±20%
+        int crashLoopCount;      // 窗口内失败达到该次数即隔离, 0 = 不隔离
+        int crashLoopWindowSec;
+        int resetAfterSec;       // 稳定运行超过该时长后退避清零
+
+        RestartPolicy() {
+            initialDelayMs = 1000;
+            maxDelayMs = 5 * 60 * 1000;
+            multiplier = 2.0;
+            jitter = 0.2;
+            crashLoopCount = 5;
+            crashLoopWindowSec = 120;
+            resetAfterSec = 300;
+        }
+    };
+
+    // 健康检查的判定方式，CPU与内存各一份；阈值仍为 maxCpu / maxMem
+    struct HealthWindow {
+        // 配置中写作 "duration"(默认), "ewma", "percentile"，解析时转换
+        enum Evaluator { Duration, Ewma, Percentile };
+
+        Evaluator evaluator;
+        int windowSeconds;  // ewma的时间常数 / percentile的窗口长度
+        double percentile;  // 0-100
+        int forSeconds;     // duration: 连续超标多久才判定
+
+        HealthWindow() {
+            evaluator = Duration;
+            windowSeconds = 60;
+            percentile = 95.0;
+            forSeconds = 4;  // 2秒监控周期下相当于连续3次超标
+        }
+    };
+
+    // 主动健康探测：连续失败 failureThreshold 次即按健康检查超标处理(重启)
+    struct Probe {
+        QString type;        // "http", "tcp", "exec"；空 = 不探测
+        QString url;         // http, e.g. "http://127.0.0.1:8080/health"
+        QString host;        // tcp
+        int port;            // tcp
+        QString command;     // exec, 退出码0为健康
+        QStringList args;
+        int intervalSeconds;
+        int timeoutMs;
+        int failureThreshold;
+        int initialDelaySeconds;  // 服务启动后等待多久开始探测
+
+        Probe() {
+            port = 0;
+            intervalSeconds = 10;
+            timeoutMs = 2000;
+            failureThreshold = 3;
+            initialDelaySeconds = 15;
+        }
+
+        bool isEnabled() const { return !type.isEmpty(); }
+    };
+
+    // 就绪条件：配置了端口时，进程在该端口监听之后才由 Starting 变为 Running
+    struct Readiness {
+        int port;            // 0 = 进程存在即就绪
+        int timeoutSeconds;  // 超时仍未监听时记录警告并视为已就绪
+
+        Readiness() {
+            port = 0;
+            timeoutSeconds = 120;
+        }
+
+        bool isEnabled() const { return port > 0; }
+    };
+
+    // 内存泄漏趋势检测：按RSS增长趋势预测到达阈值的时间，提前告警/在空闲时段重启
+    struct LeakDetection {
+        bool enabled;
+        double thresholdMB;        // 0 = 使用 maxMem，其次 limits.memoryMaxMB
+        int windowMinutes;         // 趋势回归的时间常数
+        double warnHours;          // 预计在该时长内到达阈值时告警
+        QString restartWindow;     // 空闲时段, e.g. "02:00-04:00"；空 = 只告警
+        double restartWithinHours; // 预计在该时长内到达阈值时安排重启
+
+        LeakDetection() {
+            enabled = false;
+            thresholdMB = 0.0;
+            windowMinutes = 60;
+            warnHours = 24.0;
+            restartWithinHours = 48.0;
         }
     };
 
     bool autoStart;  // 是否自启
+    RestartPolicy restart;
 
     Schedule schedule;  // 【新增schedule成员】
 
-    // 由后端实时更新的动态信息
-    QString status;  // 状态: "Running", "Stopped", "Error", "Starting..." etc.
+    ResourceLimits limits;
+    Tuning tuning;
+
+    // 停止方式：先发送 stopSignal，超过 stopTimeoutSec 仍未退出则 SIGKILL
+    int stopSignal;         // 默认 15 (SIGTERM)
+    int stopTimeoutSec;     // 默认 10 秒
+    QStringList dependsOn;  // 依赖的服务ID；全部停止时本服务先于它们停止
+    QString group;          // 所属分组，空 = 不分组；可按分组批量启停并汇总指标
+
+    // 动态信息：后端实时数据保存在 RuntimeTable 中，这里是发给界面时的快照
+    ProcessState::State state;  // 生命周期状态，只由 BackendWorker::setState 修改
+    qint64 stateSinceMs;        // 进入当前状态的时刻(墙钟, ms)；0 = 未知
     qint64  pid;        // 进程ID (-1 if not running)
     double cpuUsage;  // CPU使用率 (%)
     double memUsage;  // 内存使用量 (MB)
+    int restartCount;  // 本次管理器运行以来的自动重启次数
+    LatencySummary startLatency;  // 请求启动到就绪(ms)，最近若干次
+    LatencySummary stopLatency;   // 发出停止信号到退出(ms)，最近若干次
+    QString host;  // 联合视图中所属的远程主机；本机的服务为空
 
     bool healthCheckEnabled;  // 是否启用健康检查
     double maxCpu;            // CPU使用率阈值 (%)
     double maxMem;            // 内存使用量阈值 (MB)
+    HealthWindow cpuWindow;
+    HealthWindow memWindow;
+    Probe probe;
+    Readiness readiness;
+    LeakDetection leakDetection;
 
     // C++98兼容的构造函数，用于初始化默认值
     ProcessInfo() {
         autoStart = false;
+        stopSignal = 15;
+        stopTimeoutSec = 10;
         pid = 0;
         cpuUsage = 0.0;
         memUsage = 0.0;
-        status = "Stopped";
+        restartCount = 0;
+        state = ProcessState::Stopped;
+        stateSinceMs = 0;
 
         // 初始化健康检查默认值
         healthCheckEnabled = false;
@@ -0,0 +1,588 @@
+#include "processlauncher.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sched.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QVector>
+
+#ifndef PR_SET_THP_DISABLE
+#define PR_SET_THP_DISABLE 41
+#endif
+
+namespace
+{
+
+const char *const kCgroupRoot = "/sys/fs/cgroup";
+const char *const kCgroupBase = "/sys/fs/cgroup/proc-manager";
+
+// 不依赖libnuma：直接使用set_mempolicy/ioprio_set系统调用
+const int kMpolBind = 2;
+const int kIoprioWhoProcess = 1;
+const int kIoprioClassShift = 13;
+const int kMaxNumaNodes = 1024;
+const int kNodeMaskWords = kMaxNumaNodes / (8 * sizeof(unsigned long));
+
+// 子进程通过CLOEXEC管道回报给父进程的消息
+struct LaunchReport
+{
+    int kind;   // ReportPid / ReportError
+    int stage;  // 出错阶段
+    int error;  // errno
+    qint64 pid;
+};
+
+enum
+{
+    ReportPid = 1,
+    ReportError = 2,
+    ReportWarning = 3  // 调优参数应用失败，不影响启动
+};
+
+enum
+{
+    StageFork = 1,
+    StageCgroup,
+    StageRlimit,
+    StageChdir,
+    StageExec,
+    StageAffinity,
+    StageNuma,
+    StageNice,
+    StageIoPriority,
+    StageThp,
+    StageMemlock
+};
+
+// fork之后只能调用异步信号安全的函数：不分配内存、不加锁
+void writeReport(int fd, int kind, int stage, int error, qint64 pid)
+{
+    LaunchReport report;
+    memset(&report, 0, sizeof(report));
+    report.kind = kind;
+    report.stage = stage;
+    report.error = error;
+    report.pid = pid;
+
+    ssize_t n;
+    do
+    {
+        n = ::write(fd, &report, sizeof(report));
+    } while (n < 0 && errno == EINTR);
+}
+
+int formatPid(char *buf, int size, long value)
+{
+    char tmp[32];
+    int len = 0;
+    do
+    {
+        tmp[len++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0 && len < (int)sizeof(tmp));
+
+    int i = 0;
+    for (; i < len && i < size; ++i)
+    {
+        buf[i] = tmp[len - 1 - i];
+    }
+    return i;
+}
+
+bool readReport(int fd, LaunchReport *report)
+{
+    char *p = reinterpret_cast<char *>(report);
+    size_t got = 0;
+    while (got < sizeof(LaunchReport))
+    {
+        ssize_t n = ::read(fd, p + got, sizeof(LaunchReport) - got);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        got += n;
+    }
+    return true;
+}
+
+QString stageName(int stage)
+{
+    switch (stage)
+    {
+        case StageFork:
+            return QString::fromUtf8("fork");
+        case StageCgroup:
+            return QString::fromUtf8("加入cgroup");
+        case StageRlimit:
+            return QString::fromUtf8("设置rlimit");
+        case StageChdir:
+            return QString::fromUtf8("切换工作目录");
+        case StageExec:
+            return QString::fromUtf8("exec");
+        case StageAffinity:
+            return QString::fromUtf8("设置CPU亲和性");
+        case StageNuma:
+            return QString::fromUtf8("绑定NUMA节点");
+        case StageNice:
+            return QString::fromUtf8("设置nice");
+        case StageIoPriority:
+            return QString::fromUtf8("设置ionice");
+        case StageThp:
+            return QString::fromUtf8("禁用透明大页");
+        case StageMemlock:
+            return QString::fromUtf8("设置memlock");
+        default:
+            return QString::fromUtf8("未知阶段");
+    }
+}
+
+// cgroup控制文件必须不经缓冲直接写入，内核在write()时就会返回校验错误
+bool writeControlFile(const QString &path, const QByteArray &value)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Unbuffered))
+        return false;
+    bool ok = (file.write(value) == value.size());
+    file.close();
+    return ok;
+}
+
+bool enableController(const QString &groupDir, const QString &controller)
+{
+    QFile control(groupDir + "/cgroup.subtree_control");
+    if (control.open(QIODevice::ReadOnly))
+    {
+        QList<QByteArray> enabled = control.readAll().trimmed().split(' ');
+        control.close();
+        if (enabled.contains(controller.toLatin1()))
+            return true;
+    }
+    return writeControlFile(groupDir + "/cgroup.subtree_control",
+                            QByteArray("+") + controller.toLatin1());
+}
+
+// 解析 "0-3,8,10-11" 形式的CPU列表
+bool parseCpuList(const QString &text, cpu_set_t *set)
+{
+    CPU_ZERO(set);
+    QStringList parts = text.split(',', QString::SkipEmptyParts);
+    if (parts.isEmpty())
+        return false;
+
+    for (int i = 0; i < parts.count(); ++i)
+    {
+        QString part = parts.at(i).trimmed();
+        bool okFirst = false, okLast = true;
+        int first = part.section('-', 0, 0).toInt(&okFirst);
+        int last = first;
+        if (part.contains('-'))
+        {
+            last = part.section('-', 1, 1).toInt(&okLast);
+        }
+        if (!okFirst || !okLast || first < 0 || last < first ||
+            last >= CPU_SETSIZE)
+        {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+            CPU_SET(cpu, set);
+        }
+    }
+    return true;
+}
+
+int ioClassValue(const QString &name)
+{
+    if (name == "realtime")
+        return 1;
+    if (name == "best-effort")
+        return 2;
+    if (name == "idle")
+        return 3;
+    return 0;
+}
+
+}  // namespace
+
+QString ProcessLauncher::cgroupPathFor(const QString &id)
+{
+    QString name = id;
+    name.replace('/', '_');
+    return QString(kCgroupBase) + "/" + name;
+}
+
+QString ProcessLauncher::prepareCgroup(const ProcessInfo &info,
+                                       QStringList *warnings)
+{
+    if (!QFile::exists(QString(kCgroupRoot) + "/cgroup.controllers"))
+    {
+        warnings->append(
+            QString::fromUtf8("cgroup v2 不可用，服务 %1 的 "
+                              "cpu.max/memory.max/io.max 限制已跳过。")
+                .arg(info.id));
+        return QString();
+    }
+
+    QDir base(kCgroupBase);
+    if (!base.exists() && !base.mkpath("."))
+    {
+        warnings->append(
+            QString::fromUtf8("无法创建cgroup目录 %1，cgroup限制已跳过。")
+                .arg(kCgroupBase));
+        return QString();
+    }
+
+    // 逐个开启控制器：某个控制器不可用时不影响其余限制
+    QStringList controllers;
+    if (!info.limits.cpuMax.isEmpty())
+        controllers << "cpu";
+    if (info.limits.memoryMaxMB > 0)
+        controllers << "memory";
+    if (!info.limits.ioMax.isEmpty())
+        controllers << "io";
+
+    for (int i = 0; i < controllers.count(); ++i)
+    {
+        if (!enableController(kCgroupRoot, controllers.at(i)) ||
+            !enableController(kCgroupBase, controllers.at(i)))
+        {
+            warnings->append(
+                QString::fromUtf8("cgroup控制器 %1 无法启用。")
+                    .arg(controllers.at(i)));
+        }
+    }
+
+    QString path = cgroupPathFor(info.id);
+    if (!QDir(path).exists() && !QDir().mkpath(path))
+    {
+        warnings->append(
+            QString::fromUtf8("无法创建cgroup %1，cgroup限制已跳过。")
+                .arg(path));
+        return QString();
+    }
+
+    if (!info.limits.cpuMax.isEmpty() &&
+        !writeControlFile(path + "/cpu.max", info.limits.cpuMax.toLatin1()))
+    {
+        warnings->append(QString::fromUtf8("写入 %1/cpu.max 失败 (值: %2)。")
+                             .arg(path)
+                             .arg(info.limits.cpuMax));
+    }
+    if (info.limits.memoryMaxMB > 0 &&
+        !writeControlFile(path + "/memory.max",
+                          QByteArray::number(info.limits.memoryMaxMB *
+                                             1024 * 1024)))
+    {
+        warnings->append(
+            QString::fromUtf8("写入 %1/memory.max 失败。").arg(path));
+    }
+    for (int i = 0; i < info.limits.ioMax.count(); ++i)
+    {
+        if (!writeControlFile(path + "/io.max",
+                              info.limits.ioMax.at(i).toLatin1()))
+        {
+            warnings->append(
+                QString::fromUtf8("写入 %1/io.max 失败 (值: %2)。")
+                    .arg(path)
+                    .arg(info.limits.ioMax.at(i)));
+        }
+    }
+
+    return path + "/cgroup.procs";
+}
+
+void ProcessLauncher::releaseCgroup(const QString &id)
+{
+    QString path = cgroupPathFor(id);
+    if (QDir(path).exists())
+    {
+        QDir().rmdir(path);
+    }
+}
+
+bool ProcessLauncher::startDetached(const ProcessInfo &info, qint64 *pid,
+                                    QString *errorMessage,
+                                    QStringList *warnings)
+{
+    // --- 1. fork之前准备好子进程需要的全部数据，子进程中不再分配内存 ---
+    QVector<QByteArray> argStorage;
+    argStorage.append(QFile::encodeName(info.command));
+    for (int i = 0; i < info.args.count(); ++i)
+    {
+        argStorage.append(info.args.at(i).toLocal8Bit());
+    }
+    QVector<char *> argv;
+    for (int i = 0; i < argStorage.count(); ++i)
+    {
+        argv.append(argStorage[i].data());
+    }
+    argv.append(0);
+    char **argvData = argv.data();
+
+    QByteArray workingDir = QFile::encodeName(info.workingDir);
+
+    QByteArray cgroupProcs;
+    if (info.limits.needsCgroup())
+    {
+        cgroupProcs = QFile::encodeName(prepareCgroup(info, warnings));
+    }
+
+    bool limitAddressSpace = info.limits.addressSpaceMB > 0;
+    struct rlimit addressSpace;
+    addressSpace.rlim_cur = addressSpace.rlim_max =
+        (rlim_t)info.limits.addressSpaceMB * 1024 * 1024;
+
+    bool limitOpenFiles = info.limits.openFiles > 0;
+    struct rlimit openFiles;
+    openFiles.rlim_cur = openFiles.rlim_max = (rlim_t)info.limits.openFiles;
+
+    // 调优参数：在父进程中完成解析与校验
+    const ProcessInfo::Tuning &tuning = info.tuning;
+
+    bool setAffinity = false;
+    cpu_set_t affinity;
+    CPU_ZERO(&affinity);
+    if (!tuning.cpuAffinity.isEmpty())
+    {
+        setAffinity = parseCpuList(tuning.cpuAffinity, &affinity);
+        if (!setAffinity)
+        {
+            warnings->append(QString::fromUtf8("服务 %1 的CPU列表 '%2' 无效，已忽略。")
+                                 .arg(info.id)
+                                 .arg(tuning.cpuAffinity));
+        }
+    }
+
+    bool bindNuma = false;
+    unsigned long nodeMask[kNodeMaskWords];
+    memset(nodeMask, 0, sizeof(nodeMask));
+    if (tuning.numaNode >= 0)
+    {
+        QFile cpuListFile(
+            QString("/sys/devices/system/node/node%1/cpulist")
+                .arg(tuning.numaNode));
+        cpu_set_t nodeCpus;
+        if (tuning.numaNode < kMaxNumaNodes &&
+            cpuListFile.open(QIODevice::ReadOnly) &&
+            parseCpuList(QString(cpuListFile.readAll()).trimmed(), &nodeCpus))
+        {
+            bindNuma = true;
+            nodeMask[tuning.numaNode / (8 * sizeof(unsigned long))] |=
+                1UL << (tuning.numaNode % (8 * sizeof(unsigned long)));
+
+            // 同时把CPU限制在该节点上；显式指定了亲和性时取交集
+            if (setAffinity)
+            {
+                CPU_AND(&affinity, &affinity, &nodeCpus);
+                if (CPU_COUNT(&affinity) == 0)
+                {
+                    warnings->append(
+                        QString::fromUtf8("服务 %1 的CPU列表与NUMA节点 %2 "
+                                          "没有交集，改用节点的全部CPU。")
+                            .arg(info.id)
+                            .arg(tuning.numaNode));
+                    affinity = nodeCpus;
+                }
+            }
+            else
+            {
+                affinity = nodeCpus;
+                setAffinity = true;
+            }
+        }
+        else
+        {
+            warnings->append(
+                QString::fromUtf8("NUMA节点 %1 不存在，服务 %2 不做节点绑定。")
+                    .arg(tuning.numaNode)
+                    .arg(info.id));
+        }
+    }
+
+    int ioClass = ioClassValue(tuning.ioClass);
+    if (!tuning.ioClass.isEmpty() && ioClass == 0)
+    {
+        warnings->append(QString::fromUtf8("服务 %1 的ioClass '%2' 无效，已忽略。")
+                             .arg(info.id)
+                             .arg(tuning.ioClass));
+    }
+    int ioPriority = (ioClass << kIoprioClassShift) |
+                     (ioClass == 3 ? 0 : qBound(0, tuning.ioPriority, 7));
+
+    bool disableThp = (tuning.transparentHugePages == "never");
+    if (!tuning.transparentHugePages.isEmpty() && !disableThp)
+    {
+        warnings->append(
+            QString::fromUtf8("透明大页只能按进程禁用，服务 %1 的设置 '%2' 已忽略。")
+                .arg(info.id)
+                .arg(tuning.transparentHugePages));
+    }
+
+    bool setMemlock = tuning.memlockMB >= 0;
+    struct rlimit memlock;
+    memlock.rlim_cur = memlock.rlim_max =
+        (rlim_t)tuning.memlockMB * 1024 * 1024;
+
+    int fds[2];
+    if (::pipe2(fds, O_CLOEXEC) != 0)
+    {
+        *errorMessage =
+            QString::fromUtf8("创建管道失败: %1").arg(strerror(errno));
+        return false;
+    }
+
+    // --- 2. double fork：中间进程setsid后立即退出，服务进程与管理器脱离 ---
+    pid_t child = ::fork();
+    if (child < 0)
+    {
+        *errorMessage = QString::fromUtf8("fork失败: %1").arg(strerror(errno));
+        ::close(fds[0]);
+        ::close(fds[1]);
+        return false;
+    }
+
+    if (child == 0)
+    {
+        ::close(fds[0]);
+        ::setsid();
+
+        pid_t grandchild = ::fork();
+        if (grandchild < 0)
+        {
+            writeReport(fds[1], ReportError, StageFork, errno, 0);
+            ::_exit(1);
+        }
+        if (grandchild > 0)
+        {
+            writeReport(fds[1], ReportPid, 0, 0, grandchild);
+            ::_exit(0);
+        }
+
+        // --- 3. 服务进程：先施加限制，再exec ---
+        sigset_t emptyMask;
+        sigemptyset(&emptyMask);
+        ::sigprocmask(SIG_SETMASK, &emptyMask, 0);
+
+        if (!cgroupProcs.isEmpty())
+        {
+            char buf[32];
+            int len = formatPid(buf, sizeof(buf), (long)::getpid());
+            int cfd = ::open(cgroupProcs.constData(), O_WRONLY | O_CLOEXEC);
+            if (cfd < 0 || ::write(cfd, buf, len) != len)
+            {
+                writeReport(fds[1], ReportError, StageCgroup, errno, 0);
+                ::_exit(127);
+            }
+            ::close(cfd);
+        }
+
+        if (limitAddressSpace && ::setrlimit(RLIMIT_AS, &addressSpace) != 0)
+        {
+            writeReport(fds[1], ReportError, StageRlimit, errno, 0);
+            ::_exit(127);
+        }
+        if (limitOpenFiles && ::setrlimit(RLIMIT_NOFILE, &openFiles) != 0)
+        {
+            writeReport(fds[1], ReportError, StageRlimit, errno, 0);
+            ::_exit(127);
+        }
+
+        // 调优参数失败只回报警告，服务照常启动
+        if (setAffinity &&
+            ::sched_setaffinity(0, sizeof(affinity), &affinity) != 0)
+        {
+            writeReport(fds[1], ReportWarning, StageAffinity, errno, 0);
+        }
+        if (bindNuma && ::syscall(SYS_set_mempolicy, kMpolBind, nodeMask,
+                                  (unsigned long)kMaxNumaNodes) != 0)
+        {
+            writeReport(fds[1], ReportWarning, StageNuma, errno, 0);
+        }
+        if (tuning.niceSet &&
+            ::setpriority(PRIO_PROCESS, 0, tuning.nice) != 0)
+        {
+            writeReport(fds[1], ReportWarning, StageNice, errno, 0);
+        }
+        if (ioClass != 0 && ::syscall(SYS_ioprio_set, kIoprioWhoProcess, 0,
+                                      ioPriority) != 0)
+        {
+            writeReport(fds[1], ReportWarning, StageIoPriority, errno, 0);
+        }
+        if (disableThp && ::prctl(PR_SET_THP_DISABLE, 1, 0, 0, 0) != 0)
+        {
+            writeReport(fds[1], ReportWarning, StageThp, errno, 0);
+        }
+        if (setMemlock && ::setrlimit(RLIMIT_MEMLOCK, &memlock) != 0)
+        {
+            writeReport(fds[1], ReportWarning, StageMemlock, errno, 0);
+        }
+
+        if (!workingDir.isEmpty() && ::chdir(workingDir.constData()) != 0)
+        {
+            writeReport(fds[1], ReportError, StageChdir, errno, 0);
+            ::_exit(127);
+        }
+
+        ::execvp(argvData[0], argvData);
+        writeReport(fds[1], ReportError, StageExec, errno, 0);
+        ::_exit(127);
+    }
+
+    // --- 4. 父进程：回收中间进程，读取回报直到exec成功关闭管道 ---
+    ::close(fds[1]);
+    int status = 0;
+    while (::waitpid(child, &status, 0) < 0 && errno == EINTR)
+    {
+    }
+
+    // 中间进程的 ReportPid 与孙进程的 ReportError 写入顺序不定，
+    // 失败一旦出现就不能被之后到达的 PID 覆盖
+    bool failed = false;
+    qint64 launchedPid = 0;
+    LaunchReport report;
+    while (readReport(fds[0], &report))
+    {
+        if (report.kind == ReportPid)
+        {
+            launchedPid = report.pid;
+        }
+        else if (report.kind == ReportError)
+        {
+            failed = true;
+            *errorMessage = QString::fromUtf8("%1 失败: %2")
+                                .arg(stageName(report.stage))
+                                .arg(strerror(report.error));
+        }
+        else if (report.kind == ReportWarning)
+        {
+            warnings->append(QString::fromUtf8("服务 %1 %2 失败: %3")
+                                 .arg(info.id)
+                                 .arg(stageName(report.stage))
+                                 .arg(strerror(report.error)));
+        }
+    }
+    ::close(fds[0]);
+
+    if (!failed && launchedPid > 0)
+    {
+        *pid = launchedPid;
+        return true;
+    }
+    if (errorMessage->isEmpty())
+    {
+        *errorMessage = QString::fromUtf8("未能获取服务进程PID");
+    }
+    return false;
+}
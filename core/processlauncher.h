@@ -0,0 +1,31 @@
+#ifndef PROCESSLAUNCHER_H
+#define PROCESSLAUNCHER_H
+
+#include <QString>
+#include <QStringList>
+
+#include "processinfo.h"
+
+// 以脱离模式(double fork + setsid)启动服务进程。
+// 与 QProcess::startDetached 不同，它允许在子进程 exec 之前
+// 应用资源限制(setrlimit / 加入cgroup)，让限制从进程的第一条指令起就生效；
+// 调度与内存放置参数(CPU亲和性、NUMA、nice、ionice、THP、memlock)也在此应用。
+class ProcessLauncher {
+public:
+    // 启动成功返回true并写入pid；失败时errorMessage给出原因。
+    // warnings 收集非致命问题(例如cgroup不可用时限制被跳过)。
+    static bool startDetached(const ProcessInfo &info, qint64 *pid,
+                              QString *errorMessage, QStringList *warnings);
+
+    // 服务退出后清理其cgroup目录(目录非空时内核会拒绝，忽略即可)
+    static void releaseCgroup(const QString &id);
+
+    static QString cgroupPathFor(const QString &id);
+
+private:
+    // 在父进程中创建cgroup并写入限制值，返回cgroup.procs路径，失败返回空
+    static QString prepareCgroup(const ProcessInfo &info,
+                                 QStringList *warnings);
+};
+
+#endif  // PROCESSLAUNCHER_H
@@ -0,0 +1,52 @@
+#include "processstate.h"
+
+namespace ProcessState
+{
+
+namespace
+{
+
+const char *const kNames[Count] = {
+    "Stopped", "Starting", "Running", "Stopping", "Error", "Quarantined"};
+
+// 转换表：行为当前状态，列为目标状态
+//   空闲状态 -> Running: 接管已在运行的进程(例如管理器重启后)
+//   Stopped  -> Stopping: 接管的进程在第一次监控之前就被停止
+//   Stopped  -> Error: 等待中的依赖失败或成环，服务无法启动
+//   Starting -> Stopped/Quarantined: 启动阶段即退出
+//   Stopping -> Running 不允许：停止中的进程在退出前一直保持 Stopping
+const bool kTransitions[Count][Count] = {
+    // 列的顺序与 State 相同
+    /* Stopped */     {false, true,  true,  true,  true,  false},
+    /* Starting */    {true,  false, true,  true,  true,  true},
+    /* Running */     {true,  false, false, true,  false, true},
+    /* Stopping */    {true,  false, false, false, false, true},
+    /* Error */       {true,  true,  true,  false, false, true},
+    /* Quarantined */ {true,  true,  true,  false, false, false},
+};
+
+bool isValid(State state)
+{
+    return state >= 0 && state < Count;
+}
+
+}  // namespace
+
+const char *name(State state)
+{
+    return isValid(state) ? kNames[state] : "Unknown";
+}
+
+bool isIdle(State state)
+{
+    return state == Stopped || state == Error || state == Quarantined;
+}
+
+bool isLegalTransition(State from, State to)
+{
+    if (!isValid(from) || !isValid(to))
+        return false;
+    return kTransitions[from][to];
+}
+
+}  // namespace ProcessState
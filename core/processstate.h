@@ -0,0 +1,36 @@
+#ifndef PROCESSSTATE_H
+#define PROCESSSTATE_H
+
+#include <QMetaType>
+
+// 服务生命周期状态。
+// 后端和界面都只比较枚举值；只有显示和写日志时才转换成文字。
+namespace ProcessState
+{
+
+enum State
+{
+    Stopped = 0,
+    Starting,
+    Running,
+    Stopping,
+    Error,
+    Quarantined
+};
+
+const int Count = Quarantined + 1;
+
+// 英文标识，用于日志
+const char *name(State state);
+
+// 没有进程、可以启动/编辑/删除的状态: Stopped、Error、Quarantined
+bool isIdle(State state);
+
+// 转换表中是否允许 from -> to；相同状态之间不算转换
+bool isLegalTransition(State from, State to);
+
+}  // namespace ProcessState
+
+Q_DECLARE_METATYPE(ProcessState::State)
+
+#endif  // PROCESSSTATE_H
@@ -0,0 +1,278 @@
+#include "procfs.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <dirent.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace
+{
+
+bool writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    bool ok = file.write(content) == content.size();
+    file.close();
+    return ok;
+}
+
+} // namespace
+
+ProcFs::ProcFs()
+{
+    m_syscalls = 0;
+    m_simulated = false;
+    setRoot(QString());
+}
+
+void ProcFs::setRoot(const QString &root)
+{
+    QString cleaned = root.isEmpty() ? QString("/proc") : QDir::cleanPath(root);
+    m_root = cleaned;
+    m_rootLocal = QFile::encodeName(cleaned);
+    // 换回真实的 /proc 时不能保留模拟模式，否则信号会写进 /proc/signals
+    if (cleaned == "/proc")
+        m_simulated = false;
+}
+
+bool ProcFs::setSimulated(bool simulated)
+{
+    if (simulated && m_root == "/proc")
+        return false;
+    m_simulated = simulated;
+    return true;
+}
+
+QString ProcFs::path(const char *relative) const
+{
+    return m_root + '/' + QString::fromLatin1(relative);
+}
+
+QString ProcFs::pidPath(qint64 pid, const char *name) const
+{
+    return QString("%1/%2/%3").arg(m_root).arg(pid).arg(QString::fromLatin1(name));
+}
+
+bool ProcFs::isAlive(qint64 pid) const
+{
+    if (pid <= 0)
+        return false;
+    ++m_syscalls;
+    if (!m_simulated)
+        return ::kill(pid, 0) == 0;
+
+    QByteArray dir = m_rootLocal + '/' + QByteArray::number(pid);
+    return ::access(dir.constData(), F_OK) == 0;
+}
+
+bool ProcFs::sendSignal(qint64 pid, int sig) const
+{
+    if (pid <= 0)
+        return false;
+    if (!m_simulated)
+    {
+        ++m_syscalls;
+        return ::kill(pid, sig) == 0;
+    }
+
+    if (!isAlive(pid))
+        return false;
+    if (sig == 0)
+        return true;
+
+    QFile signalFile(path("signals"));
+    if (!signalFile.open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+    signalFile.write(QString("%1 %2\n").arg(pid).arg(sig).toLatin1());
+    signalFile.close();
+    return true;
+}
+
+bool ProcFs::readIdentity(qint64 pid, ProcessIdentity *identity) const
+{
+    if (pid <= 0)
+        return false;
+    ++m_syscalls;
+
+    QFile statFile(pidPath(pid, "stat"));
+    if (!statFile.open(QIODevice::ReadOnly))
+        return false;
+    QByteArray stat = statFile.readAll();
+    statFile.close();
+    if (stat.isEmpty())
+        return false;
+
+    // 内核线程和僵尸进程的 cmdline 为空，哈希仍然有效
+    QFile cmdlineFile(pidPath(pid, "cmdline"));
+    if (!cmdlineFile.open(QIODevice::ReadOnly))
+        return false;
+    identity->pid = pid;
+    identity->startTime = parseStartTime(stat);
+    identity->cmdlineHash = hashCmdline(cmdlineFile.readAll());
+    cmdlineFile.close();
+    return true;
+}
+
+bool ProcFs::isSameProcess(const ProcessIdentity &identity) const
+{
+    if (identity.startTime == 0)
+        return isAlive(identity.pid);
+    if (identity.pid <= 0)
+        return false;
+    ++m_syscalls;
+
+    QFile statFile(pidPath(identity.pid, "stat"));
+    if (!statFile.open(QIODevice::ReadOnly))
+        return false;
+    return parseStartTime(statFile.readAll()) == identity.startTime;
+}
+
+bool ProcFs::readCmdline(qint64 pid, QByteArray *cmdline) const
+{
+    if (pid <= 0)
+        return false;
+    ++m_syscalls;
+
+    QFile cmdlineFile(pidPath(pid, "cmdline"));
+    if (!cmdlineFile.open(QIODevice::ReadOnly))
+        return false;
+    *cmdline = cmdlineFile.readAll();
+    cmdlineFile.close();
+    return true;
+}
+
+QSet<qint64> ProcFs::livePids() const
+{
+    QSet<qint64> pids;
+    ++m_syscalls;
+    DIR *dir = opendir(m_rootLocal.constData());
+    if (!dir)
+        return pids;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != 0)
+    {
+        if (entry->d_name[0] < '1' || entry->d_name[0] > '9')
+            continue;
+        char *end = 0;
+        long long pid = strtoll(entry->d_name, &end, 10);
+        if (*end == '\0')
+            pids.insert(pid);
+    }
+
+    closedir(dir);
+    return pids;
+}
+
+unsigned long long ProcFs::parseStartTime(const QByteArray &stat)
+{
+    // comm 中可能含有 ')'，以最后一个为准；其后第一项是第3项(state)
+    int commEnd = stat.lastIndexOf(')');
+    if (commEnd < 0)
+        return 0;
+    QList<QByteArray> fields = stat.mid(commEnd + 2).split(' ');
+    if (fields.size() <= 19)
+        return 0;
+    return fields.at(19).toULongLong();
+}
+
+bool ProcFs::cmdlineRuns(const QByteArray &cmdline, const QString &command)
+{
+    QByteArray program = QFile::encodeName(command);
+    QByteArray programName = QFile::encodeName(QFileInfo(command).fileName());
+    if (program.isEmpty())
+        return false;
+
+    QList<QByteArray> argv = cmdline.split('\0');
+    for (int i = 0; i < argv.size() && i < 3; ++i)
+    {
+        const QByteArray &arg = argv.at(i);
+        if (arg == program)
+            return true;
+        int slash = arg.lastIndexOf('/');
+        if (!programName.isEmpty() && arg.mid(slash + 1) == programName)
+            return true;
+    }
+    return false;
+}
+
+quint32 ProcFs::hashCmdline(const QByteArray &cmdline)
+{
+    quint32 hash = 2166136261u;
+    for (int i = 0; i < cmdline.size(); ++i)
+    {
+        hash ^= (unsigned char)cmdline.at(i);
+        hash *= 16777619u;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+qint64 ProcFs::spawnSimulated(const QString &command, QString *error) const
+{
+    QString lastPidPath = path("sys/kernel/ns_last_pid");
+    qint64 lastPid = 0;
+    QFile lastPidFile(lastPidPath);
+    if (lastPidFile.open(QIODevice::ReadOnly))
+    {
+        lastPid = lastPidFile.readAll().trimmed().toLongLong();
+        lastPidFile.close();
+    }
+
+    qint64 pid = qMax(lastPid + 1, SimulatedPidBase);
+    while (QFileInfo(QString("%1/%2").arg(m_root).arg(pid)).exists())
+        ++pid;
+
+    QDir root(m_root);
+    if (!root.mkpath(QString::number(pid)))
+    {
+        if (error)
+            *error = QString::fromUtf8("无法创建模拟进程目录 %1/%2").arg(m_root).arg(pid);
+        return 0;
+    }
+    root.mkpath("sys/kernel");
+    writeFile(lastPidPath, QByteArray::number(pid) + '\n');
+
+    // starttime 以时钟滴答(100Hz)计，取模拟的开机时长
+    unsigned long long startTicks = 0;
+    QFile uptimeFile(path("uptime"));
+    if (uptimeFile.open(QIODevice::ReadOnly))
+    {
+        startTicks = (unsigned long long)(uptimeFile.readAll()
+                                              .split(' ')
+                                              .at(0)
+                                              .toDouble() * 100.0);
+        uptimeFile.close();
+    }
+
+    QByteArray comm = QFile::encodeName(QFileInfo(command).fileName());
+    writeFile(pidPath(pid, "stat"), simulatedStat(pid, comm, 0, 0, startTicks, 0));
+    writeFile(pidPath(pid, "statm"), "0 0 0 0 0 0 0\n");
+    writeFile(pidPath(pid, "comm"), comm + '\n');
+    writeFile(pidPath(pid, "cmdline"), QFile::encodeName(command) + '\0');
+    return pid;
+}
+
+QByteArray ProcFs::simulatedStat(qint64 pid, const QByteArray &comm,
+                                 unsigned long long utime,
+                                 unsigned long long stime,
+                                 unsigned long long startTicks, qint64 rssPages)
+{
+    // 字段顺序见 proc(5)；14/15 为 utime/stime，22 为 starttime，24 为 rss
+    char buffer[512];
+    int length = snprintf(buffer, sizeof(buffer),
+                          "%lld (%s) S 1 %lld %lld 0 -1 4194560 0 0 0 0 %llu %llu "
+                          "0 0 20 0 1 0 %llu %lld %lld 18446744073709551615 "
+                          "0 0 0 0 0 0 0 0 0 0 0 0 17 0 0 0 0 0 0\n",
+                          (long long)pid, comm.left(15).constData(),
+                          (long long)pid, (long long)pid, utime, stime, startTicks,
+                          (long long)rssPages * 4096 * 2, (long long)rssPages);
+    return QByteArray(buffer, qMin(length, (int)sizeof(buffer) - 1));
+}
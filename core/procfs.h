@@ -0,0 +1,91 @@
+#ifndef PROCFS_H
+#define PROCFS_H
+
+#include <QByteArray>
+#include <QSet>
+#include <QString>
+
+// 进程身份。PID 会被内核复用，(PID, starttime) 在一次开机内唯一；
+// starttime 从开机算起，重启后可能巧合相同，再用命令行哈希排除
+struct ProcessIdentity {
+    qint64 pid;
+    unsigned long long startTime;  // /proc/<pid>/stat 第22项，开机以来的时钟滴答；0 = 未知
+    quint32 cmdlineHash;           // /proc/<pid>/cmdline 的哈希；0 = 未知
+
+    ProcessIdentity() {
+        pid = 0;
+        startTime = 0;
+        cmdlineHash = 0;
+    }
+};
+
+// 后台对 /proc 与进程信号的统一入口。
+// 根目录默认是 /proc，也可以指向另一个真实的 procfs(例如容器中挂载的 /host/proc)。
+// 模拟模式需要单独开启，与根目录无关：开启后根目录应指向一棵模拟的目录树
+// (例如 benchmarks/procsimulator 在 tmpfs 上生成的)，从而不真正启动上万个进程
+// 就能对监控采样、健康检查和重启逻辑做压测。模拟模式下不会触碰任何真实进程:
+//   - 进程是否存活看 <root>/<pid> 目录是否存在；
+//   - 信号以 "<pid> <sig>" 一行追加到 <root>/signals，由模拟器决定进程如何响应；
+//   - 启动进程时从 <root>/sys/kernel/ns_last_pid 分配PID并创建 <root>/<pid>。
+class ProcFs {
+public:
+    // 模拟PID从这里开始分配，高于内核 pid_max 的上限(4194304)，
+    // 即使误发给真实系统也只会得到 ESRCH
+    static const qint64 SimulatedPidBase = 5000000;
+
+    ProcFs();
+
+    // 空串恢复为 /proc
+    void setRoot(const QString &root);
+    const QString &root() const { return m_root; }
+    // 模拟模式；根目录为 /proc 时不允许开启，返回false
+    bool setSimulated(bool simulated);
+    bool isSimulated() const { return m_simulated; }
+
+    // <root>/<relative>，例如 path("meminfo")
+    QString path(const char *relative) const;
+    // <root>/<pid>/<name>，例如 pidPath(pid, "statm")
+    QString pidPath(qint64 pid, const char *name) const;
+
+    bool isAlive(qint64 pid) const;
+    // 语义同 ::kill(pid, sig) == 0
+    bool sendSignal(qint64 pid, int sig) const;
+
+    // 读取进程当前的 starttime 和命令行哈希，进程不存在时返回false
+    bool readIdentity(qint64 pid, ProcessIdentity *identity) const;
+    // 进程仍存在且 starttime 与记录一致；starttime 未知(旧格式PID文件)时只检查是否存活
+    bool isSameProcess(const ProcessIdentity &identity) const;
+    // 读取 /proc/<pid>/cmdline(以 '\0' 分隔的参数)，进程不存在时返回false
+    bool readCmdline(qint64 pid, QByteArray *cmdline) const;
+    // 读一次根目录，列出全部存活的PID
+    QSet<qint64> livePids() const;
+
+    // isAlive/sendSignal/isSameProcess/livePids 累计发出的系统调用数(kill、access、读取 stat 或列目录)
+    quint64 syscallCount() const { return m_syscalls; }
+
+    // 模拟模式下代替脱离启动：分配PID、创建进程目录，失败返回0
+    qint64 spawnSimulated(const QString &command, QString *error) const;
+
+    // stat 内容中的 starttime(第22项)，解析失败返回0
+    static unsigned long long parseStartTime(const QByteArray &stat);
+    // cmdline 运行的是否是 command：比较 argv[0](完整路径或文件名)。
+    // 由 #! 解释器运行的脚本，内核把脚本路径放在解释器及其可选参数之后
+    static bool cmdlineRuns(const QByteArray &cmdline, const QString &command);
+    // FNV-1a；永远不返回0
+    static quint32 hashCmdline(const QByteArray &cmdline);
+
+    // 模拟进程的 stat 内容；时间以时钟滴答(100Hz)计，内存以4K页计
+    static QByteArray simulatedStat(qint64 pid, const QByteArray &comm,
+                                    unsigned long long utime,
+                                    unsigned long long stime,
+                                    unsigned long long startTicks,
+                                    qint64 rssPages);
+
+private:
+    QString m_root;
+    QByteArray m_rootLocal;  // 供 access() 等C接口使用
+    bool m_simulated;
+    mutable quint64 m_syscalls;
+};
+
+#endif  // PROCFS_H
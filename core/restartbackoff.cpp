@@ -0,0 +1,200 @@
+#include "restartbackoff.h"
+
+#include <QRandomGenerator>
+#include <QTimer>
+
+#include <cmath>
+
+RestartBackoff::RestartBackoff(QObject *parent) : QObject(parent)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+
+    m_clock.start();
+}
+
+void RestartBackoff::setPolicy(const QString &id,
+                               const ProcessInfo::RestartPolicy &policy)
+{
+    m_states[id].policy = policy;
+}
+
+void RestartBackoff::removeService(const QString &id)
+{
+    QHash<QString, State>::iterator it = m_states.find(id);
+    if (it == m_states.end())
+        return;
+
+    unschedule(id, it.value());
+    m_states.erase(it);
+    rearm();
+}
+
+void RestartBackoff::markStarted(const QString &id)
+{
+    m_states[id].startedMs = m_clock.elapsed();
+}
+
+qint64 RestartBackoff::recordFailure(const QString &id)
+{
+    State &state = m_states[id];
+    const ProcessInfo::RestartPolicy &policy = state.policy;
+    qint64 now = m_clock.elapsed();
+
+    // 上一次运行足够久，视为已恢复正常，退避从头开始。
+    // 这次运行已经结束；之后没能启动起来的失败不会再按它清零
+    if (state.startedMs >= 0 &&
+        now - state.startedMs >= (qint64)policy.resetAfterSec * 1000)
+    {
+        state.attempts = 0;
+    }
+    state.startedMs = -1;
+
+    qint64 windowStart = now - (qint64)policy.crashLoopWindowSec * 1000;
+    while (!state.failures.isEmpty() && state.failures.first() < windowStart)
+    {
+        state.failures.removeFirst();
+    }
+    state.failures.append(now);
+
+    unschedule(id, state);
+
+    if (policy.crashLoopCount > 0 &&
+        state.failures.count() >= policy.crashLoopCount)
+    {
+        state.quarantined = true;
+        rearm();
+        return -1;
+    }
+
+    qint64 delay = nextDelay(state);
+    ++state.attempts;
+    state.dueMs = now + delay;
+    m_byDeadline.insert(state.dueMs, id);
+    rearm();
+    return delay;
+}
+
+void RestartBackoff::cancel(const QString &id)
+{
+    QHash<QString, State>::iterator it = m_states.find(id);
+    if (it == m_states.end())
+        return;
+
+    unschedule(id, it.value());
+    rearm();
+}
+
+void RestartBackoff::cancelAll()
+{
+    for (QHash<QString, State>::iterator it = m_states.begin();
+         it != m_states.end(); ++it)
+    {
+        it->dueMs = -1;
+    }
+    m_byDeadline.clear();
+    m_timer->stop();
+}
+
+void RestartBackoff::release(const QString &id)
+{
+    QHash<QString, State>::iterator it = m_states.find(id);
+    if (it == m_states.end())
+        return;
+
+    unschedule(id, it.value());
+    it->quarantined = false;
+    it->attempts = 0;
+    it->failures.clear();
+    rearm();
+}
+
+bool RestartBackoff::isQuarantined(const QString &id) const
+{
+    return m_states.value(id).quarantined;
+}
+
+bool RestartBackoff::isPending(const QString &id) const
+{
+    return m_states.value(id).dueMs >= 0;
+}
+
+int RestartBackoff::pendingCount() const
+{
+    return m_byDeadline.count();
+}
+
+int RestartBackoff::restartCount(const QString &id) const
+{
+    return m_states.value(id).restarts;
+}
+
+int RestartBackoff::countRestart(const QString &id)
+{
+    return ++m_states[id].restarts;
+}
+
+void RestartBackoff::onTimeout()
+{
+    qint64 now = m_clock.elapsed();
+
+    // 先取出全部到期的服务再通知，接收方会在处理中修改队列
+    QStringList due;
+    QMultiMap<qint64, QString>::iterator it = m_byDeadline.begin();
+    while (it != m_byDeadline.end() && it.key() <= now)
+    {
+        due.append(it.value());
+        m_states[it.value()].dueMs = -1;
+        it = m_byDeadline.erase(it);
+    }
+
+    rearm();
+
+    for (int i = 0; i < due.count(); ++i)
+    {
+        emit restartDue(due.at(i));
+    }
+}
+
+qint64 RestartBackoff::nextDelay(const State &state) const
+{
+    const ProcessInfo::RestartPolicy &policy = state.policy;
+
+    double delay = policy.initialDelayMs *
+                   std::pow(policy.multiplier, (double)state.attempts);
+    delay = qMin(delay, (double)policy.maxDelayMs);
+
+    // 在 [1-jitter, 1+jitter] 内均匀抖动
+    if (policy.jitter > 0.0)
+    {
+        double factor = 1.0 + policy.jitter *
+                                  (QRandomGenerator::global()->generateDouble() *
+                                       2.0 -
+                                   1.0);
+        delay *= factor;
+    }
+
+    return qMax((qint64)0, (qint64)delay);
+}
+
+void RestartBackoff::unschedule(const QString &id, State &state)
+{
+    if (state.dueMs < 0)
+        return;
+
+    m_byDeadline.remove(state.dueMs, id);
+    state.dueMs = -1;
+}
+
+void RestartBackoff::rearm()
+{
+    if (m_byDeadline.isEmpty())
+    {
+        m_timer->stop();
+        return;
+    }
+
+    qint64 delay = m_byDeadline.firstKey() - m_clock.elapsed();
+    m_timer->start((int)qMax((qint64)0, delay));
+}
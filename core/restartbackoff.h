@@ -0,0 +1,87 @@
+#ifndef RESTARTBACKOFF_H
+#define RESTARTBACKOFF_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QString>
+
+#include "processinfo.h"
+
+class QTimer;
+
+// 常驻服务意外退出后的自动重启控制。
+// 每次失败后的等待时间按 initialDelay * multiplier^n 指数增长(不超过maxDelay)，
+// 再加上随机抖动，避免一批服务同时重启；稳定运行超过 resetAfter 后退避清零。
+// 在 crashLoopWindow 内失败达到 crashLoopCount 次的服务进入隔离状态，
+// 不再自动重启，直到用户手动启动。所有待重启服务共用一个定时器。
+class RestartBackoff : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RestartBackoff(QObject *parent = 0);
+
+    void setPolicy(const QString &id, const ProcessInfo::RestartPolicy &policy);
+    void removeService(const QString &id);
+
+    // 服务已启动，用于判断上一次运行是否足够稳定
+    void markStarted(const QString &id);
+
+    // 服务意外退出。返回安排的重启延迟(毫秒)，进入隔离状态时返回-1
+    qint64 recordFailure(const QString &id);
+
+    // 取消尚未执行的重启(用户手动停止/全部停止)
+    void cancel(const QString &id);
+    void cancelAll();
+
+    // 解除隔离并清空失败记录(用户手动启动)
+    void release(const QString &id);
+
+    bool isQuarantined(const QString &id) const;
+    bool isPending(const QString &id) const;
+    // 正在等待退避结束的服务数
+    int pendingCount() const;
+    int restartCount(const QString &id) const;
+
+    // 由调用方在重启真正执行时调用，计入重启次数并返回新的次数
+    int countRestart(const QString &id);
+
+signals:
+    // 退避等待结束，应重新启动该服务
+    void restartDue(const QString &id);
+
+private slots:
+    void onTimeout();
+
+private:
+    struct State {
+        ProcessInfo::RestartPolicy policy;
+        int attempts;            // 当前连续失败次数，决定退避时长
+        int restarts;            // 累计自动重启次数
+        QList<qint64> failures;  // 崩溃检测窗口内的失败时刻
+        qint64 startedMs;
+        qint64 dueMs;            // 待重启的时刻，-1 表示没有待执行的重启
+        bool quarantined;
+
+        State() {
+            attempts = 0;
+            restarts = 0;
+            startedMs = -1;
+            dueMs = -1;
+            quarantined = false;
+        }
+    };
+
+    qint64 nextDelay(const State &state) const;
+    void unschedule(const QString &id, State &state);
+    void rearm();
+
+    QHash<QString, State> m_states;
+    QMultiMap<qint64, QString> m_byDeadline;  // 重启时刻 -> 服务ID
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+};
+
+#endif  // RESTARTBACKOFF_H
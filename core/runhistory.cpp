@@ -0,0 +1,219 @@
+#include "runhistory.h"
+
+#include <unistd.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QSaveFile>
+
+namespace
+{
+
+// 追加的行数超过索引容量的这一倍数时重写文件
+const int kCompactionFactor = 4;
+
+}  // namespace
+
+RunHistory::RunHistory()
+{
+    m_linesSinceCompaction = 0;
+}
+
+bool RunHistory::open(const QString &path, QString *errorMessage)
+{
+    m_path = path;
+    m_runs.clear();
+    m_linesSinceCompaction = 0;
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QFile file(path);
+    if (!file.exists())
+        return true;
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        *errorMessage = QString::fromUtf8("无法读取运行历史文件 %1: %2")
+                            .arg(path)
+                            .arg(file.errorString());
+        return false;
+    }
+
+    bool endsWithNewline = true;
+    int lines = 0;
+    while (!file.atEnd())
+    {
+        QByteArray line = file.readLine();
+        endsWithNewline = line.endsWith('\n');
+        RunRecord record;
+        if (decode(line, &record))
+        {
+            index(record);
+        }
+        ++lines;
+    }
+    file.close();
+
+    m_linesSinceCompaction = lines;
+
+    // 上次写入被中断(最后一行不完整)，或文件已远大于索引，重写一次
+    if (!endsWithNewline || lines > kCompactionFactor * kRunsPerService *
+                                        qMax(1, m_runs.count()))
+    {
+        return compact(errorMessage);
+    }
+    return true;
+}
+
+bool RunHistory::append(const RunRecord &record, QString *errorMessage)
+{
+    index(record);
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        *errorMessage = QString::fromUtf8("无法写入运行历史文件 %1: %2")
+                            .arg(m_path)
+                            .arg(file.errorString());
+        return false;
+    }
+    // 一次write写完整行，避免并发读者看到半行
+    QByteArray line = encode(record);
+    if (file.write(line) != line.size())
+    {
+        *errorMessage = QString::fromUtf8("无法写入运行历史文件 %1: %2")
+                            .arg(m_path)
+                            .arg(file.errorString());
+        return false;
+    }
+    file.close();
+
+    if (++m_linesSinceCompaction >
+        kCompactionFactor * kRunsPerService * qMax(1, m_runs.count()))
+    {
+        return compact(errorMessage);
+    }
+    return true;
+}
+
+QList<RunRecord> RunHistory::recentRuns(const QString &id) const
+{
+    return m_runs.value(id);
+}
+
+void RunHistory::removeService(const QString &id)
+{
+    // 文件中的旧记录在下次重写时被丢弃
+    m_runs.remove(id);
+}
+
+void RunHistory::index(const RunRecord &record)
+{
+    QList<RunRecord> &runs = m_runs[record.id];
+    runs.append(record);
+    while (runs.count() > kRunsPerService)
+    {
+        runs.removeFirst();
+    }
+}
+
+// 只保留内存索引中的记录，原子地替换历史文件
+bool RunHistory::compact(QString *errorMessage)
+{
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        *errorMessage = QString::fromUtf8("无法重写运行历史文件 %1: %2")
+                            .arg(m_path)
+                            .arg(file.errorString());
+        return false;
+    }
+
+    int lines = 0;
+    for (QHash<QString, QList<RunRecord> >::const_iterator it =
+             m_runs.constBegin();
+         it != m_runs.constEnd(); ++it)
+    {
+        const QList<RunRecord> &runs = it.value();
+        for (int i = 0; i < runs.count(); ++i)
+        {
+            file.write(encode(runs.at(i)));
+            ++lines;
+        }
+    }
+
+    file.flush();
+    ::fsync(file.handle());
+    if (!file.commit())
+    {
+        *errorMessage = QString::fromUtf8("无法重写运行历史文件 %1: %2")
+                            .arg(m_path)
+                            .arg(file.errorString());
+        return false;
+    }
+
+    m_linesSinceCompaction = lines;
+    return true;
+}
+
+// 每行: 开始ms 结束ms 退出码 信号 峰值CPU 峰值内存KB CPU时间ms 排队等待ms 服务ID，
+// 以制表符分隔。旧版本写入的行没有排队等待一列，读取时按0处理
+QByteArray RunHistory::encode(const RunRecord &record)
+{
+    QByteArray line;
+    line += QByteArray::number(record.startMs);
+    line += '\t';
+    line += QByteArray::number(record.endMs);
+    line += '\t';
+    line += QByteArray::number(record.exitCode);
+    line += '\t';
+    line += QByteArray::number(record.signalNumber);
+    line += '\t';
+    line += QByteArray::number(record.peakCpu, 'f', 1);
+    line += '\t';
+    line += QByteArray::number((qint64)(record.peakMemMB * 1024));
+    line += '\t';
+    line += QByteArray::number((qint64)(record.cpuSeconds * 1000));
+    line += '\t';
+    line += QByteArray::number(record.queueWaitMs);
+    line += '\t';
+    line += record.id.toUtf8();
+    line += '\n';
+    return line;
+}
+
+bool RunHistory::decode(const QByteArray &line, RunRecord *record)
+{
+    if (!line.endsWith('\n'))
+        return false;
+
+    QList<QByteArray> fields = line.trimmed().split('\t');
+    if (fields.count() != 8 && fields.count() != 9)
+        return false;
+    int idField = fields.count() - 1;
+    if (fields.at(idField).isEmpty())
+        return false;
+
+    bool ok[8];
+    record->startMs = fields.at(0).toLongLong(&ok[0]);
+    record->endMs = fields.at(1).toLongLong(&ok[1]);
+    record->exitCode = fields.at(2).toInt(&ok[2]);
+    record->signalNumber = fields.at(3).toInt(&ok[3]);
+    record->peakCpu = fields.at(4).toDouble(&ok[4]);
+    record->peakMemMB = fields.at(5).toLongLong(&ok[5]) / 1024.0;
+    record->cpuSeconds = fields.at(6).toLongLong(&ok[6]) / 1000.0;
+    record->queueWaitMs = 0;
+    ok[7] = true;
+    if (idField == 8)
+        record->queueWaitMs = fields.at(7).toLongLong(&ok[7]);
+    record->id = QString::fromUtf8(fields.at(idField));
+
+    for (int i = 0; i < 8; ++i)
+    {
+        if (!ok[i])
+            return false;
+    }
+    return true;
+}
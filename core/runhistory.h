@@ -0,0 +1,67 @@
+#ifndef RUNHISTORY_H
+#define RUNHISTORY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+// 一次运行的记录(从启动到进程被回收)
+struct RunRecord {
+    QString id;
+    qint64 startMs;     // UTC毫秒
+    qint64 endMs;
+    int exitCode;       // 被信号终止时为-1
+    int signalNumber;   // 终止信号, 0 = 正常退出
+    double peakCpu;     // 运行期间采样到的最高CPU使用率 (%)
+    double peakMemMB;   // 峰值常驻内存 (MB)
+    double cpuSeconds;  // 用户态+内核态CPU时间合计
+    qint64 queueWaitMs; // 定时任务到点后在并发名额队列中等待的时间，其他运行为0
+
+    RunRecord() {
+        startMs = 0;
+        endMs = 0;
+        exitCode = -1;
+        signalNumber = 0;
+        peakCpu = 0.0;
+        peakMemMB = 0.0;
+        cpuSeconds = 0.0;
+        queueWaitMs = 0;
+    }
+
+    bool succeeded() const { return signalNumber == 0 && exitCode == 0; }
+    qint64 durationMs() const { return endMs - startMs; }
+};
+
+// 运行历史：以只追加的文本文件保存(每次运行一行)，
+// 内存中只为每个服务保留最近的 kRunsPerService 条作为索引。
+// 文件增长到一定规模后按内存索引重写，旧记录随之丢弃。
+class RunHistory {
+public:
+    static const int kRunsPerService = 50;
+
+    RunHistory();
+
+    // 打开(必要时创建)历史文件并载入索引
+    bool open(const QString &path, QString *errorMessage);
+
+    bool append(const RunRecord &record, QString *errorMessage);
+
+    // 最近的运行记录，按时间从旧到新
+    QList<RunRecord> recentRuns(const QString &id) const;
+
+    void removeService(const QString &id);
+
+private:
+    void index(const RunRecord &record);
+    bool compact(QString *errorMessage);
+
+    static QByteArray encode(const RunRecord &record);
+    static bool decode(const QByteArray &line, RunRecord *record);
+
+    QString m_path;
+    QHash<QString, QList<RunRecord> > m_runs;
+    int m_linesSinceCompaction;
+};
+
+#endif  // RUNHISTORY_H
@@ -0,0 +1,57 @@
+#include "runtimetable.h"
+
+int RuntimeTable::acquire(const QString &id)
+{
+    QHash<QString, int>::const_iterator existing = m_handles.constFind(id);
+    if (existing != m_handles.constEnd())
+        return existing.value();
+
+    int handle;
+    if (!m_freeHandles.isEmpty())
+    {
+        handle = m_freeHandles.last();
+        m_freeHandles.removeLast();
+    }
+    else
+    {
+        handle = m_entries.size();
+        m_entries.append(RuntimeEntry());
+    }
+
+    RuntimeEntry &entry = m_entries[handle];
+    entry = RuntimeEntry();
+    entry.id = id;
+    entry.used = true;
+    m_handles.insert(id, handle);
+    return handle;
+}
+
+void RuntimeTable::release(const QString &id)
+{
+    QHash<QString, int>::iterator it = m_handles.find(id);
+    if (it == m_handles.end())
+        return;
+
+    m_entries[it.value()] = RuntimeEntry();
+    m_freeHandles.append(it.value());
+    m_handles.erase(it);
+}
+
+void RuntimeTable::clear()
+{
+    m_entries.clear();
+    m_freeHandles.clear();
+    m_handles.clear();
+}
+
+RuntimeEntry *RuntimeTable::find(const QString &id)
+{
+    int handle = handleOf(id);
+    return handle < 0 ? 0 : &m_entries[handle];
+}
+
+const RuntimeEntry *RuntimeTable::find(const QString &id) const
+{
+    int handle = handleOf(id);
+    return handle < 0 ? 0 : &m_entries.at(handle);
+}
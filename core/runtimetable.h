@@ -0,0 +1,79 @@
+#ifndef RUNTIMETABLE_H
+#define RUNTIMETABLE_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "processstate.h"
+
+// 单个服务在监控周期中频繁读写的运行时数据。
+// 静态配置(命令、参数、健康检查等)留在 ProcessInfo 中，只在需要时按引用读取。
+struct RuntimeEntry {
+    QString id;
+    QString pidFile;  // 每个周期都要读取，与配置共享数据，不做深拷贝
+
+    ProcessState::State state;
+    qint64 stateSinceMs;      // 进入当前状态的时刻(墙钟)
+    qint64 stateEnteredMono;  // 进入当前状态的时刻(单调时钟)
+
+    // 生命周期计时(单调时钟)，0 = 无
+    qint64 startRequestedMono;  // 最近一次请求启动
+    bool seenAlive;             // 本次启动后是否已观察到进程存活
+    qint64 crashedMono;         // 意外退出并安排了自动重启，恢复后清零
+
+    qint64 pid;
+    unsigned long long startTime;     // pid 的 /proc stat starttime，用于识别PID复用
+    unsigned long long prevCpuTicks;  // 上个周期的 utime+stime
+    bool hasPrevCpu;
+    double cpuUsage;
+    double memUsage;
+    int restartCount;
+
+    bool used;  // 槽位是否被占用(删除的服务留下空槽，供后来的服务复用)
+
+    RuntimeEntry()
+    {
+        state = ProcessState::Stopped;
+        stateSinceMs = 0;
+        stateEnteredMono = 0;
+        startRequestedMono = 0;
+        seenAlive = false;
+        crashedMono = 0;
+        pid = 0;
+        startTime = 0;
+        prevCpuTicks = 0;
+        hasPrevCpu = false;
+        cpuUsage = 0.0;
+        memUsage = 0.0;
+        restartCount = 0;
+        used = false;
+    }
+};
+
+// 按整数句柄索引的连续运行时表。
+// 句柄在服务被删除之前保持不变；监控循环直接顺序遍历底层数组，
+// 不分配临时列表，也不拷贝配置。
+class RuntimeTable {
+public:
+    // 为服务分配(或返回已有的)句柄
+    int acquire(const QString &id);
+    void release(const QString &id);
+    void clear();
+
+    int handleOf(const QString &id) const { return m_handles.value(id, -1); }
+    RuntimeEntry *find(const QString &id);
+    const RuntimeEntry *find(const QString &id) const;
+
+    // 遍历用：0 <= handle < capacity()，需跳过 used 为 false 的槽位
+    int capacity() const { return m_entries.size(); }
+    RuntimeEntry &at(int handle) { return m_entries[handle]; }
+    const RuntimeEntry &at(int handle) const { return m_entries.at(handle); }
+
+private:
+    QVector<RuntimeEntry> m_entries;
+    QVector<int> m_freeHandles;
+    QHash<QString, int> m_handles;
+};
+
+#endif  // RUNTIMETABLE_H
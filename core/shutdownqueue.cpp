@@ -0,0 +1,95 @@
+#include "shutdownqueue.h"
+
+#include <QTimer>
+
+ShutdownQueue::ShutdownQueue(QObject *parent) : QObject(parent)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+
+    m_clock.start();
+}
+
+void ShutdownQueue::add(const QString &id, const ProcessIdentity &identity,
+                        int timeoutMs)
+{
+    qint64 pid = identity.pid;
+    remove(pid);
+
+    Entry entry;
+    entry.id = id;
+    entry.identity = identity;
+    entry.timeoutMs = timeoutMs;
+    entry.deadlineMs = m_clock.elapsed() + timeoutMs;
+    m_entries.insert(pid, entry);
+    m_byDeadline.insert(entry.deadlineMs, pid);
+
+    rearm();
+}
+
+void ShutdownQueue::remove(qint64 pid)
+{
+    QHash<qint64, Entry>::iterator it = m_entries.find(pid);
+    if (it == m_entries.end())
+        return;
+
+    m_byDeadline.remove(it->deadlineMs, pid);
+    m_entries.erase(it);
+
+    rearm();
+}
+
+bool ShutdownQueue::contains(qint64 pid) const
+{
+    return m_entries.contains(pid);
+}
+
+bool ShutdownQueue::isEmpty() const
+{
+    return m_entries.isEmpty();
+}
+
+int ShutdownQueue::count() const
+{
+    return m_entries.count();
+}
+
+QList<qint64> ShutdownQueue::pids() const
+{
+    return m_entries.keys();
+}
+
+void ShutdownQueue::onTimeout()
+{
+    qint64 now = m_clock.elapsed();
+
+    // 先把所有到期的条目取出，再逐个通知：接收方可能在处理中修改队列
+    QList<Entry> expired;
+    QMultiMap<qint64, qint64>::iterator it = m_byDeadline.begin();
+    while (it != m_byDeadline.end() && it.key() <= now)
+    {
+        expired.append(m_entries.take(it.value()));
+        it = m_byDeadline.erase(it);
+    }
+
+    rearm();
+
+    for (int i = 0; i < expired.count(); ++i)
+    {
+        emit deadlineExpired(expired.at(i).id, expired.at(i).identity,
+                             expired.at(i).timeoutMs);
+    }
+}
+
+void ShutdownQueue::rearm()
+{
+    if (m_byDeadline.isEmpty())
+    {
+        m_timer->stop();
+        return;
+    }
+
+    qint64 delay = m_byDeadline.firstKey() - m_clock.elapsed();
+    m_timer->start((int)qMax((qint64)0, delay));
+}
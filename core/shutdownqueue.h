@@ -0,0 +1,56 @@
+#ifndef SHUTDOWNQUEUE_H
+#define SHUTDOWNQUEUE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QString>
+
+#include "procfs.h"
+
+class QTimer;
+
+// 优雅关闭的截止时间队列。
+// 每个已发送停止信号的进程登记一个截止时间，按截止时间排序，
+// 只用一个定时器等待最早的那个；进程提前退出时从队列中移除。
+// 登记时的进程身份随截止通知带出，强制终止前据此排除PID复用。
+class ShutdownQueue : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ShutdownQueue(QObject *parent = 0);
+
+    void add(const QString &id, const ProcessIdentity &identity, int timeoutMs);
+    void remove(qint64 pid);
+    bool contains(qint64 pid) const;
+    bool isEmpty() const;
+    int count() const;
+    QList<qint64> pids() const;
+
+signals:
+    // 截止时间已到，进程可能仍未退出
+    void deadlineExpired(const QString &id, const ProcessIdentity &identity,
+                         int timeoutMs);
+
+private slots:
+    void onTimeout();
+
+private:
+    struct Entry {
+        QString id;
+        ProcessIdentity identity;
+        qint64 deadlineMs;
+        int timeoutMs;
+    };
+
+    void rearm();
+
+    QHash<qint64, Entry> m_entries;           // PID -> 登记信息
+    QMultiMap<qint64, qint64> m_byDeadline;  // 截止时间 -> PID
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+};
+
+#endif  // SHUTDOWNQUEUE_H
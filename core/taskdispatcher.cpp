@@ -0,0 +1,251 @@
+#include "taskdispatcher.h"
+
+#include <QPair>
+#include <QRandomGenerator>
+#include <QTimer>
+
+namespace
+{
+
+QString groupLabel(const QString &group)
+{
+    return group.isEmpty() ? QString::fromUtf8("默认") : group;
+}
+
+}  // namespace
+
+TaskDispatcher::TaskDispatcher(QObject *parent) : QObject(parent)
+{
+    m_globalLimit = 0;
+    m_paused = false;
+
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(dispatchPending()));
+
+    m_clock.start();
+}
+
+void TaskDispatcher::setGlobalLimit(int limit)
+{
+    m_globalLimit = qMax(0, limit);
+    dispatchPending();
+}
+
+void TaskDispatcher::setGroupLimits(const QMap<QString, int> &limits)
+{
+    m_groupLimits = limits;
+    dispatchPending();
+}
+
+void TaskDispatcher::enqueue(const QString &id, const QString &group,
+                             int jitterSeconds, bool catchUp)
+{
+    if (!catchUp && m_running.contains(id))
+    {
+        emit logMessage(
+            QString::fromUtf8("[调度器] 任务 '%1' 上一次运行尚未结束，跳过本次。")
+                .arg(id));
+        return;
+    }
+    for (int i = 0; !catchUp && i < m_pending.count(); ++i)
+    {
+        if (m_pending.at(i).id == id && !m_pending.at(i).catchUp)
+        {
+            emit logMessage(
+                QString::fromUtf8("[调度器] 任务 '%1' 已在等待队列中，跳过本次。")
+                    .arg(id));
+            return;
+        }
+    }
+
+    PendingTask task;
+    task.id = id;
+    task.group = group;
+    task.readyAtMs = m_clock.elapsed();
+    task.waitLogged = false;
+    task.catchUp = catchUp;
+    if (jitterSeconds > 0)
+    {
+        int jitterMs = QRandomGenerator::global()->bounded(jitterSeconds * 1000 + 1);
+        task.readyAtMs += jitterMs;
+        emit logMessage(QString::fromUtf8("[调度器] 任务 '%1' 随机延后 %2 秒启动。")
+                            .arg(id)
+                            .arg(jitterMs / 1000.0, 0, 'f', 1));
+    }
+    m_pending.append(task);
+
+    dispatchPending();
+}
+
+void TaskDispatcher::taskFinished(const QString &id)
+{
+    QHash<QString, QString>::iterator it = m_running.find(id);
+    if (it == m_running.end())
+        return;
+
+    QHash<QString, int>::iterator groupIt = m_runningPerGroup.find(it.value());
+    if (groupIt != m_runningPerGroup.end() && --groupIt.value() <= 0)
+    {
+        m_runningPerGroup.erase(groupIt);
+    }
+    m_running.erase(it);
+
+    dispatchPending();
+}
+
+void TaskDispatcher::cancel(const QString &id)
+{
+    for (int i = m_pending.count() - 1; i >= 0; --i)
+    {
+        if (m_pending.at(i).id == id)
+            m_pending.removeAt(i);
+    }
+    rearm();
+}
+
+void TaskDispatcher::setPaused(bool paused)
+{
+    if (m_paused == paused)
+        return;
+    m_paused = paused;
+    if (m_paused)
+        m_timer->stop();
+    else
+        dispatchPending();
+}
+
+bool TaskDispatcher::isRunning(const QString &id) const
+{
+    return m_running.contains(id);
+}
+
+int TaskDispatcher::runningCount() const
+{
+    return m_running.count();
+}
+
+int TaskDispatcher::pendingCount() const
+{
+    return m_pending.count();
+}
+
+bool TaskDispatcher::hasCapacity(const QString &group) const
+{
+    if (m_globalLimit > 0 && m_running.count() >= m_globalLimit)
+        return false;
+
+    if (!group.isEmpty())
+    {
+        int groupLimit = m_groupLimits.value(group, 0);
+        if (groupLimit > 0 && m_runningPerGroup.value(group, 0) >= groupLimit)
+            return false;
+    }
+    return true;
+}
+
+// 按入队顺序派发所有抖动已结束且有名额的任务；
+// 所属组已满的任务不会阻塞其后其他组的任务
+void TaskDispatcher::dispatchPending()
+{
+    if (m_paused)
+        return;
+
+    qint64 now = m_clock.elapsed();
+    QList<QPair<QString, qint64> > launches;
+
+    for (int i = 0; i < m_pending.count();)
+    {
+        PendingTask &task = m_pending[i];
+        // 同一任务的多次补跑依次执行，前一次结束前后面的保持排队
+        if (task.readyAtMs > now || m_running.contains(task.id))
+        {
+            ++i;
+            continue;
+        }
+
+        if (!hasCapacity(task.group))
+        {
+            if (!task.waitLogged)
+            {
+                task.waitLogged = true;
+                emit logMessage(
+                    QString::fromUtf8("[调度器] 任务 '%1' 进入等待队列 "
+                                      "(全局运行中 %2/%3, 组 '%4' 运行中 %5/%6)。")
+                        .arg(task.id)
+                        .arg(m_running.count())
+                        .arg(m_globalLimit > 0 ? QString::number(m_globalLimit)
+                                               : QString::fromUtf8("不限"))
+                        .arg(groupLabel(task.group))
+                        .arg(m_runningPerGroup.value(task.group, 0))
+                        .arg(m_groupLimits.value(task.group, 0) > 0
+                                 ? QString::number(m_groupLimits.value(task.group))
+                                 : QString::fromUtf8("不限")));
+            }
+            ++i;
+            continue;
+        }
+
+        PendingTask ready = task;
+        m_pending.removeAt(i);
+
+        m_running.insert(ready.id, ready.group);
+        m_runningPerGroup[ready.group] += 1;
+
+        qint64 waitMs = now - ready.readyAtMs;
+        recordWait(ready.id, ready.group, waitMs);
+        launches.append(qMakePair(ready.id, waitMs));
+    }
+
+    rearm();
+
+    // 名额已记账后再发出信号：接收方启动失败时会立即回调 taskFinished
+    for (int i = 0; i < launches.count(); ++i)
+    {
+        emit taskReady(launches.at(i).first, launches.at(i).second);
+    }
+}
+
+void TaskDispatcher::recordWait(const QString &id, const QString &group,
+                                qint64 waitMs)
+{
+    WaitStats &stats = m_waitStats[group];
+    stats.count += 1;
+    stats.totalMs += waitMs;
+    stats.maxMs = qMax(stats.maxMs, waitMs);
+
+    if (waitMs <= 0)
+        return;
+
+    emit logMessage(QString::fromUtf8("[调度器] 任务 '%1' 排队等待 %2 秒 "
+                                      "(组 '%3' 累计 %4 次, 平均 %5 秒, 最长 %6 秒)。")
+                        .arg(id)
+                        .arg(waitMs / 1000.0, 0, 'f', 1)
+                        .arg(groupLabel(group))
+                        .arg(stats.count)
+                        .arg(stats.totalMs / 1000.0 / stats.count, 0, 'f', 1)
+                        .arg(stats.maxMs / 1000.0, 0, 'f', 1));
+}
+
+// 只为最早结束抖动的任务设置定时器；等待名额的任务由 taskFinished 唤醒
+void TaskDispatcher::rearm()
+{
+    if (m_paused)
+        return;
+
+    qint64 now = m_clock.elapsed();
+    qint64 earliest = -1;
+    for (int i = 0; i < m_pending.count(); ++i)
+    {
+        qint64 readyAt = m_pending.at(i).readyAtMs;
+        if (readyAt > now && (earliest < 0 || readyAt < earliest))
+            earliest = readyAt;
+    }
+
+    if (earliest < 0)
+    {
+        m_timer->stop();
+        return;
+    }
+    m_timer->start((int)(earliest - now));
+}
@@ -0,0 +1,92 @@
+#ifndef TASKDISPATCHER_H
+#define TASKDISPATCHER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QString>
+
+class QTimer;
+
+// 计划任务的派发队列。
+// 到期的任务先按各自的随机抖动延后，再在全局并发上限与
+// 所属并发组的上限之内按先到先得派发；记录每个任务的排队等待时间，
+// 用于评估并发上限是否合适。
+class TaskDispatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TaskDispatcher(QObject *parent = 0);
+
+    // 0 表示不限制
+    void setGlobalLimit(int limit);
+    void setGroupLimits(const QMap<QString, int> &limits);
+
+    // 将到期任务加入队列；同一任务已在排队或运行中时忽略。
+    // 补跑(catchUp)允许同一任务多次排队，按顺序逐个执行，不会与自身并行
+    void enqueue(const QString &id, const QString &group, int jitterSeconds,
+                 bool catchUp = false);
+
+    // 任务进程已退出(或启动失败)，释放它占用的并发名额
+    void taskFinished(const QString &id);
+
+    // 从队列中移除尚未派发的任务(任务被删除或修改时)
+    void cancel(const QString &id);
+
+    // 暂停期间照常排队，但不派发；恢复时立即派发已到期的任务
+    void setPaused(bool paused);
+    bool isPaused() const { return m_paused; }
+
+    bool isRunning(const QString &id) const;
+    int runningCount() const;
+    int pendingCount() const;
+
+signals:
+    // 名额可用，应立即启动该任务；waitMs 为扣除抖动后的排队等待时间
+    void taskReady(const QString &id, qint64 waitMs);
+    void logMessage(const QString &message);
+
+private slots:
+    void dispatchPending();
+
+private:
+    struct PendingTask {
+        QString id;
+        QString group;
+        qint64 readyAtMs;  // 抖动结束的时刻(单调时钟)
+        bool catchUp;
+        bool waitLogged;
+    };
+
+    struct WaitStats {
+        int count;
+        qint64 totalMs;
+        qint64 maxMs;
+
+        WaitStats() {
+            count = 0;
+            totalMs = 0;
+            maxMs = 0;
+        }
+    };
+
+    bool hasCapacity(const QString &group) const;
+    void recordWait(const QString &id, const QString &group, qint64 waitMs);
+    void rearm();
+
+    QList<PendingTask> m_pending;
+    QHash<QString, QString> m_running;  // 任务ID -> 并发组
+    QHash<QString, int> m_runningPerGroup;
+    QHash<QString, WaitStats> m_waitStats;
+
+    int m_globalLimit;
+    QMap<QString, int> m_groupLimits;
+    bool m_paused;
+
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+};
+
+#endif  // TASKDISPATCHER_H
@@ -0,0 +1,522 @@
+#include "taskscheduler.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTimer>
+
+#include "tracer.h"
+
+namespace
+{
+
+// 最长睡眠时间：即使没有临近的任务，也定期醒来检查墙上时钟是否跳变
+const int kMaxSleepMs = 60000;
+
+// 墙钟与单调时钟的偏差超过该值即视为时钟跳变(手动改时间、NTP步进、挂起恢复)
+const qint64 kClockJumpToleranceMs = 2000;
+
+// 统计错过的执行时最多向前推算的次数(每分钟执行的任务停机一个多月)
+const int kMaxMissedScan = 50000;
+
+}  // namespace
+
+TaskScheduler::CatchUpPolicy TaskScheduler::parseCatchUpPolicy(const QString &text,
+                                                               bool *ok)
+{
+    *ok = true;
+    if (text.isEmpty() || text == "skip")
+        return CatchUpSkip;
+    // "once"/"all" 是早期的名称
+    if (text == "run-once" || text == "once")
+        return CatchUpOnce;
+    if (text == "run-all-bounded" || text == "all")
+        return CatchUpAll;
+    *ok = false;
+    return CatchUpSkip;
+}
+
+const char *TaskScheduler::catchUpPolicyName(CatchUpPolicy policy)
+{
+    switch (policy)
+    {
+        case CatchUpOnce: return "run-once";
+        case CatchUpAll: return "run-all-bounded";
+        default: return "skip";
+    }
+}
+
+TaskScheduler::TaskScheduler(QObject *parent) : QObject(parent)
+{
+    m_started = false;
+    m_generationCounter = 0;
+    m_armedWallMs = 0;
+    m_armedMonoMs = 0;
+
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+
+    m_catchUpTimer = new QTimer(this);
+    m_catchUpTimer->setSingleShot(true);
+    m_catchUpTimer->setInterval(5000);
+    connect(m_catchUpTimer, SIGNAL(timeout()), this, SLOT(onCatchUpTimeout()));
+
+    m_monotonic.start();
+}
+
+TaskScheduler::~TaskScheduler()
+{
+}
+
+QDateTime TaskScheduler::nextFireTime(const ProcessInfo::Schedule &schedule,
+                                      const QDateTime &after)
+{
+    return CronExpression::fromSchedule(schedule).nextAfter(after);
+}
+
+bool TaskScheduler::catchUpEarlier(const CatchUpRun &a, const CatchUpRun &b)
+{
+    return a.scheduledMs < b.scheduledMs;
+}
+
+bool TaskScheduler::laterThan(const HeapEntry &a, const HeapEntry &b)
+{
+    if (a.fireAtMs != b.fireAtMs)
+        return a.fireAtMs > b.fireAtMs;
+    return a.id > b.id;
+}
+
+void TaskScheduler::setTask(const QString &id,
+                            const ProcessInfo::Schedule &schedule)
+{
+    QHash<QString, TaskState>::iterator it = m_tasks.find(id);
+    if (it == m_tasks.end())
+    {
+        TaskState state;
+        state.generation = 0;
+        state.nextFireMs = 0;
+        it = m_tasks.insert(id, state);
+    }
+
+    QString error;
+    it->expression = CronExpression::fromSchedule(schedule, &error);
+    bool policyOk = false;
+    it->catchUpPolicy = parseCatchUpPolicy(schedule.catchUp, &policyOk);
+    it->catchUpLimit = qMax(1, schedule.catchUpLimit);
+    if (!policyOk)
+    {
+        emit logMessage(QString::fromUtf8(
+                            "[调度器] 任务 '%1' 的补跑策略 '%2' 无效，按 skip 处理。"
+                            "可选值: skip, run-once, run-all-bounded")
+                            .arg(id)
+                            .arg(schedule.catchUp));
+    }
+    if (!it->expression.isValid())
+    {
+        emit logMessage(QString::fromUtf8(
+                            "[调度器] 任务 '%1' 的调度配置无效，不会被触发: %2")
+                            .arg(id)
+                            .arg(error));
+    }
+    it->generation = ++m_generationCounter;
+    QDateTime now = QDateTime::currentDateTime();
+    scheduleNext(id, it.value(), now);
+
+    // 新任务(或运行中被修改的任务)从现在开始计算错过的执行，
+    // 启动前加载的任务则沿用状态文件中的记录
+    if (m_started || !m_lastFiredMs.contains(id))
+    {
+        if (markFired(id, now.toMSecsSinceEpoch()) && m_started)
+            saveState();
+    }
+
+    compactHeap();
+    if (m_started)
+        rearm();
+}
+
+void TaskScheduler::removeTask(const QString &id)
+{
+    if (m_tasks.remove(id) == 0)
+        return;
+
+    for (int i = m_catchUpQueue.count() - 1; i >= 0; --i)
+    {
+        if (m_catchUpQueue.at(i).id == id)
+            m_catchUpQueue.removeAt(i);
+    }
+    if (m_lastFiredMs.remove(id) > 0 && m_started)
+        saveState();
+
+    compactHeap();
+    if (m_started)
+        rearm();
+}
+
+void TaskScheduler::clear()
+{
+    m_tasks.clear();
+    m_heap.clear();
+    m_catchUpQueue.clear();
+    m_timer->stop();
+    m_catchUpTimer->stop();
+}
+
+void TaskScheduler::setStateFile(const QString &path)
+{
+    m_stateFile = path;
+    loadState();
+}
+
+void TaskScheduler::setCatchUpInterval(int msec)
+{
+    m_catchUpTimer->setInterval(qMax(0, msec));
+}
+
+void TaskScheduler::start()
+{
+    if (!m_started)
+    {
+        // 丢弃已不存在的任务留下的记录
+        QHash<QString, qint64>::iterator it = m_lastFiredMs.begin();
+        while (it != m_lastFiredMs.end())
+        {
+            if (m_tasks.contains(it.key()))
+                ++it;
+            else
+                it = m_lastFiredMs.erase(it);
+        }
+
+        enqueueCatchUp(QDateTime::currentDateTime());
+        // 启动前新加入的任务的起算时间一次写入
+        saveState();
+    }
+    m_started = true;
+    rearm();
+}
+
+int TaskScheduler::taskCount() const
+{
+    return m_tasks.count();
+}
+
+QDateTime TaskScheduler::nextFireTimeFor(const QString &id) const
+{
+    QHash<QString, TaskState>::const_iterator it = m_tasks.constFind(id);
+    if (it == m_tasks.constEnd() || it->nextFireMs <= 0)
+        return QDateTime();
+    return QDateTime::fromMSecsSinceEpoch(it->nextFireMs);
+}
+
+void TaskScheduler::scheduleNext(const QString &id, TaskState &state,
+                                 const QDateTime &after)
+{
+    QDateTime next = state.expression.nextAfter(after);
+    state.nextFireMs = next.isValid() ? next.toMSecsSinceEpoch() : 0;
+    if (state.nextFireMs > 0)
+    {
+        pushEntry(id, state);
+    }
+}
+
+void TaskScheduler::pushEntry(const QString &id, const TaskState &state)
+{
+    HeapEntry entry;
+    entry.fireAtMs = state.nextFireMs;
+    entry.generation = state.generation;
+    entry.id = id;
+    m_heap.append(entry);
+    std::push_heap(m_heap.begin(), m_heap.end(), laterThan);
+}
+
+// 更新/删除只让旧条目失效(惰性删除)，失效条目过多时按当前状态重建堆
+void TaskScheduler::compactHeap()
+{
+    if (m_heap.count() <= 2 * m_tasks.count() + 16)
+        return;
+
+    m_heap.clear();
+    m_heap.reserve(m_tasks.count());
+    for (QHash<QString, TaskState>::const_iterator it = m_tasks.constBegin();
+         it != m_tasks.constEnd(); ++it)
+    {
+        if (it->nextFireMs <= 0)
+            continue;
+        HeapEntry entry;
+        entry.fireAtMs = it->nextFireMs;
+        entry.generation = it->generation;
+        entry.id = it.key();
+        m_heap.append(entry);
+    }
+    std::make_heap(m_heap.begin(), m_heap.end(), laterThan);
+}
+
+void TaskScheduler::rebuild(const QDateTime &after)
+{
+    m_heap.clear();
+    for (QHash<QString, TaskState>::iterator it = m_tasks.begin();
+         it != m_tasks.end(); ++it)
+    {
+        scheduleNext(it.key(), it.value(), after);
+    }
+}
+
+void TaskScheduler::rearm()
+{
+    // 先丢弃堆顶的失效条目，保证堆顶就是真正最早的截止时间
+    while (!m_heap.isEmpty())
+    {
+        const HeapEntry &top = m_heap.first();
+        QHash<QString, TaskState>::const_iterator it = m_tasks.constFind(top.id);
+        if (it != m_tasks.constEnd() && it->generation == top.generation)
+            break;
+        std::pop_heap(m_heap.begin(), m_heap.end(), laterThan);
+        m_heap.removeLast();
+    }
+
+    if (m_heap.isEmpty())
+    {
+        m_timer->stop();
+        return;
+    }
+
+    m_armedWallMs = QDateTime::currentMSecsSinceEpoch();
+    m_armedMonoMs = m_monotonic.elapsed();
+
+    qint64 delay = m_heap.first().fireAtMs - m_armedWallMs;
+    delay = qBound((qint64)0, delay, (qint64)kMaxSleepMs);
+    m_timer->start((int)delay);
+}
+
+void TaskScheduler::onTimeout()
+{
+    QElapsedTimer tickTimer;
+    tickTimer.start();
+    TraceSpan span("scheduler", "onTimeout");
+
+    qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    qint64 expectedMs = m_armedWallMs + (m_monotonic.elapsed() - m_armedMonoMs);
+    qint64 driftMs = nowMs - expectedMs;
+    QDateTime now = QDateTime::fromMSecsSinceEpoch(nowMs);
+
+    if (driftMs < -kClockJumpToleranceMs)
+    {
+        // 时钟回拨：旧的触发时间可能远在未来，全部从新的当前时间重新计算
+        emit logMessage(QString::fromUtf8("[调度器] 检测到系统时钟回拨 %1 "
+                                          "秒，重新计算所有任务的触发时间。")
+                            .arg(-driftMs / 1000));
+        rebuild(now);
+    }
+    else if (driftMs > kClockJumpToleranceMs)
+    {
+        // 时钟前跳：跳过区间内到期的任务会在下面各补触发一次
+        emit logMessage(
+            QString::fromUtf8("[调度器] 检测到系统时钟前跳 %1 秒。")
+                .arg(driftMs / 1000));
+    }
+
+    QList<HeapEntry> due;
+    bool changed = false;
+    while (!m_heap.isEmpty() && m_heap.first().fireAtMs <= nowMs)
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), laterThan);
+        HeapEntry entry = m_heap.last();
+        m_heap.removeLast();
+
+        QHash<QString, TaskState>::iterator it = m_tasks.find(entry.id);
+        if (it == m_tasks.end() || it->generation != entry.generation)
+            continue;
+
+        // 只为刚到期的任务计算下一次触发时间；以当前时间为起点，
+        // 时钟前跳后同一任务只补触发一次
+        scheduleNext(entry.id, it.value(), now);
+        changed = markFired(entry.id, entry.fireAtMs) || changed;
+        due.append(entry);
+    }
+
+    // 先落盘再放出任务：任务启动后管理器崩溃，重启时不会再补跑同一次
+    if (changed)
+        saveState();
+    for (int i = 0; i < due.count(); ++i)
+    {
+        Tracer::instant("scheduler", "taskDue", due.at(i).id);
+        emit taskDue(due.at(i).id, QDateTime::fromMSecsSinceEpoch(due.at(i).fireAtMs));
+    }
+
+    rearm();
+    m_tickLatency.record(tickTimer.nsecsElapsed() / 1000);
+}
+
+bool TaskScheduler::markFired(const QString &id, qint64 firedMs)
+{
+    QHash<QString, qint64>::iterator it = m_lastFiredMs.find(id);
+    if (it != m_lastFiredMs.end() && it.value() >= firedMs)
+        return false;
+
+    m_lastFiredMs[id] = firedMs;
+    return true;
+}
+
+// 按各任务的补跑策略，找出上次触发之后、now之前错过的执行并排队
+void TaskScheduler::enqueueCatchUp(const QDateTime &now)
+{
+    for (QHash<QString, TaskState>::const_iterator it = m_tasks.constBegin();
+         it != m_tasks.constEnd(); ++it)
+    {
+        const TaskState &state = it.value();
+        if (state.catchUpPolicy == CatchUpSkip)
+            continue;
+
+        QHash<QString, qint64>::const_iterator last =
+            m_lastFiredMs.constFind(it.key());
+        if (last == m_lastFiredMs.constEnd())
+            continue;
+
+        // 只保留最近的 limit 次("once" 即最近的一次)
+        int limit = state.catchUpPolicy == CatchUpOnce ? 1 : state.catchUpLimit;
+        QList<qint64> missed;
+        int missedCount = 0;
+        QDateTime slot = state.expression.nextAfter(
+            QDateTime::fromMSecsSinceEpoch(last.value()));
+        while (slot.isValid() && slot <= now && missedCount < kMaxMissedScan)
+        {
+            ++missedCount;
+            missed.append(slot.toMSecsSinceEpoch());
+            if (missed.count() > limit)
+                missed.removeFirst();
+            slot = state.expression.nextAfter(slot);
+        }
+
+        if (missedCount == 0)
+            continue;
+
+        emit logMessage(
+            QString::fromUtf8("[调度器] 任务 '%1' 在停机期间错过 %2 次执行，"
+                              "按策略 '%3' 补跑 %4 次。")
+                .arg(it.key())
+                .arg(missedCount)
+                .arg(catchUpPolicyName(state.catchUpPolicy))
+                .arg(missed.count()));
+
+        for (int i = 0; i < missed.count(); ++i)
+        {
+            CatchUpRun run;
+            run.scheduledMs = missed.at(i);
+            run.id = it.key();
+            m_catchUpQueue.append(run);
+        }
+    }
+
+    if (m_catchUpQueue.isEmpty())
+        return;
+
+    // 不同任务的补跑按原定时间先后交错放出
+    std::stable_sort(m_catchUpQueue.begin(), m_catchUpQueue.end(),
+                     catchUpEarlier);
+    m_catchUpTimer->start(0);
+}
+
+// 每次只放出一个补跑，避免启动瞬间集中触发
+void TaskScheduler::onCatchUpTimeout()
+{
+    while (!m_catchUpQueue.isEmpty())
+    {
+        CatchUpRun run = m_catchUpQueue.takeFirst();
+        if (!m_tasks.contains(run.id))
+            continue;
+
+        if (markFired(run.id, run.scheduledMs))
+            saveState();
+        emit catchUpDue(run.id, QDateTime::fromMSecsSinceEpoch(run.scheduledMs));
+        break;
+    }
+
+    if (!m_catchUpQueue.isEmpty())
+    {
+        m_catchUpTimer->start();
+    }
+}
+
+void TaskScheduler::loadState()
+{
+    m_lastFiredMs.clear();
+    if (m_stateFile.isEmpty())
+        return;
+
+    QFile file(m_stateFile);
+    if (!file.exists())
+        return;
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        emit logMessage(QString::fromUtf8("[警告] 无法读取调度状态文件 %1。")
+                            .arg(m_stateFile));
+        return;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    file.close();
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject())
+    {
+        emit logMessage(
+            QString::fromUtf8("[警告] 调度状态文件 %1 已损坏，将忽略其中的记录。")
+                .arg(m_stateFile));
+        return;
+    }
+
+    QJsonObject tasks = doc.object()["lastFired"].toObject();
+    for (QJsonObject::const_iterator it = tasks.constBegin();
+         it != tasks.constEnd(); ++it)
+    {
+        qint64 ms = (qint64)it.value().toDouble(0);
+        if (ms > 0)
+        {
+            m_lastFiredMs.insert(it.key(), ms);
+        }
+    }
+}
+
+// 先写临时文件并fsync，再原子地重命名覆盖，崩溃或断电时旧文件保持完整
+void TaskScheduler::saveState()
+{
+    if (m_stateFile.isEmpty())
+        return;
+
+    QJsonObject tasks;
+    for (QHash<QString, qint64>::const_iterator it = m_lastFiredMs.constBegin();
+         it != m_lastFiredMs.constEnd(); ++it)
+    {
+        tasks.insert(it.key(), (double)it.value());
+    }
+    QJsonObject root;
+    root["version"] = 1;
+    root["lastFired"] = tasks;
+
+    QDir().mkpath(QFileInfo(m_stateFile).absolutePath());
+    QSaveFile file(m_stateFile);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        emit logMessage(QString::fromUtf8("[警告] 无法写入调度状态文件 %1: %2")
+                            .arg(m_stateFile)
+                            .arg(file.errorString()));
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.flush();
+    ::fsync(file.handle());
+    if (!file.commit())
+    {
+        emit logMessage(QString::fromUtf8("[警告] 无法写入调度状态文件 %1: %2")
+                            .arg(m_stateFile)
+                            .arg(file.errorString()));
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include "cronexpression.h"
+#include "latencyhistogram.h"
+#include "processinfo.h"
+
+class QTimer;
+
+// 基于截止时间的计划任务调度器。
+// 所有任务的下一次触发时间保存在一个最小堆中，只为最早的那个截止时间
+// 设置一个精确定时器；任务触发后只重新计算它自己的下一次触发时间。
+// 每个任务最近一次触发的时间在放出任务之前同步写入状态文件，启动时据此按任务的
+// 补跑策略找出停机期间错过的执行，并以固定间隔逐个放出。
+class TaskScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TaskScheduler(QObject *parent = 0);
+    ~TaskScheduler();
+
+    // 计算严格晚于 after 的下一次触发时间，调度无效时返回空QDateTime。
+    // 每次调用都会重新编译调度配置，频繁计算时应直接使用 CronExpression
+    static QDateTime nextFireTime(const ProcessInfo::Schedule &schedule,
+                                  const QDateTime &after);
+
+    // 添加或更新任务(从当前时刻重新计算下一次触发时间)
+    void setTask(const QString &id, const ProcessInfo::Schedule &schedule);
+    void removeTask(const QString &id);
+    void clear();
+
+    // 设置状态文件并加载其中记录的触发时间，须在 start() 之前调用
+    void setStateFile(const QString &path);
+    // 启动时补跑任务之间的最小间隔
+    void setCatchUpInterval(int msec);
+
+    // 首次调用时先计算停机期间错过的执行，然后开始调度
+    void start();
+    int taskCount() const;
+    QDateTime nextFireTimeFor(const QString &id) const;
+
+    // 每次到期处理(onTimeout)的耗时分布，单位微秒
+    const LatencyHistogram &tickLatency() const { return m_tickLatency; }
+    void resetTickLatency() { m_tickLatency.reset(); }
+
+signals:
+    void taskDue(const QString &id, const QDateTime &scheduledTime);
+    // 补跑错过的执行，scheduledTime 为原本应触发的时间
+    void catchUpDue(const QString &id, const QDateTime &scheduledTime);
+    void logMessage(const QString &message);
+
+private slots:
+    void onTimeout();
+    void onCatchUpTimeout();
+
+private:
+    enum CatchUpPolicy { CatchUpSkip, CatchUpOnce, CatchUpAll };
+
+
+    struct HeapEntry {
+        qint64 fireAtMs;  // UTC毫秒，避免夏令时切换带来的歧义
+        quint32 generation;
+        QString id;
+    };
+
+    struct TaskState {
+        CronExpression expression;  // 设置任务时编译一次
+        CatchUpPolicy catchUpPolicy;
+        int catchUpLimit;
+        quint32 generation;  // 任务每次被设置时取新值，堆中的旧条目随之失效
+        qint64 nextFireMs;   // 0 = 无有效的下一次触发时间
+    };
+
+    struct CatchUpRun {
+        qint64 scheduledMs;
+        QString id;
+    };
+
+    // 最小堆比较：截止时间越早越靠近堆顶
+    static bool laterThan(const HeapEntry &a, const HeapEntry &b);
+    static bool catchUpEarlier(const CatchUpRun &a, const CatchUpRun &b);
+    // 无法识别时 *ok 为false，按 skip 处理
+    static CatchUpPolicy parseCatchUpPolicy(const QString &text, bool *ok);
+    static const char *catchUpPolicyName(CatchUpPolicy policy);
+
+    void scheduleNext(const QString &id, TaskState &state,
+                      const QDateTime &after);
+    void pushEntry(const QString &id, const TaskState &state);
+    void compactHeap();
+    void rebuild(const QDateTime &after);
+    void rearm();
+
+    void loadState();
+    void saveState();
+    // 记录有变化时返回true，由调用方决定何时写盘
+    bool markFired(const QString &id, qint64 firedMs);
+    void enqueueCatchUp(const QDateTime &now);
+
+    QHash<QString, TaskState> m_tasks;
+    QVector<HeapEntry> m_heap;
+    QTimer *m_timer;
+    bool m_started;
+    quint32 m_generationCounter;
+
+    // 持久化状态：任务ID -> 最近一次触发(或开始计算)的时间, UTC毫秒
+    QString m_stateFile;
+    QHash<QString, qint64> m_lastFiredMs;
+
+    QList<CatchUpRun> m_catchUpQueue;  // 按原定触发时间排序
+    QTimer *m_catchUpTimer;
+
+    // 检测墙上时钟跳变：记录定时器设定时的墙钟时间与单调时钟读数
+    QElapsedTimer m_monotonic;
+
+    LatencyHistogram m_tickLatency;
+    qint64 m_armedWallMs;
+    qint64 m_armedMonoMs;
+};
+
+#endif  // TASKSCHEDULER_H
@@ -0,0 +1,269 @@
+#include "tracer.h"
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+
+const int kBufferEvents = 65536;  // 每个线程，约6MB
+const int kDetailChars = 24;      // 超出部分被截断
+
+// 事件内容只含指针和定长数组，导出方读到写了一半的事件也不会出错，
+// 只需按 seq 丢弃
+struct TraceRecord
+{
+    const char *category;
+    const char *name;
+    qint64 startUs;
+    qint64 durationUs;  // -1 表示瞬时事件
+    ushort detail[kDetailChars];  // UTF-16
+    int detailLength;
+};
+
+// 第 n 个事件(从0计)写入时 seq 为 2n+1，写完后为 2n+2。
+// 导出方在复制前后各读一次 seq，两次都等于 2n+2 才算读到了完整的第 n 个事件
+struct TraceEvent
+{
+    QAtomicInteger<quint64> seq;
+    TraceRecord record;
+};
+
+// 只有所属线程写入；written 在事件写完之后才递增，导出方据此读取
+struct TraceBuffer
+{
+    qint64 tid;
+    QVector<TraceEvent> events;
+    QAtomicInteger<quint64> written;
+};
+
+// 缓冲区在线程退出后仍然保留，供导出使用
+QMutex g_registryMutex;
+QList<TraceBuffer *> g_buffers;
+QHash<qint64, QString> g_threadNames;
+
+__thread TraceBuffer *t_buffer = 0;
+QAtomicInteger<qint64> g_startUs;
+
+qint64 currentTid()
+{
+    return (qint64)::syscall(SYS_gettid);
+}
+
+TraceBuffer *threadBuffer()
+{
+    if (!t_buffer)
+    {
+        TraceBuffer *buffer = new TraceBuffer;
+        buffer->tid = currentTid();
+        buffer->events.resize(kBufferEvents);
+        QMutexLocker locker(&g_registryMutex);
+        g_buffers.append(buffer);
+        t_buffer = buffer;
+    }
+    return t_buffer;
+}
+
+void append(const char *category, const char *name, const QString &detail,
+            qint64 startUs, qint64 durationUs)
+{
+    TraceBuffer *buffer = threadBuffer();
+    quint64 index = buffer->written.load();
+    TraceEvent &event = buffer->events[(int)(index % kBufferEvents)];
+    event.seq.fetchAndStoreOrdered(2 * index + 1);
+
+    TraceRecord &record = event.record;
+    record.category = category;
+    record.name = name;
+    record.startUs = startUs;
+    record.durationUs = durationUs;
+    // 只复制字符，不分配内存；不拆开代理对
+    int length = qMin(detail.length(), kDetailChars);
+    if (length < detail.length() && length > 0 &&
+        detail.at(length - 1).isHighSurrogate())
+        --length;
+    memcpy(record.detail, detail.utf16(), length * sizeof(ushort));
+    record.detailLength = length;
+
+    event.seq.storeRelease(2 * index + 2);
+    buffer->written.storeRelease(index + 1);
+}
+
+void appendJsonString(QByteArray &out, const QString &text)
+{
+    QByteArray utf8 = text.toUtf8();
+    out += '"';
+    for (int i = 0; i < utf8.size(); ++i)
+    {
+        char c = utf8.at(i);
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+            out += escaped;
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+namespace Tracer
+{
+
+QAtomicInt enabledFlag;
+
+void start()
+{
+    g_startUs.store(diagnosticsClockUs());
+    enabledFlag.store(1);
+}
+
+void stop()
+{
+    enabledFlag.store(0);
+}
+
+void setThreadName(const QString &name)
+{
+    QMutexLocker locker(&g_registryMutex);
+    g_threadNames.insert(currentTid(), name);
+}
+
+void instant(const char *category, const char *name, const QString &detail)
+{
+    if (!isEnabled())
+        return;
+    append(category, name, detail, diagnosticsClockUs(), -1);
+}
+
+void complete(const char *category, const char *name, qint64 startUs,
+              qint64 durationUs, const QString &detail)
+{
+    if (!isEnabled())
+        return;
+    append(category, name, detail, startUs, qMax(durationUs, (qint64)0));
+}
+
+bool writeChromeTrace(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        if (error)
+            *error = QString::fromUtf8("无法写入跟踪文件 %1: %2")
+                         .arg(path)
+                         .arg(file.errorString());
+        return false;
+    }
+
+    QList<TraceBuffer *> buffers;
+    QHash<qint64, QString> names;
+    {
+        QMutexLocker locker(&g_registryMutex);
+        buffers = g_buffers;
+        names = g_threadNames;
+    }
+
+    qint64 startUs = g_startUs.load();
+    QByteArray pid = QByteArray::number((qint64)::getpid());
+    QByteArray out("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    bool ok = true;
+
+    for (int b = 0; b < buffers.count(); ++b)
+    {
+        TraceBuffer *buffer = buffers.at(b);
+        QByteArray tid = QByteArray::number(buffer->tid);
+
+        if (!first)
+            out += ",\n";
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":";
+        out += pid;
+        out += ",\"tid\":";
+        out += tid;
+        out += ",\"args\":{\"name\":";
+        appendJsonString(out, names.value(buffer->tid,
+                                          QString("thread-%1").arg(buffer->tid)));
+        out += "}}";
+
+        quint64 written = buffer->written.loadAcquire();
+        quint64 begin = written > (quint64)kBufferEvents ? written - kBufferEvents : 0;
+        for (quint64 i = begin; i < written; ++i)
+        {
+            // 仍在记录的线程可能正在覆盖这个位置：先复制，再确认期间没有被改写
+            TraceEvent &slot = buffer->events[(int)(i % kBufferEvents)];
+            quint64 expected = 2 * i + 2;
+            if (slot.seq.loadAcquire() != expected)
+                continue;
+            TraceRecord event = slot.record;
+            if (slot.seq.fetchAndAddOrdered(0) != expected)
+                continue;
+
+            if (event.startUs < startUs)
+                continue;
+
+            out += ",\n{\"name\":\"";
+            out += event.name;
+            out += "\",\"cat\":\"";
+            out += event.category;
+            if (event.durationUs < 0)
+            {
+                out += "\",\"ph\":\"i\",\"s\":\"t\"";
+            }
+            else
+            {
+                out += "\",\"ph\":\"X\",\"dur\":";
+                out += QByteArray::number(event.durationUs);
+            }
+            out += ",\"ts\":";
+            out += QByteArray::number(event.startUs);
+            out += ",\"pid\":";
+            out += pid;
+            out += ",\"tid\":";
+            out += tid;
+            if (event.detailLength > 0)
+            {
+                out += ",\"args\":{\"id\":";
+                appendJsonString(out, QString::fromUtf16(event.detail,
+                                                         event.detailLength));
+                out += '}';
+            }
+            out += '}';
+
+            if (out.size() > 1024 * 1024)
+            {
+                ok = ok && file.write(out) == out.size();
+                out.clear();
+            }
+        }
+    }
+
+    out += "\n]}\n";
+    ok = ok && file.write(out) == out.size();
+    file.close();
+    if (!ok && error)
+        *error = QString::fromUtf8("写入跟踪文件 %1 失败").arg(path);
+    return ok;
+}
+
+} // namespace Tracer
@@ -0,0 +1,78 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QAtomicInt>
+#include <QString>
+
+#include "backenddiagnostics.h"
+
+// 可选的内部跟踪，导出为 Chrome trace-event JSON(可直接在 Perfetto 中打开)。
+// 每个线程第一次记录时分配自己的环形缓冲区，之后记录只写本线程的缓冲区，
+// 不加锁也不分配内存；缓冲区写满后覆盖最早的事件。
+// 未开启时每个记录点只有一次原子读。
+// category 和 name 必须是字符串常量，只保存指针；detail 按值复制，只保留前24个字符。
+namespace Tracer
+{
+
+extern QAtomicInt enabledFlag;
+
+inline bool isEnabled() { return enabledFlag.load() != 0; }
+
+// start() 之前记录的事件不会被导出
+void start();
+void stop();
+
+// 在导出结果中显示的线程名，须在该线程内调用
+void setThreadName(const QString &name);
+
+// 瞬时事件，例如调度决策
+void instant(const char *category, const char *name,
+             const QString &detail = QString());
+void complete(const char *category, const char *name, qint64 startUs,
+              qint64 durationUs, const QString &detail);
+
+// 导出所有线程自 start() 以来的事件。stop() 之后仍可能有线程在写入，
+// 导出时跳过正在被写入或已被覆盖的事件，不依赖记录已经停止
+bool writeChromeTrace(const QString &path, QString *error);
+
+} // namespace Tracer
+
+// 作用域计时：构造时开始，析构时记录一个完整事件
+class TraceSpan {
+public:
+    TraceSpan(const char *category, const char *name)
+        : m_category(category), m_name(name) {
+        m_startUs = Tracer::isEnabled() ? diagnosticsClockUs() : -1;
+    }
+
+    TraceSpan(const char *category, const char *name, const QString &detail)
+        : m_category(category), m_name(name) {
+        m_startUs = -1;
+        if (Tracer::isEnabled()) {
+            m_detail = detail;
+            m_startUs = diagnosticsClockUs();
+        }
+    }
+
+    ~TraceSpan() { finish(); }
+
+    // 提前结束(一个函数内的前后几个阶段)
+    void finish() {
+        if (m_startUs >= 0) {
+            Tracer::complete(m_category, m_name, m_startUs,
+                             diagnosticsClockUs() - m_startUs, m_detail);
+            m_startUs = -1;
+        }
+    }
+
+private:
+    TraceSpan(const TraceSpan &);
+    TraceSpan &operator=(const TraceSpan &);
+
+    const char *m_category;
+    const char *m_name;
+    QString m_detail;
+    qint64 m_startUs;
+};
+
+#endif  // TRACER_H
@@ -3,6 +3,7 @@
 #include <QFileDialog>
 #include <QMessageBox>
 
+#include "cronexpression.h"
 #include "ui_addservicedialog.h"
 
 AddServiceDialog::AddServiceDialog(QWidget *parent)
@@ -18,6 +19,7 @@ AddServiceDialog::AddServiceDialog(QWidget *parent)
     ui->comboScheduleType->addItem("每日 (daily)", "daily");
     ui->comboScheduleType->addItem("每周 (weekly)", "weekly");
     ui->comboScheduleType->addItem("每月 (monthly)", "monthly");
+    ui->comboScheduleType->addItem("Cron表达式 (cron)", "cron");
 
     // --- 连接信号与槽 ---
     // 使用C++代码连接，比在UI设计器中更灵活、更清晰
@@ -63,6 +65,7 @@ ProcessInfo AddServiceDialog::getServiceInfo() const {
         ' ', QString::SkipEmptyParts);  // 按空格分割参数
     info.workingDir = ui->lineEditWorkingDir->text();
     info.pidFile = ui->lineEditPidFile->text();
+    info.group = ui->lineEditGroup->text().trimmed();
     info.autoStart = ui->checkAutoStart->isChecked();
 
     // 计划任务信息 (仅当启用时收集)
@@ -70,7 +73,10 @@ ProcessInfo AddServiceDialog::getServiceInfo() const {
         info.schedule.type = ui->comboScheduleType->currentData().toString();
         info.schedule.hour = ui->spinHour->value();
         info.schedule.minute = ui->spinMinute->value();
-        if (info.schedule.type == "weekly") {
+        if (info.schedule.type == "cron") {
+            info.schedule.expression =
+                ui->lineEditCronExpression->text().simplified();
+        } else if (info.schedule.type == "weekly") {
             info.schedule.dayOfWeek = ui->spinDayOfWeek->value();
         } else if (info.schedule.type == "monthly") {
             info.schedule.dayOfMonth = ui->spinDayOfMonth->value();
@@ -99,6 +105,7 @@ void AddServiceDialog::setServiceInfo(const ProcessInfo &info) {
         info.args.join(" "));  // 将参数列表合并为空格分隔的字符串
     ui->lineEditWorkingDir->setText(info.workingDir);
     ui->lineEditPidFile->setText(info.pidFile);
+    ui->lineEditGroup->setText(info.group);
     ui->checkAutoStart->setChecked(info.autoStart);
 
     // --- 填充服务类型 ---
@@ -119,6 +126,7 @@ void AddServiceDialog::setServiceInfo(const ProcessInfo &info) {
         ui->spinDayOfMonth->setValue(info.schedule.dayOfMonth);
         ui->spinHour->setValue(info.schedule.hour);
         ui->spinMinute->setValue(info.schedule.minute);
+        ui->lineEditCronExpression->setText(info.schedule.expression);
     }
 
     // --- 填充健康检查 ---
@@ -150,6 +158,17 @@ void AddServiceDialog::accept() {
         ui->lineEditCommand->setFocus();
         return;
     }
+    if (ui->groupSchedule->isChecked() &&
+        ui->comboScheduleType->currentData().toString() == "cron") {
+        QString error;
+        CronExpression::parse(ui->lineEditCronExpression->text(), &error);
+        if (!error.isEmpty()) {
+            QMessageBox::warning(this, "输入错误",
+                                 QString("Cron表达式无效：%1").arg(error));
+            ui->lineEditCronExpression->setFocus();
+            return;
+        }
+    }
 
     // 所有验证通过，调用基类的accept()，这才会真正关闭对话框并返回QDialog::Accepted
     QDialog::accept();
@@ -201,18 +220,33 @@ void AddServiceDialog::updateScheduleFields() {
         ui->spinDayOfWeek->setVisible(false);
         ui->labelDayOfMonth->setVisible(false);
         ui->spinDayOfMonth->setVisible(false);
+        ui->labelCronExpression->setVisible(false);
+        ui->lineEditCronExpression->setVisible(false);
+        ui->label_10->setVisible(true);
+        ui->spinHour->setVisible(true);
+        ui->label_11->setVisible(true);
+        ui->spinMinute->setVisible(true);
         return;
     }
 
     QString type = ui->comboScheduleType->currentData().toString();
     bool isWeekly = (type == "weekly");
     bool isMonthly = (type == "monthly");
+    bool isCron = (type == "cron");
 
     ui->labelDayOfWeek->setVisible(isWeekly);
 
     ui->spinDayOfWeek->setVisible(isWeekly);
     ui->labelDayOfMonth->setVisible(isMonthly);
     ui->spinDayOfMonth->setVisible(isMonthly);
+
+    // cron表达式自带时间字段，不再需要单独的小时/分钟
+    ui->label_10->setVisible(!isCron);
+    ui->spinHour->setVisible(!isCron);
+    ui->label_11->setVisible(!isCron);
+    ui->spinMinute->setVisible(!isCron);
+    ui->labelCronExpression->setVisible(isCron);
+    ui->lineEditCronExpression->setVisible(isCron);
 }
 
 // 浏览"启动命令"文件
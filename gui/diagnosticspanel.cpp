@@ -0,0 +1,178 @@
+#include "diagnosticspanel.h"
+
+#include <QDateTime>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include "tracer.h"
+
+namespace {
+
+enum Rows {
+    MonitorTickRow,
+    SchedulerTickRow,
+    UiLatencyRow,
+    SyscallsRow,
+    StartToReadyRow,
+    StopToExitRow,
+    RecoveryRow,
+    RowCount
+};
+
+QString formatMicros(qint64 us) {
+    if (us < 1000) {
+        return QString::fromUtf8("%1 µs").arg(us);
+    }
+    if (us < 1000 * 1000) {
+        return QString::fromUtf8("%1 ms").arg(us / 1000.0, 0, 'f', 1);
+    }
+    return QString::fromUtf8("%1 秒").arg(us / 1000000.0, 0, 'f', 2);
+}
+
+}  // namespace
+
+DiagnosticsPanel::DiagnosticsPanel(QWidget *parent) : QWidget(parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    m_table = new QTableWidget(RowCount, 6, this);
+    m_table->setHorizontalHeaderLabels(QStringList()
+                                       << QString::fromUtf8("次数")
+                                       << QString::fromUtf8("平均")
+                                       << "P50" << "P90" << "P99"
+                                       << QString::fromUtf8("最大"));
+    m_table->setVerticalHeaderLabels(QStringList()
+                                     << QString::fromUtf8("监控周期耗时")
+                                     << QString::fromUtf8("调度器处理耗时")
+                                     << QString::fromUtf8("界面更新延迟")
+                                     << QString::fromUtf8("每周期系统调用")
+                                     << QString::fromUtf8("服务启动到就绪")
+                                     << QString::fromUtf8("服务停止到退出")
+                                     << QString::fromUtf8("意外退出到恢复"));
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionMode(QAbstractItemView::NoSelection);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    layout->addWidget(m_table, 1);
+
+    QHBoxLayout *bottom = new QHBoxLayout();
+    m_queueLabel = new QLabel(this);
+    m_queueLabel->setWordWrap(true);
+    bottom->addWidget(m_queueLabel, 1);
+    QPushButton *resetButton = new QPushButton(QString::fromUtf8("重置统计"), this);
+    bottom->addWidget(resetButton);
+    m_traceButton = new QPushButton(QString::fromUtf8("记录跟踪"), this);
+    m_traceButton->setCheckable(true);
+    m_traceButton->setChecked(Tracer::isEnabled());
+    bottom->addWidget(m_traceButton);
+    QPushButton *exportButton = new QPushButton(QString::fromUtf8("导出跟踪..."), this);
+    bottom->addWidget(exportButton);
+    layout->addLayout(bottom);
+
+    connect(resetButton, SIGNAL(clicked()), this, SLOT(onResetClicked()));
+    connect(m_traceButton, SIGNAL(toggled(bool)), this,
+            SLOT(onTraceToggled(bool)));
+    connect(exportButton, SIGNAL(clicked()), this, SLOT(onExportTraceClicked()));
+
+    updateDiagnostics(BackendDiagnostics());
+}
+
+void DiagnosticsPanel::updateDiagnostics(const BackendDiagnostics &diagnostics) {
+    if (diagnostics.sentAtUs > 0) {
+        m_uiLatency.record(diagnosticsClockUs() - diagnostics.sentAtUs);
+    }
+
+    // 面板隐藏时只累计延迟，不刷新表格
+    if (!isVisible() && diagnostics.sentAtUs > 0) {
+        return;
+    }
+
+    setRow(MonitorTickRow, diagnostics.monitorTick, Micros);
+    setRow(SchedulerTickRow, diagnostics.schedulerTick, Micros);
+    setRow(UiLatencyRow, m_uiLatency.summary(), Micros);
+    setRow(SyscallsRow, diagnostics.syscallsPerTick, Count);
+    setRow(StartToReadyRow, diagnostics.startToReady, Millis);
+    setRow(StopToExitRow, diagnostics.stopToExit, Millis);
+    setRow(RecoveryRow, diagnostics.recovery, Millis);
+
+    m_queueLabel->setText(
+        QString::fromUtf8("服务 %1 | 待重启 %2 | 等待退出 %3 | "
+                          "排队任务 %4 | 运行中任务 %5 | 等待就绪 %6")
+            .arg(diagnostics.services)
+            .arg(diagnostics.pendingRestarts)
+            .arg(diagnostics.pendingShutdowns)
+            .arg(diagnostics.pendingTasks)
+            .arg(diagnostics.runningTasks)
+            .arg(diagnostics.awaitingReady));
+}
+
+void DiagnosticsPanel::onResetClicked() {
+    m_uiLatency.reset();
+    emit resetRequested();
+}
+
+void DiagnosticsPanel::onTraceToggled(bool enabled) {
+    if (enabled) {
+        Tracer::start();
+    } else {
+        Tracer::stop();
+    }
+}
+
+void DiagnosticsPanel::onExportTraceClicked() {
+    // 停止记录，导出内容到此为止；仍在写入的事件由导出方跳过
+    m_traceButton->setChecked(false);
+
+    QString path = QFileDialog::getSaveFileName(
+        this, QString::fromUtf8("导出跟踪"),
+        QString("processmanager-trace-%1.json")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")),
+        QString::fromUtf8("Chrome trace (*.json)"));
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!Tracer::writeChromeTrace(path, &error)) {
+        QMessageBox::warning(this, QString::fromUtf8("导出跟踪"), error);
+        return;
+    }
+    QMessageBox::information(
+        this, QString::fromUtf8("导出跟踪"),
+        QString::fromUtf8("已导出到 %1，可在 ui.perfetto.dev 或 chrome://tracing 中打开。")
+            .arg(path));
+}
+
+void DiagnosticsPanel::setRow(int row, const LatencySummary &summary,
+                              Unit unit) {
+    QStringList cells;
+    cells << QString::number(summary.count);
+    if (summary.count == 0) {
+        cells << "-" << "-" << "-" << "-" << "-";
+    } else if (unit != Count) {
+        qint64 scale = (unit == Millis) ? 1000 : 1;
+        cells << formatMicros((qint64)summary.mean * scale)
+              << formatMicros(summary.p50 * scale)
+              << formatMicros(summary.p90 * scale)
+              << formatMicros(summary.p99 * scale)
+              << formatMicros(summary.max * scale);
+    } else {
+        cells << QString::number(summary.mean, 'f', 1)
+              << QString::number(summary.p50) << QString::number(summary.p90)
+              << QString::number(summary.p99) << QString::number(summary.max);
+    }
+
+    for (int column = 0; column < cells.count(); ++column) {
+        QTableWidgetItem *item = m_table->item(row, column);
+        if (!item) {
+            item = new QTableWidgetItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_table->setItem(row, column, item);
+        }
+        item->setText(cells.at(column));
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef DIAGNOSTICSPANEL_H
+#define DIAGNOSTICSPANEL_H
+
+#include <QWidget>
+
+#include "backenddiagnostics.h"
+#include "latencyhistogram.h"
+
+class QLabel;
+class QPushButton;
+class QTableWidget;
+
+// 管理器自身的运行状况：后台热点路径的耗时分布、界面收到更新的延迟、
+// 全体服务的启停耗时和各队列深度。
+// 界面更新延迟在本线程测量：诊断信号排在同一周期的所有状态更新之后，
+// 它到达时 ProcessModel 已经处理完该周期的更新。
+// 也在这里开始/停止内部跟踪并导出为 Chrome trace JSON
+class DiagnosticsPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsPanel(QWidget *parent = 0);
+
+signals:
+    void resetRequested();
+
+public slots:
+    void updateDiagnostics(const BackendDiagnostics &diagnostics);
+
+private slots:
+    void onResetClicked();
+    void onTraceToggled(bool enabled);
+    void onExportTraceClicked();
+
+private:
+    enum Unit { Count, Micros, Millis };
+    void setRow(int row, const LatencySummary &summary, Unit unit);
+
+    LatencyHistogram m_uiLatency;  // 微秒
+    QTableWidget *m_table;
+    QLabel *m_queueLabel;
+    QPushButton *m_traceButton;
+};
+
+#endif  // DIAGNOSTICSPANEL_H
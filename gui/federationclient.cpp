@@ -0,0 +1,136 @@
+#include "federationclient.h"
+
+#include <QLocalSocket>
+#include <QTcpSocket>
+#include <QTimer>
+
+namespace {
+
+const int kReconnectMs = 5000;
+
+}  // namespace
+
+FederationClient::FederationClient(const QString &label,
+                                   const Federation::Address &address,
+                                   QObject *parent)
+    : QObject(parent),
+      m_label(label),
+      m_address(address),
+      m_socket(0),
+      m_decoder(0),
+      m_connected(false) {
+    m_host = label.isEmpty() ? address.toString() : label;
+
+    m_reconnectTimer = new QTimer(this);
+    m_reconnectTimer->setSingleShot(true);
+    m_reconnectTimer->setInterval(kReconnectMs);
+    connect(m_reconnectTimer, SIGNAL(timeout()), this, SLOT(connectToPeer()));
+}
+
+FederationClient::~FederationClient() { delete m_decoder; }
+
+QString FederationClient::host() const { return m_host; }
+
+void FederationClient::start() { connectToPeer(); }
+
+void FederationClient::connectToPeer() {
+    if (m_socket) {
+        return;
+    }
+
+    // 每次连接一个新的解码器，丢弃上一个连接残留的半帧
+    delete m_decoder;
+    m_decoder = new FederationDecoder();
+
+    if (m_address.local) {
+        QLocalSocket *socket = new QLocalSocket(this);
+        m_socket = socket;
+        connect(socket, SIGNAL(connected()), this, SLOT(onConnected()));
+        connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+        connect(socket, SIGNAL(error(QLocalSocket::LocalSocketError)), this,
+                SLOT(onDisconnected()));
+        socket->connectToServer(m_address.path, QIODevice::ReadOnly);
+    } else {
+        QTcpSocket *socket = new QTcpSocket(this);
+        m_socket = socket;
+        connect(socket, SIGNAL(connected()), this, SLOT(onConnected()));
+        connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+        connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this,
+                SLOT(onDisconnected()));
+        socket->connectToHost(m_address.host, m_address.port,
+                              QIODevice::ReadOnly);
+    }
+}
+
+void FederationClient::onConnected() {
+    m_connected = true;
+    emit logMessage(QString::fromUtf8("[联合视图] 已连接 %1 (%2)。")
+                        .arg(m_host)
+                        .arg(m_address.toString()));
+}
+
+void FederationClient::onReadyRead() {
+    if (sender() != m_socket) {
+        return;
+    }
+
+    FederationChanges changes;
+    if (!m_decoder->feed(m_socket->readAll(), &changes)) {
+        emit logMessage(QString::fromUtf8("[联合视图] %1 发来的数据无法解析，断开重连。")
+                            .arg(m_host));
+        m_socket->close();
+        onDisconnected();
+        return;
+    }
+
+    if (changes.reset) {
+        // 之前的行全部作废，包括旧主机名下的
+        emit hostReset(m_host);
+        if (m_label.isEmpty() && !m_decoder->host().isEmpty()) {
+            m_host = m_decoder->host();
+        }
+    }
+    if (!changes.removed.isEmpty()) {
+        emit servicesRemoved(m_host, changes.removed);
+    }
+    if (!changes.updated.isEmpty()) {
+        QList<ProcessInfo> services;
+        services.reserve(changes.updated.count());
+        for (QSet<quint32>::const_iterator it = changes.updated.constBegin();
+             it != changes.updated.constEnd(); ++it) {
+            if (!m_decoder->contains(*it)) {
+                continue;
+            }
+            services.append(m_decoder->service(*it));
+            services.last().host = m_host;
+        }
+        emit servicesUpdated(m_host, services);
+    }
+}
+
+void FederationClient::onDisconnected() {
+    // disconnected 与 error 可能先后到达
+    if (!m_socket || (sender() && sender() != m_socket)) {
+        return;
+    }
+
+    if (m_connected) {
+        emit logMessage(QString::fromUtf8("[联合视图] 与 %1 的连接已断开，%2 秒后重连。")
+                            .arg(m_host)
+                            .arg(kReconnectMs / 1000));
+        emit hostReset(m_host);
+    }
+    m_connected = false;
+    m_socket->disconnect(this);
+    m_socket->deleteLater();
+    m_socket = 0;
+    scheduleReconnect();
+}
+
+void FederationClient::scheduleReconnect() {
+    if (!m_reconnectTimer->isActive()) {
+        m_reconnectTimer->start();
+    }
+}
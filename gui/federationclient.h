@@ -0,0 +1,55 @@
+#ifndef FEDERATIONCLIENT_H
+#define FEDERATIONCLIENT_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include "federationprotocol.h"
+
+class QIODevice;
+class QTimer;
+
+// 连接一个远程管理器实例，把它推送的状态转成 ProcessModel 的更新。
+// 运行在界面线程，收到数据后只处理完整的帧；连接断开后每隔几秒重连，
+// 重连后对端重新发送快照。
+class FederationClient : public QObject {
+    Q_OBJECT
+
+public:
+    // label 为表格中显示的主机名；为空时使用对端 Hello 中的主机名
+    FederationClient(const QString &label, const Federation::Address &address,
+                     QObject *parent = 0);
+    ~FederationClient();
+
+    QString host() const;
+    void start();
+
+signals:
+    // 新增或有变化的服务(host 字段已填好)
+    void servicesUpdated(const QString &host, const QList<ProcessInfo> &services);
+    void servicesRemoved(const QString &host, const QStringList &ids);
+    // 连接断开或对端重新发送快照：该主机的服务全部作废
+    void hostReset(const QString &host);
+    void logMessage(const QString &message);
+
+private slots:
+    void connectToPeer();
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    void scheduleReconnect();
+
+    QString m_label;
+    QString m_host;  // 当前使用的主机名
+    Federation::Address m_address;
+    QIODevice *m_socket;
+    FederationDecoder *m_decoder;
+    QTimer *m_reconnectTimer;
+    bool m_connected;
+};
+
+#endif  // FEDERATIONCLIENT_H
@@ -0,0 +1,409 @@
+#include "groupmodel.h"
+
+#include <QColor>
+#include <QFont>
+#include <QMap>
+#include <QTimer>
+
+#include "processmodel.h"
+
+GroupModel::GroupModel(QObject *parent) : QAbstractItemModel(parent) {
+    m_nextKey = 1;  // 0 留给分组行
+
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(0);
+    connect(m_flushTimer, SIGNAL(timeout()), this, SLOT(flushGroupRows()));
+}
+
+GroupModel::Member GroupModel::memberFrom(const ProcessInfo &info) {
+    Member member;
+    member.name = info.name;
+    member.group = info.group;
+    member.state = info.state;
+    member.cpu = qRound64(info.cpuUsage * 100.0);
+    member.mem = qRound64(info.memUsage * 10.0);
+    return member;
+}
+
+void GroupModel::account(Group &group, const Member &member, int sign) {
+    group.cpu += sign * member.cpu;
+    group.mem += sign * member.mem;
+    if (member.state == ProcessState::Running) {
+        group.running += sign;
+    }
+}
+
+// 分组行的 internalId 为0；服务行的 internalId 为所属分组的 key
+QModelIndex GroupModel::index(int row, int column,
+                              const QModelIndex &parent) const {
+    if (row < 0 || column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+    if (!parent.isValid()) {
+        if (row >= m_groups.count()) {
+            return QModelIndex();
+        }
+        return createIndex(row, column, (quintptr)0);
+    }
+    if (parent.internalId() != 0 || parent.row() >= m_groups.count()) {
+        return QModelIndex();
+    }
+    const Group &group = m_groups.at(parent.row());
+    if (row >= group.members.count()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, group.key);
+}
+
+QModelIndex GroupModel::parent(const QModelIndex &child) const {
+    if (!child.isValid() || child.internalId() == 0) {
+        return QModelIndex();
+    }
+    int row = m_groupRowByKey.value(child.internalId(), -1);
+    if (row < 0) {
+        return QModelIndex();
+    }
+    return createIndex(row, 0, (quintptr)0);
+}
+
+int GroupModel::rowCount(const QModelIndex &parent) const {
+    if (!parent.isValid()) {
+        return m_groups.count();
+    }
+    if (parent.internalId() != 0 || parent.column() != 0 ||
+        parent.row() >= m_groups.count()) {
+        return 0;
+    }
+    return m_groups.at(parent.row()).members.count();
+}
+
+int GroupModel::columnCount(const QModelIndex & /*parent*/) const {
+    return ColumnCount;
+}
+
+QString GroupModel::groupAt(const QModelIndex &index) const {
+    if (!index.isValid()) {
+        return QString();
+    }
+    int row = index.internalId() == 0
+                  ? index.row()
+                  : m_groupRowByKey.value(index.internalId(), -1);
+    if (row < 0 || row >= m_groups.count()) {
+        return QString();
+    }
+    return m_groups.at(row).name;
+}
+
+QVariant GroupModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    // --- 分组行 ---
+    if (index.internalId() == 0) {
+        if (index.row() >= m_groups.count()) {
+            return QVariant();
+        }
+        const Group &group = m_groups.at(index.row());
+        int total = group.members.count();
+
+        if (role == Qt::DisplayRole) {
+            switch (index.column()) {
+                case NameColumn:
+                    return group.name;
+                case RunningColumn:
+                    return QString("%1/%2").arg(group.running).arg(total);
+                case CpuColumn:
+                    return QString::number(group.cpu / 100.0, 'f', 2);
+                case MemColumn:
+                    return QString::number(group.mem / 10.0, 'f', 1);
+                default:
+                    return QVariant();
+            }
+        }
+        if (role == Qt::FontRole && index.column() == NameColumn) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        if (role == Qt::ForegroundRole && index.column() == RunningColumn) {
+            if (group.running == total) return QColor(46, 204, 113);  // 全部运行
+            if (group.running == 0) return QColor(231, 76, 60);
+            return QColor(230, 126, 34);  // 部分运行
+        }
+        return QVariant();
+    }
+
+    // --- 服务行 ---
+    int groupRow = m_groupRowByKey.value(index.internalId(), -1);
+    if (groupRow < 0 || index.row() >= m_groups.at(groupRow).members.count()) {
+        return QVariant();
+    }
+    const QString &id = m_groups.at(groupRow).members.at(index.row());
+    QHash<QString, Member>::const_iterator it = m_members.constFind(id);
+    if (it == m_members.constEnd()) {
+        return QVariant();
+    }
+    const Member &member = it.value();
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+            case NameColumn:
+                return member.name;
+            case RunningColumn:
+                return ProcessModel::stateDisplayName(member.state);
+            case CpuColumn:
+                return QString::number(member.cpu / 100.0, 'f', 2);
+            case MemColumn:
+                return QString::number(member.mem / 10.0, 'f', 1);
+            default:
+                return QVariant();
+        }
+    }
+    if (role == Qt::ToolTipRole && index.column() == NameColumn) {
+        return id;
+    }
+    if (role == Qt::ForegroundRole && index.column() == RunningColumn) {
+        return ProcessModel::stateColor(member.state);
+    }
+    return QVariant();
+}
+
+QVariant GroupModel::headerData(int section, Qt::Orientation orientation,
+                                int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QVariant();
+    }
+    switch (section) {
+        case NameColumn:
+            return QString::fromUtf8("分组 / 服务");
+        case RunningColumn:
+            return QString::fromUtf8("运行/总数");
+        case CpuColumn:
+            return QString::fromUtf8("CPU (%)");
+        case MemColumn:
+            return QString::fromUtf8("内存 (MB)");
+        default:
+            return QVariant();
+    }
+}
+
+void GroupModel::updateProcessList(const QList<ProcessInfo> &processes) {
+    // 整体加载时直接求和，之后只做增量
+    QMap<QString, QStringList> byGroup;
+    beginResetModel();
+    m_groups.clear();
+    m_groupRowByName.clear();
+    m_groupRowByKey.clear();
+    m_members.clear();
+    m_memberRow.clear();
+    m_dirtyGroups.clear();
+
+    for (int i = 0; i < processes.count(); ++i) {
+        const ProcessInfo &p = processes.at(i);
+        if (p.group.isEmpty() || !p.host.isEmpty()) {
+            continue;
+        }
+        m_members.insert(p.id, memberFrom(p));
+        byGroup[p.group].append(p.id);
+    }
+
+    for (QMap<QString, QStringList>::const_iterator it = byGroup.constBegin();
+         it != byGroup.constEnd(); ++it) {
+        Group group;
+        group.key = m_nextKey++;
+        group.name = it.key();
+        group.members = it.value();
+        group.cpu = 0;
+        group.mem = 0;
+        group.running = 0;
+        for (int i = 0; i < group.members.count(); ++i) {
+            account(group, m_members.value(group.members.at(i)), 1);
+        }
+        m_groups.append(group);
+        reindexMembers(group, 0);
+    }
+    reindexGroups(0);
+    endResetModel();
+}
+
+void GroupModel::updateProcessStatus(const QString &id,
+                                     ProcessState::State state, qint64 /*pid*/,
+                                     double cpu, double mem) {
+    // 不属于任何分组的服务在这里就返回，代价是一次哈希查找
+    QHash<QString, Member>::iterator it = m_members.find(id);
+    if (it == m_members.end()) {
+        return;
+    }
+
+    Member updated = it.value();
+    updated.state = state;
+    updated.cpu = qRound64(cpu * 100.0);
+    updated.mem = qRound64(mem * 10.0);
+    if (updated.state == it->state && updated.cpu == it->cpu &&
+        updated.mem == it->mem) {
+        return;
+    }
+
+    int groupRow = m_groupRowByName.value(it->group, -1);
+    if (groupRow < 0) {
+        return;
+    }
+    Group &group = m_groups[groupRow];
+    account(group, it.value(), -1);
+    account(group, updated, 1);
+    it.value() = updated;
+
+    int row = m_memberRow.value(id);
+    QModelIndex parent = index(groupRow, 0);
+    emit dataChanged(index(row, RunningColumn, parent),
+                     index(row, MemColumn, parent));
+    markDirty(group);
+}
+
+void GroupModel::addProcess(const ProcessInfo &info) {
+    if (m_members.contains(info.id)) {
+        onServiceUpdated(info);
+        return;
+    }
+    if (!info.group.isEmpty() && info.host.isEmpty()) {
+        insertMember(info.id, memberFrom(info));
+    }
+}
+
+void GroupModel::onServiceDeleted(const QString &id) {
+    removeMember(id);
+}
+
+void GroupModel::onServiceUpdated(const ProcessInfo &info) {
+    Member updated = memberFrom(info);
+    QHash<QString, Member>::iterator it = m_members.find(info.id);
+
+    // 分组没变：原地替换
+    if (it != m_members.end() && it->group == updated.group) {
+        int groupRow = m_groupRowByName.value(updated.group, -1);
+        if (groupRow < 0) {
+            return;
+        }
+        Group &group = m_groups[groupRow];
+        account(group, it.value(), -1);
+        account(group, updated, 1);
+        it.value() = updated;
+
+        int row = m_memberRow.value(info.id);
+        QModelIndex parent = index(groupRow, 0);
+        emit dataChanged(index(row, NameColumn, parent),
+                         index(row, MemColumn, parent));
+        markDirty(group);
+        return;
+    }
+
+    // 换了分组(或加入、移出分组)：从旧分组移除，再加入新分组
+    removeMember(info.id);
+    if (!updated.group.isEmpty() && info.host.isEmpty()) {
+        insertMember(info.id, updated);
+    }
+}
+
+void GroupModel::insertMember(const QString &id, const Member &member) {
+    int groupRow = m_groupRowByName.value(member.group, -1);
+    if (groupRow < 0) {
+        // 分组按名称排序；分组数量不多，顺序查找插入位置即可
+        groupRow = 0;
+        while (groupRow < m_groups.count() &&
+               m_groups.at(groupRow).name < member.group) {
+            ++groupRow;
+        }
+
+        Group group;
+        group.key = m_nextKey++;
+        group.name = member.group;
+        group.cpu = 0;
+        group.mem = 0;
+        group.running = 0;
+
+        beginInsertRows(QModelIndex(), groupRow, groupRow);
+        m_groups.insert(groupRow, group);
+        reindexGroups(groupRow);
+        endInsertRows();
+    }
+
+    Group &group = m_groups[groupRow];
+    int row = group.members.count();
+    beginInsertRows(index(groupRow, 0), row, row);
+    group.members.append(id);
+    m_members.insert(id, member);
+    m_memberRow.insert(id, row);
+    account(group, member, 1);
+    endInsertRows();
+    markDirty(group);
+}
+
+void GroupModel::removeMember(const QString &id) {
+    QHash<QString, Member>::iterator it = m_members.find(id);
+    if (it == m_members.end()) {
+        return;
+    }
+    int groupRow = m_groupRowByName.value(it->group, -1);
+    if (groupRow < 0) {
+        m_members.erase(it);
+        return;
+    }
+
+    Group &group = m_groups[groupRow];
+    int row = m_memberRow.value(id);
+    beginRemoveRows(index(groupRow, 0), row, row);
+    account(group, it.value(), -1);
+    group.members.removeAt(row);
+    m_members.erase(it);
+    m_memberRow.remove(id);
+    reindexMembers(group, row);
+    endRemoveRows();
+
+    if (!group.members.isEmpty()) {
+        markDirty(group);
+        return;
+    }
+
+    // 最后一个服务移出后分组行也删除
+    beginRemoveRows(QModelIndex(), groupRow, groupRow);
+    m_dirtyGroups.remove(group.key);
+    m_groupRowByName.remove(group.name);
+    m_groupRowByKey.remove(group.key);
+    m_groups.removeAt(groupRow);
+    reindexGroups(groupRow);
+    endRemoveRows();
+}
+
+void GroupModel::markDirty(const Group &group) {
+    m_dirtyGroups.insert(group.key);
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+// 一个监控周期的状态更新连续到达，分组行在它们全部处理完之后才通知视图
+void GroupModel::flushGroupRows() {
+    for (QSet<quintptr>::const_iterator it = m_dirtyGroups.constBegin();
+         it != m_dirtyGroups.constEnd(); ++it) {
+        int row = m_groupRowByKey.value(*it, -1);
+        if (row >= 0) {
+            emit dataChanged(index(row, RunningColumn), index(row, MemColumn));
+        }
+    }
+    m_dirtyGroups.clear();
+}
+
+void GroupModel::reindexGroups(int firstRow) {
+    for (int row = firstRow; row < m_groups.count(); ++row) {
+        m_groupRowByName.insert(m_groups.at(row).name, row);
+        m_groupRowByKey.insert(m_groups.at(row).key, row);
+    }
+}
+
+void GroupModel::reindexMembers(const Group &group, int firstRow) {
+    for (int row = firstRow; row < group.members.count(); ++row) {
+        m_memberRow.insert(group.members.at(row), row);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef GROUPMODEL_H
+#define GROUPMODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+
+#include "../core/processinfo.h"
+
+class QTimer;
+
+// 分组视图的两层模型：第一层是分组，第二层是组内的服务(只含本机、设置了 group 的服务)。
+// 分组的CPU、内存和运行数不逐周期重新求和：每个服务记住自己上次计入的量，
+// 状态更新时只把差值加到所属分组上。累计值用整数(CPU 0.01%，内存 0.1MB)，
+// 反复加减不会积累浮点误差。同一轮事件中变化的分组行只通知一次。
+class GroupModel : public QAbstractItemModel {
+    Q_OBJECT
+
+public:
+    enum Columns { NameColumn, RunningColumn, CpuColumn, MemColumn, ColumnCount };
+
+    explicit GroupModel(QObject *parent = 0);
+
+    QModelIndex index(int row, int column,
+                      const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &child) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const;
+
+    // 分组行返回分组名，服务行返回所属分组
+    QString groupAt(const QModelIndex &index) const;
+
+public slots:
+    void updateProcessList(const QList<ProcessInfo> &processes);
+    void updateProcessStatus(const QString &id, ProcessState::State state,
+                             qint64 pid, double cpu, double mem);
+    void addProcess(const ProcessInfo &info);
+    void onServiceDeleted(const QString &id);
+    void onServiceUpdated(const ProcessInfo &info);
+
+private slots:
+    void flushGroupRows();
+
+private:
+    struct Member {
+        QString name;
+        QString group;
+        ProcessState::State state;
+        qint64 cpu;  // 0.01%
+        qint64 mem;  // 0.1MB
+    };
+
+    struct Group {
+        quintptr key;  // 服务行的 internalId，分组行号变化时不变
+        QString name;
+        QStringList members;  // 服务ID，按加入顺序
+        qint64 cpu;
+        qint64 mem;
+        int running;  // Running 状态的服务数；不含探测结果，列标题为"运行/总数"
+    };
+
+    static Member memberFrom(const ProcessInfo &info);
+    // sign 为 1 时计入分组，为 -1 时扣除
+    static void account(Group &group, const Member &member, int sign);
+
+    void insertMember(const QString &id, const Member &member);
+    void removeMember(const QString &id);
+    void markDirty(const Group &group);
+    void reindexGroups(int firstRow);
+    void reindexMembers(const Group &group, int firstRow);
+
+    QList<Group> m_groups;  // 按名称排序
+    QHash<QString, int> m_groupRowByName;
+    QHash<quintptr, int> m_groupRowByKey;
+    quintptr m_nextKey;
+
+    QHash<QString, Member> m_members;   // 只含有分组的服务
+    QHash<QString, int> m_memberRow;    // 服务ID -> 在分组内的行号
+
+    QSet<quintptr> m_dirtyGroups;
+    QTimer *m_flushTimer;
+};
+
+#endif  // GROUPMODEL_H
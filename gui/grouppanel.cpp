@@ -0,0 +1,91 @@
+#include "grouppanel.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QItemSelectionModel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTreeView>
+#include <QVBoxLayout>
+
+#include "groupmodel.h"
+
+GroupPanel::GroupPanel(GroupModel *model, QWidget *parent)
+    : QWidget(parent), m_model(model) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    m_view = new QTreeView(this);
+    m_view->setModel(m_model);
+    m_view->setUniformRowHeights(true);
+    m_view->setAllColumnsShowFocus(true);
+    m_view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_view->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_view->header()->setStretchLastSection(false);
+    m_view->header()->setSectionResizeMode(GroupModel::NameColumn,
+                                           QHeaderView::Stretch);
+    layout->addWidget(m_view, 1);
+
+    QHBoxLayout *buttons = new QHBoxLayout();
+    m_startButton = new QPushButton(QString::fromUtf8("启动分组"), this);
+    m_stopButton = new QPushButton(QString::fromUtf8("停止分组"), this);
+    m_restartButton = new QPushButton(QString::fromUtf8("重启分组"), this);
+    buttons->addWidget(m_startButton);
+    buttons->addWidget(m_stopButton);
+    buttons->addWidget(m_restartButton);
+    buttons->addStretch(1);
+    layout->addLayout(buttons);
+
+    connect(m_view->selectionModel(),
+            SIGNAL(selectionChanged(QItemSelection, QItemSelection)), this,
+            SLOT(onSelectionChanged()));
+    // 重新加载后选择被清空
+    connect(m_model, SIGNAL(modelReset()), this, SLOT(onSelectionChanged()));
+    connect(m_startButton, SIGNAL(clicked()), this, SLOT(onStartClicked()));
+    connect(m_stopButton, SIGNAL(clicked()), this, SLOT(onStopClicked()));
+    connect(m_restartButton, SIGNAL(clicked()), this, SLOT(onRestartClicked()));
+
+    onSelectionChanged();
+}
+
+QString GroupPanel::selectedGroup() const {
+    QModelIndexList rows = m_view->selectionModel()->selectedRows();
+    if (rows.isEmpty()) {
+        return QString();
+    }
+    return m_model->groupAt(rows.first());
+}
+
+void GroupPanel::onSelectionChanged() {
+    bool hasGroup = !selectedGroup().isEmpty();
+    m_startButton->setEnabled(hasGroup);
+    m_stopButton->setEnabled(hasGroup);
+    m_restartButton->setEnabled(hasGroup);
+}
+
+void GroupPanel::onStartClicked() {
+    QString group = selectedGroup();
+    if (!group.isEmpty()) {
+        emit groupOperationRequested("start", group);
+    }
+}
+
+void GroupPanel::onStopClicked() {
+    QString group = selectedGroup();
+    if (group.isEmpty()) {
+        return;
+    }
+    if (QMessageBox::question(
+            this, QString::fromUtf8("停止分组"),
+            QString::fromUtf8("确定要停止分组 '%1' 中的所有服务吗？").arg(group)) !=
+        QMessageBox::Yes) {
+        return;
+    }
+    emit groupOperationRequested("stop", group);
+}
+
+void GroupPanel::onRestartClicked() {
+    QString group = selectedGroup();
+    if (!group.isEmpty()) {
+        emit groupOperationRequested("restart", group);
+    }
+}
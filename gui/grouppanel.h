@@ -0,0 +1,38 @@
+#ifndef GROUPPANEL_H
+#define GROUPPANEL_H
+
+#include <QWidget>
+
+class GroupModel;
+class QPushButton;
+class QTreeView;
+
+// 按分组查看服务：分组行可折叠，显示组内运行数/总数和CPU、内存合计；
+// 选中分组(或组内任一服务)后可整组启动、停止、重启
+class GroupPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit GroupPanel(GroupModel *model, QWidget *parent = 0);
+
+signals:
+    // action 为 "start"/"stop"/"restart"
+    void groupOperationRequested(const QString &action, const QString &group);
+
+private slots:
+    void onSelectionChanged();
+    void onStartClicked();
+    void onStopClicked();
+    void onRestartClicked();
+
+private:
+    QString selectedGroup() const;
+
+    GroupModel *m_model;
+    QTreeView *m_view;
+    QPushButton *m_startButton;
+    QPushButton *m_stopButton;
+    QPushButton *m_restartButton;
+};
+
+#endif  // GROUPPANEL_H
@@ -1,7 +1,9 @@
 #include "mainwindow.h"
 
+#include <QCloseEvent>
 #include <QCoreApplication>  // 【新增】用于获取程序路径
 #include <QDebug>
+#include <QDockWidget>
 #include <QFile>  // 【新增】用于文件写入
 #include <QFileInfo>
 #include <QItemSelectionModel>
@@ -10,12 +12,22 @@
 #include <QJsonObject>    // 【新增】
 #include <QMessageBox>
 #include <QMetaType>
+#include <QSettings>
 #include <QThread>
 
+#include <algorithm>
+
 #include "addservicedialog.h"  // 【新增】包含对话框的头文件
 #include "backendworker.h"
+#include "diagnosticspanel.h"
+#include "federationclient.h"
+#include "groupmodel.h"
+#include "grouppanel.h"
+#include "processfilterproxy.h"
 #include "processinfo.h"
 #include "processmodel.h"
+#include "runhistorydialog.h"
+#include "tracer.h"
 #include "ui_mainwindow.h"
 // MetaType registration
 class MetaTypeRegistrar {
@@ -23,17 +35,45 @@ public:
     MetaTypeRegistrar() {
         qRegisterMetaType<QList<ProcessInfo> >("QList<ProcessInfo>");
         qRegisterMetaType<ProcessInfo>("ProcessInfo");
+        qRegisterMetaType<QList<RunRecord> >("QList<RunRecord>");
+        qRegisterMetaType<ProcessState::State>("ProcessState::State");
+        qRegisterMetaType<BackendDiagnostics>("BackendDiagnostics");
+        qRegisterMetaType<LatencySummary>("LatencySummary");
     }
 };
 static MetaTypeRegistrar registrar;
 
+namespace {
+
+QString bulkActionName(const QString &action) {
+    if (action == "start") return QString::fromUtf8("启动");
+    if (action == "stop") return QString::fromUtf8("停止");
+    if (action == "restart") return QString::fromUtf8("重启");
+    if (action == "delete") return QString::fromUtf8("删除");
+    return action;
+}
+
+}  // namespace
+
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), ui(new Ui::MainWindow) {
+    : QMainWindow(parent),
+      ui(new Ui::MainWindow),
+      m_closingAfterStopAll(false),
+      m_readyToClose(false) {
     ui->setupUi(this);
+    Tracer::setThreadName("GUI");
 
     // --- Model, Thread, Worker setup ---
     m_processModel = new ProcessModel(this);
-    ui->tableView->setModel(m_processModel);
+    // 视图通过代理显示，排序和过滤都不改动源模型；
+    // 凡是从视图拿到的行号都要先经 sourceRow() 映射回源模型
+    m_proxyModel = new ProcessFilterProxy(this);
+    m_proxyModel->setSourceModel(m_processModel);
+    ui->tableView->setModel(m_proxyModel);
+    ui->tableView->setSortingEnabled(true);
+    ui->tableView->sortByColumn(0, Qt::AscendingOrder);
+    ui->tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ui->tableView->setSelectionMode(QAbstractItemView::ExtendedSelection);
 
     m_workerThread = new QThread(this);
     m_backendWorker = new BackendWorker();
@@ -54,13 +94,38 @@ MainWindow::MainWindow(QWidget *parent)
     ui->btnStop->setIconSize(QSize(16, 16));
     ui->btnRestart->setIconSize(QSize(16, 16));
 
+    // 诊断面板停靠在底部，默认隐藏
+    m_diagnosticsPanel = new DiagnosticsPanel(this);
+    m_diagnosticsDock = new QDockWidget(QString::fromUtf8("诊断"), this);
+    m_diagnosticsDock->setObjectName("diagnosticsDock");
+    m_diagnosticsDock->setWidget(m_diagnosticsPanel);
+    addDockWidget(Qt::BottomDockWidgetArea, m_diagnosticsDock);
+    m_diagnosticsDock->hide();
+
+    // 分组视图停靠在右侧，默认隐藏
+    m_groupModel = new GroupModel(this);
+    m_groupPanel = new GroupPanel(m_groupModel, this);
+    m_groupsDock = new QDockWidget(QString::fromUtf8("分组"), this);
+    m_groupsDock->setObjectName("groupsDock");
+    m_groupsDock->setWidget(m_groupPanel);
+    addDockWidget(Qt::RightDockWidgetArea, m_groupsDock);
+    m_groupsDock->hide();
+
+    ui->filterEdit->setPlaceholderText(
+        QString::fromUtf8("按 ID、名称、命令、主机或分组过滤..."));
+    ui->filterEdit->setClearButtonEnabled(true);
+
     // --- Signal/Slot Connections ---
+    connect(ui->filterEdit, SIGNAL(textChanged(QString)), m_proxyModel,
+            SLOT(setFilterText(QString)));
     connect(m_backendWorker, SIGNAL(logMessage(QString)), this,
             SLOT(onLogMessageReceived(QString)));
     connect(m_workerThread, SIGNAL(started()), m_backendWorker,
             SLOT(performInitialSetup()));
     connect(m_backendWorker, SIGNAL(processListLoaded(QList<ProcessInfo>)),
             m_processModel, SLOT(updateProcessList(QList<ProcessInfo>)));
+    connect(m_backendWorker, SIGNAL(processListLoaded(QList<ProcessInfo>)),
+            m_groupModel, SLOT(updateProcessList(QList<ProcessInfo>)));
     connect(m_workerThread, SIGNAL(finished()), m_backendWorker,
             SLOT(deleteLater()));
 
@@ -81,25 +146,53 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(
         m_backendWorker,
-        SIGNAL(processStatusChanged(QString, QString, qint64, double, double)),
+        SIGNAL(processStatusChanged(QString, ProcessState::State, qint64,
+                                    double, double)),
         m_processModel,
-        SLOT(updateProcessStatus(QString, QString, qint64, double, double)));
+        SLOT(updateProcessStatus(QString, ProcessState::State, qint64, double,
+                                 double)));
+    connect(
+        m_backendWorker,
+        SIGNAL(processStatusChanged(QString, ProcessState::State, qint64,
+                                    double, double)),
+        m_groupModel,
+        SLOT(updateProcessStatus(QString, ProcessState::State, qint64, double,
+                                 double)));
 
     // 【关键修复2】系统指标更新连接
     connect(m_backendWorker, SIGNAL(systemMetricsUpdated(double, double)), this,
             SLOT(onSystemMetricsUpdated(double, double)));
 
+    connect(m_backendWorker, SIGNAL(diagnosticsUpdated(BackendDiagnostics)),
+            m_diagnosticsPanel, SLOT(updateDiagnostics(BackendDiagnostics)));
+    connect(m_diagnosticsPanel, SIGNAL(resetRequested()), m_backendWorker,
+            SLOT(resetDiagnostics()));
+    connect(ui->btnDiagnostics, SIGNAL(toggled(bool)), m_diagnosticsDock,
+            SLOT(setVisible(bool)));
+    connect(m_diagnosticsDock, SIGNAL(visibilityChanged(bool)),
+            ui->btnDiagnostics, SLOT(setChecked(bool)));
+    connect(ui->btnGroups, SIGNAL(toggled(bool)), m_groupsDock,
+            SLOT(setVisible(bool)));
+    connect(m_groupsDock, SIGNAL(visibilityChanged(bool)), ui->btnGroups,
+            SLOT(setChecked(bool)));
+    connect(m_groupPanel, SIGNAL(groupOperationRequested(QString, QString)),
+            m_backendWorker, SLOT(runGroupOperation(QString, QString)));
+
     connect(this, SIGNAL(serviceAddedRequest(QString)), m_backendWorker,
             SLOT(onServiceAdded(QString)));
 
     connect(m_backendWorker, SIGNAL(processInfoAdded(ProcessInfo)),
             m_processModel, SLOT(addProcess(ProcessInfo)));
+    connect(m_backendWorker, SIGNAL(processInfoAdded(ProcessInfo)),
+            m_groupModel, SLOT(addProcess(ProcessInfo)));
 
     connect(this, SIGNAL(deleteServiceRequested(QString)), m_backendWorker,
             SLOT(onDeleteServiceRequested(QString)));
 
     connect(m_backendWorker, SIGNAL(serviceDeleted(QString)), m_processModel,
             SLOT(onServiceDeleted(QString)));
+    connect(m_backendWorker, SIGNAL(serviceDeleted(QString)), m_groupModel,
+            SLOT(onServiceDeleted(QString)));
 
     connect(this, SIGNAL(editServiceRequested(QString)), m_backendWorker,
             SLOT(onEditServiceRequested(QString)));
@@ -111,9 +204,42 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(m_backendWorker, SIGNAL(serviceInfoUpdated(ProcessInfo)),
             m_processModel, SLOT(onServiceUpdated(ProcessInfo)));
+    connect(m_backendWorker, SIGNAL(serviceInfoUpdated(ProcessInfo)),
+            m_groupModel, SLOT(onServiceUpdated(ProcessInfo)));
+
+    connect(this, SIGNAL(runHistoryRequested(QString)), m_backendWorker,
+            SLOT(onRunHistoryRequested(QString)));
+    connect(m_backendWorker,
+            SIGNAL(runHistoryReady(QString, QList<RunRecord>)), this,
+            SLOT(onRunHistoryReady(QString, QList<RunRecord>)));
+
+    connect(m_backendWorker, SIGNAL(restartCountChanged(QString, int)),
+            m_processModel, SLOT(updateRestartCount(QString, int)));
+    connect(m_backendWorker,
+            SIGNAL(lifecycleTimingsChanged(QString, LatencySummary,
+                                           LatencySummary)),
+            m_processModel,
+            SLOT(updateLifecycleTimings(QString, LatencySummary,
+                                        LatencySummary)));
+
+    connect(this, SIGNAL(bulkOperationRequested(QString, QStringList)),
+            m_backendWorker, SLOT(runBulkOperation(QString, QStringList)));
+    connect(m_backendWorker,
+            SIGNAL(bulkProgress(QString, QString, int, int, int, int)), this,
+            SLOT(onBulkProgress(QString, QString, int, int, int, int)));
+    connect(m_backendWorker,
+            SIGNAL(bulkFinished(QString, QString, int, QStringList)), this,
+            SLOT(onBulkFinished(QString, QString, int, QStringList)));
+
+    connect(this, SIGNAL(stopAllRequested()), m_backendWorker,
+            SLOT(stopAllProcesses()));
+    connect(m_backendWorker, SIGNAL(allProcessesStopped()), this,
+            SLOT(onAllProcessesStopped()));
     // --- Start Thread ---
     m_workerThread->start();
 
+    startFederationClients();
+
     onLogMessageReceived(QString::fromUtf8("应用程序启动。主线程UI已加载。"));
     onLogMessageReceived(QString::fromUtf8("正在准备启动后台监控线程..."));
 }
@@ -126,10 +252,101 @@ MainWindow::~MainWindow() {
     delete ui;
 }
 
+void MainWindow::closeEvent(QCloseEvent *event) {
+    if (m_readyToClose || !m_processModel->hasActiveProcesses()) {
+        event->accept();
+        return;
+    }
+
+    event->ignore();
+    if (m_closingAfterStopAll) {
+        return;  // 已经在等待全部停止
+    }
+
+    QMessageBox box(this);
+    box.setIcon(QMessageBox::Question);
+    box.setWindowTitle(QString::fromUtf8("退出"));
+    box.setText(QString::fromUtf8("仍有服务在运行。退出前是否停止所有服务？"));
+    QPushButton *stopButton = box.addButton(QString::fromUtf8("全部停止后退出"),
+                                            QMessageBox::AcceptRole);
+    QPushButton *leaveButton = box.addButton(
+        QString::fromUtf8("保持运行并退出"), QMessageBox::DestructiveRole);
+    box.addButton(QMessageBox::Cancel);
+    box.exec();
+
+    if (box.clickedButton() == leaveButton) {
+        m_readyToClose = true;
+        close();
+    } else if (box.clickedButton() == stopButton) {
+        m_closingAfterStopAll = true;
+        ui->centralwidget->setEnabled(false);
+        onLogMessageReceived(QString::fromUtf8("正在停止所有服务，完成后退出..."));
+        emit stopAllRequested();
+    }
+}
+
+void MainWindow::on_btnStopAll_clicked() {
+    if (QMessageBox::question(this, QString::fromUtf8("全部停止"),
+                              QString::fromUtf8("确定要停止所有服务吗？")) !=
+        QMessageBox::Yes) {
+        return;
+    }
+    ui->btnStopAll->setEnabled(false);
+    emit stopAllRequested();
+}
+
+void MainWindow::onAllProcessesStopped() {
+    ui->btnStopAll->setEnabled(true);
+    if (m_closingAfterStopAll) {
+        m_readyToClose = true;
+        close();
+    }
+}
+
 void MainWindow::onLogMessageReceived(const QString &message) {
     ui->logOutput->appendPlainText(message);
 }
 
+void MainWindow::startFederationClients() {
+    // manager.ini 中 federation/peers 为逗号分隔的 "显示名=地址" 或 "地址"，
+    // 例如 web-01=tcp:10.0.0.11:7811, unix:/tmp/pm-b.sock
+    QSettings settings(QCoreApplication::applicationDirPath() + "/manager.ini",
+                       QSettings::IniFormat);
+    QStringList peers = settings.value("federation/peers").toStringList();
+    for (int i = 0; i < peers.count(); ++i) {
+        QString entry = peers.at(i).trimmed();
+        if (entry.isEmpty()) {
+            continue;
+        }
+        QString label;
+        int equals = entry.indexOf('=');
+        if (equals >= 0) {
+            label = entry.left(equals).trimmed();
+            entry = entry.mid(equals + 1).trimmed();
+        }
+
+        Federation::Address address;
+        QString error;
+        if (!Federation::parseAddress(entry, &address, &error)) {
+            onLogMessageReceived(
+                QString::fromUtf8("[错误] 联合视图配置无效: %1").arg(error));
+            continue;
+        }
+
+        FederationClient *client = new FederationClient(label, address, this);
+        connect(client, SIGNAL(logMessage(QString)), this,
+                SLOT(onLogMessageReceived(QString)));
+        connect(client, SIGNAL(servicesUpdated(QString, QList<ProcessInfo>)),
+                m_processModel,
+                SLOT(updateHostServices(QString, QList<ProcessInfo>)));
+        connect(client, SIGNAL(servicesRemoved(QString, QStringList)),
+                m_processModel, SLOT(removeHostServices(QString, QStringList)));
+        connect(client, SIGNAL(hostReset(QString)), m_processModel,
+                SLOT(removeHost(QString)));
+        client->start();
+    }
+}
+
 void MainWindow::onInitialSetupCompleted() {
     // This slot is currently unused
 }
@@ -156,6 +373,7 @@ void MainWindow::onSelectionChanged() {
     ui->btnRestart->setEnabled(!noSelection);
     ui->btnEdit->setEnabled(!noSelection);    // 【新增】
     ui->btnDelete->setEnabled(!noSelection);  // 【新增】
+    ui->btnHistory->setEnabled(!noSelection);  // 任何状态下都可查看历史
 
     if (noSelection) {
         // 如果没有任何选中项，全部禁用并直接返回
@@ -167,44 +385,103 @@ void MainWindow::onSelectionChanged() {
         return;
     }
 
-    // 获取选中行的状态
-    QModelIndex statusIndex =
-        m_processModel->index(selectedIndexes.first().row(), 3);  // 第3列是状态
-    QString status =
-        m_processModel->data(statusIndex, Qt::DisplayRole).toString();
+    // 多选时，只要有一个选中的服务可以执行某操作，就启用对应按钮；
+    // 编辑和查看历史只针对单个服务。远程主机的服务只能查看，不参与判断
+    QModelIndexList rows = ui->tableView->selectionModel()->selectedRows();
+    bool anyIdle = false;
+    bool anyRunning = false;
+    bool allIdle = true;
+    int localRows = 0;
+    for (int i = 0; i < rows.count(); ++i) {
+        int row = sourceRow(rows.at(i));
+        if (m_processModel->isRemote(row)) {
+            continue;
+        }
+        ++localRows;
+        ProcessState::State state = m_processModel->stateAt(row);
+        // 只有在“已停止”、“错误”或“已隔离”状态下，才允许启动、编辑和删除
+        bool idle = ProcessState::isIdle(state);
+        anyIdle = anyIdle || idle;
+        allIdle = allIdle && idle;
+        anyRunning = anyRunning || state == ProcessState::Running;
+    }
+    bool single = (localRows == 1 && rows.count() == 1);
+
+    ui->btnStart->setEnabled(anyIdle);
+    ui->btnStop->setEnabled(anyRunning);
+    ui->btnRestart->setEnabled(anyRunning);
+    ui->btnEdit->setEnabled(single && allIdle);
+    ui->btnDelete->setEnabled(anyIdle);
+    ui->btnHistory->setEnabled(single);
+}
 
-    // 根据状态设置按钮的可用性
-    if (status == "Stopped" || status == "Error") {
-        ui->btnStart->setEnabled(true);
-        ui->btnStop->setEnabled(false);
-        ui->btnRestart->setEnabled(false);
-        // 【核心逻辑】只有在“已停止”或“错误”状态下，才允许编辑和删除
-        ui->btnEdit->setEnabled(true);
-        ui->btnDelete->setEnabled(true);
-    } else if (status == "Running") {
-        ui->btnStart->setEnabled(false);
-        ui->btnStop->setEnabled(true);
-        ui->btnRestart->setEnabled(true);
-        // 运行时不允许编辑和删除
-        ui->btnEdit->setEnabled(false);
-        ui->btnDelete->setEnabled(false);
-    } else {  // 处于 "Starting..." 或 "Stopping..." 等中间状态
-        ui->btnStart->setEnabled(false);
-        ui->btnStop->setEnabled(false);
-        ui->btnRestart->setEnabled(false);
-        ui->btnEdit->setEnabled(false);
-        ui->btnDelete->setEnabled(false);
+int MainWindow::sourceRow(const QModelIndex &viewIndex) const {
+    return m_proxyModel->mapToSource(viewIndex).row();
+}
+
+QStringList MainWindow::selectedProcessIds() const {
+    // 按表格中显示的顺序(排序、过滤之后)
+    QModelIndexList rows = ui->tableView->selectionModel()->selectedRows();
+    std::sort(rows.begin(), rows.end());
+
+    QStringList ids;
+    for (int i = 0; i < rows.count(); ++i) {
+        QString id = m_processModel->getProcessId(sourceRow(rows.at(i)));
+        if (!id.isEmpty()) {
+            ids.append(id);
+        }
+    }
+    return ids;
+}
+
+void MainWindow::onBulkProgress(const QString &action, const QString &label,
+                                int done, int failed, int running, int total) {
+    QString title = bulkActionName(action);
+    if (!label.isEmpty()) {
+        title = QString("%1 %2").arg(label).arg(title);
+    }
+    ui->statusbar->showMessage(
+        QString::fromUtf8("批量%1: %2/%3 完成，%4 失败，%5 进行中")
+            .arg(title)
+            .arg(done)
+            .arg(total)
+            .arg(failed)
+            .arg(running));
+}
+
+void MainWindow::onBulkFinished(const QString &action, const QString &label,
+                                int succeeded, const QStringList &failures) {
+    QString title = bulkActionName(action);
+    if (!label.isEmpty()) {
+        title = QString("%1 %2").arg(label).arg(title);
+    }
+    QString summary = QString::fromUtf8("批量%1完成：成功 %2，失败 %3")
+                          .arg(title)
+                          .arg(succeeded)
+                          .arg(failures.count());
+    ui->statusbar->showMessage(summary, 15000);
+    onLogMessageReceived(summary);
+    for (int i = 0; i < failures.count(); ++i) {
+        onLogMessageReceived(QString::fromUtf8("  [失败] %1").arg(failures.at(i)));
     }
 }
 
 void MainWindow::on_btnStart_clicked() {
+    QStringList ids = selectedProcessIds();
+    if (ids.count() > 1) {
+        onLogMessageReceived(
+            QString::fromUtf8("UI：批量启动 %1 个服务").arg(ids.count()));
+        emit bulkOperationRequested("start", ids);
+        return;
+    }
+
     QModelIndexList selectedIndexes =
         ui->tableView->selectionModel()->selectedIndexes();
     if (selectedIndexes.isEmpty()) {
         return;
     }
 
-    int row = selectedIndexes.first().row();
+    int row = sourceRow(selectedIndexes.first());
     QString id = m_processModel->getProcessId(row);
 
     if (!id.isEmpty()) {
@@ -215,13 +492,21 @@ void MainWindow::on_btnStart_clicked() {
 }
 
 void MainWindow::on_btnStop_clicked() {
+    QStringList ids = selectedProcessIds();
+    if (ids.count() > 1) {
+        onLogMessageReceived(
+            QString::fromUtf8("UI：批量停止 %1 个服务").arg(ids.count()));
+        emit bulkOperationRequested("stop", ids);
+        return;
+    }
+
     QModelIndexList selectedIndexes =
         ui->tableView->selectionModel()->selectedIndexes();
     if (selectedIndexes.isEmpty()) {
         return;
     }
 
-    int row = selectedIndexes.first().row();
+    int row = sourceRow(selectedIndexes.first());
     QString id = m_processModel->getProcessId(row);
 
     if (!id.isEmpty()) {
@@ -231,6 +516,27 @@ void MainWindow::on_btnStop_clicked() {
     }
 }
 
+void MainWindow::on_btnHistory_clicked() {
+    QModelIndexList selectedIndexes =
+        ui->tableView->selectionModel()->selectedIndexes();
+    if (selectedIndexes.isEmpty()) {
+        return;
+    }
+
+    QString id = m_processModel->getProcessId(sourceRow(selectedIndexes.first()));
+    if (!id.isEmpty()) {
+        emit runHistoryRequested(id);
+    }
+}
+
+void MainWindow::onRunHistoryReady(const QString &name,
+                                   const QList<RunRecord> &runs) {
+    RunHistoryDialog *dialog = new RunHistoryDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setRuns(name, runs);
+    dialog->show();
+}
+
 void MainWindow::onSystemMetricsUpdated(double cpuPercent, double memPercent) {
     // 【关键修复3】添加调试信息，确认信号是否到达
     qDebug() << "MainWindow received system metrics - CPU:" << cpuPercent
@@ -252,13 +558,21 @@ void MainWindow::onSystemMetricsUpdated(double cpuPercent, double memPercent) {
 }
 
 void MainWindow::on_btnRestart_clicked() {
+    QStringList ids = selectedProcessIds();
+    if (ids.count() > 1) {
+        onLogMessageReceived(
+            QString::fromUtf8("UI：批量重启 %1 个服务").arg(ids.count()));
+        emit bulkOperationRequested("restart", ids);
+        return;
+    }
+
     QModelIndexList selectedIndexes =
         ui->tableView->selectionModel()->selectedIndexes();
     if (selectedIndexes.isEmpty()) {
         return;
     }
 
-    int row = selectedIndexes.first().row();
+    int row = sourceRow(selectedIndexes.first());
     QString id = m_processModel->getProcessId(row);
 
     if (!id.isEmpty()) {
@@ -290,6 +604,9 @@ void MainWindow::on_btnAdd_clicked() {
     rootObj["workingDir"] = newInfo.workingDir;
     rootObj["pidFile"] = newInfo.pidFile;
     rootObj["autoStart"] = newInfo.autoStart;
+    if (!newInfo.group.isEmpty()) {
+        rootObj["group"] = newInfo.group;
+    }
 
     QJsonArray argsArray;
     for (int i = 0; i < newInfo.args.size(); ++i) {
@@ -304,6 +621,9 @@ void MainWindow::on_btnAdd_clicked() {
         scheduleObj["minute"] = newInfo.schedule.minute;
         scheduleObj["dayOfWeek"] = newInfo.schedule.dayOfWeek;
         scheduleObj["dayOfMonth"] = newInfo.schedule.dayOfMonth;
+        if (newInfo.schedule.type == "cron") {
+            scheduleObj["expression"] = newInfo.schedule.expression;
+        }
         rootObj["schedule"] = scheduleObj;
     }
 
@@ -346,13 +666,27 @@ void MainWindow::on_btnAdd_clicked() {
 }
 
 void MainWindow::on_btnDelete_clicked() {
+    QStringList ids = selectedProcessIds();
+    if (ids.count() > 1) {
+        if (QMessageBox::question(
+                this, "确认删除",
+                QString::fromUtf8("您确定要删除选中的 %1 个服务吗？\n"
+                                  "这将从磁盘上永久删除它们的配置文件，"
+                                  "运行中的服务会被跳过。")
+                    .arg(ids.count()),
+                QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
+            emit bulkOperationRequested("delete", ids);
+        }
+        return;
+    }
+
     // 1. 获取当前选中的服务ID
     QModelIndexList selectedIndexes =
         ui->tableView->selectionModel()->selectedIndexes();
     if (selectedIndexes.isEmpty()) {
         return;
     }
-    int row = selectedIndexes.first().row();
+    int row = sourceRow(selectedIndexes.first());
     QString id = m_processModel->getProcessId(row);
     QString name = m_processModel->data(m_processModel->index(row, 0))
                        .toString();  // 获取服务名称用于提示
@@ -381,7 +715,7 @@ void MainWindow::on_btnEdit_clicked() {
     if (selectedIndexes.isEmpty()) {
         return;
     }
-    QString id = m_processModel->getProcessId(selectedIndexes.first().row());
+    QString id = m_processModel->getProcessId(sourceRow(selectedIndexes.first()));
     if (!id.isEmpty()) {
         // 发射信号，请求后台准备这个ID的数据
         emit editServiceRequested(id);
@@ -400,8 +734,22 @@ void MainWindow::openEditDialog(const ProcessInfo &info) {
         // 4. 如果用户点击了"OK"并且数据验证通过，就从对话框获取更新后的数据
         ProcessInfo updatedInfo = dialog.getServiceInfo();
 
-        // 5. 【开始序列化】将更新后的 ProcessInfo 结构体转换为 QJsonObject
+        QString savePath = QCoreApplication::applicationDirPath() +
+                           "/configs/" + updatedInfo.id + ".json";
+
+        // 5. 【开始序列化】以磁盘上的现有配置为基础合并，
+        // 保留对话框中未提供编辑的字段(如 limits)
         QJsonObject rootObj;
+        QFile existingFile(savePath);
+        if (existingFile.open(QIODevice::ReadOnly)) {
+            QJsonDocument existingDoc =
+                QJsonDocument::fromJson(existingFile.readAll());
+            existingFile.close();
+            if (existingDoc.isObject()) {
+                rootObj = existingDoc.object();
+            }
+        }
+
         rootObj["id"] = updatedInfo.id;
         rootObj["name"] = updatedInfo.name;
         rootObj["type"] = updatedInfo.type;
@@ -413,6 +761,11 @@ void MainWindow::openEditDialog(const ProcessInfo &info) {
         rootObj["pidFile"] = pidFileInfo.fileName();
 
         rootObj["autoStart"] = updatedInfo.autoStart;
+        if (updatedInfo.group.isEmpty()) {
+            rootObj.remove("group");
+        } else {
+            rootObj["group"] = updatedInfo.group;
+        }
 
         QJsonArray argsArray;
         for (int i = 0; i < updatedInfo.args.size(); ++i) {
@@ -421,27 +774,35 @@ void MainWindow::openEditDialog(const ProcessInfo &info) {
         rootObj["args"] = argsArray;
 
         if (updatedInfo.type == "task") {
-            QJsonObject scheduleObj;
+            QJsonObject scheduleObj = rootObj["schedule"].toObject();
             scheduleObj["type"] = updatedInfo.schedule.type;
             scheduleObj["hour"] = updatedInfo.schedule.hour;
             scheduleObj["minute"] = updatedInfo.schedule.minute;
             scheduleObj["dayOfWeek"] = updatedInfo.schedule.dayOfWeek;
             scheduleObj["dayOfMonth"] = updatedInfo.schedule.dayOfMonth;
+            if (updatedInfo.schedule.type == "cron") {
+                scheduleObj["expression"] = updatedInfo.schedule.expression;
+            } else {
+                scheduleObj.remove("expression");
+            }
             rootObj["schedule"] = scheduleObj;
+        } else {
+            rootObj.remove("schedule");
         }
 
         if (updatedInfo.healthCheckEnabled) {
-            QJsonObject healthCheckObj;
+            QJsonObject healthCheckObj = rootObj["healthCheck"].toObject();
             healthCheckObj["enabled"] = true;
             healthCheckObj["maxCpu"] = updatedInfo.maxCpu;
             healthCheckObj["maxMem"] = updatedInfo.maxMem;
             rootObj["healthCheck"] = healthCheckObj;
+        } else if (rootObj.contains("healthCheck")) {
+            QJsonObject healthCheckObj = rootObj["healthCheck"].toObject();
+            healthCheckObj["enabled"] = false;
+            rootObj["healthCheck"] = healthCheckObj;
         }
 
         // 6. 【开始文件操作】将 QJsonObject 写入对应的配置文件，覆盖旧文件
-        QString savePath = QCoreApplication::applicationDirPath() +
-                           "/configs/" + updatedInfo.id + ".json";
-
         QFile saveFile(savePath);
         // QIODevice::Truncate 选项会确保在写入前清空原文件内容
         if (!saveFile.open(QIODevice::WriteOnly | QIODevice::Truncate |
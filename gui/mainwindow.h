@@ -2,12 +2,20 @@
 #define MAINWINDOW_H
 
 #include <processinfo.h>
+#include <runhistory.h>
 
 #include <QMainWindow>
 // Forward declarations
+class QCloseEvent;
+class QDockWidget;
+class DiagnosticsPanel;
+class GroupModel;
+class GroupPanel;
 class QThread;
 class BackendWorker;
 class ProcessModel;
+class ProcessFilterProxy;
+class QModelIndex;
 
 namespace Ui {
 class MainWindow;
@@ -34,6 +42,16 @@ signals:
 
     void serviceEdited(const QString &configPath);
 
+    void runHistoryRequested(const QString &id);
+
+    void stopAllRequested();
+
+    // 多选时的批量操作: action 为 "start"/"stop"/"restart"/"delete"
+    void bulkOperationRequested(const QString &action, const QStringList &ids);
+
+protected:
+    void closeEvent(QCloseEvent *event);
+
 private slots:
     void onLogMessageReceived(const QString &message);
     void onInitialSetupCompleted();
@@ -43,6 +61,14 @@ private slots:
     void on_btnEdit_clicked();
     void on_btnDelete_clicked();
     void on_btnRestart_clicked();
+    void on_btnHistory_clicked();
+    void on_btnStopAll_clicked();
+    void onAllProcessesStopped();
+    void onBulkProgress(const QString &action, const QString &label, int done,
+                        int failed, int running, int total);
+    void onBulkFinished(const QString &action, const QString &label,
+                        int succeeded, const QStringList &failures);
+    void onRunHistoryReady(const QString &name, const QList<RunRecord> &runs);
     //用于更新系统状态的UI控件
     void onSystemMetricsUpdated(double cpuPercent, double memPercent);
     void openEditDialog(const ProcessInfo &info);
@@ -50,11 +76,26 @@ private slots:
     void on_btnAdd_clicked();
 
 private:
+    // 选中行对应的服务ID，按表格中显示的顺序
+    QStringList selectedProcessIds() const;
+    // 视图(代理)中的行映射到源模型的行号
+    int sourceRow(const QModelIndex &viewIndex) const;
+    // 按 manager.ini 连接其他主机上的管理器，把它们的服务并入表格(只读)
+    void startFederationClients();
+
     Ui::MainWindow *ui;
 
     QThread *m_workerThread;
     BackendWorker *m_backendWorker;
     ProcessModel *m_processModel;
+    ProcessFilterProxy *m_proxyModel;
+    QDockWidget *m_diagnosticsDock;
+    DiagnosticsPanel *m_diagnosticsPanel;
+    GroupModel *m_groupModel;
+    QDockWidget *m_groupsDock;
+    GroupPanel *m_groupPanel;
+    bool m_closingAfterStopAll;  // 全部停止完成后退出程序
+    bool m_readyToClose;
 };
 
 #endif  // MAINWINDOW_H
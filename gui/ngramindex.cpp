@@ -0,0 +1,97 @@
+#include "ngramindex.h"
+
+quint64 NgramIndex::gramAt(const QString &text, int pos) {
+    return ((quint64)text.at(pos).unicode() << 32) |
+           ((quint64)text.at(pos + 1).unicode() << 16) |
+           (quint64)text.at(pos + 2).unicode();
+}
+
+void NgramIndex::insert(const QString &key, const QString &text) {
+    QString lower = text.toLower();
+    QHash<QString, QString>::const_iterator it = m_texts.constFind(key);
+    if (it != m_texts.constEnd()) {
+        if (it.value() == lower) {
+            return;
+        }
+        remove(key);
+    }
+
+    m_texts.insert(key, lower);
+    for (int i = 0; i + 3 <= lower.length(); ++i) {
+        m_postings[gramAt(lower, i)].insert(key);
+    }
+}
+
+void NgramIndex::remove(const QString &key) {
+    QHash<QString, QString>::iterator it = m_texts.find(key);
+    if (it == m_texts.end()) {
+        return;
+    }
+
+    const QString &lower = it.value();
+    for (int i = 0; i + 3 <= lower.length(); ++i) {
+        QHash<quint64, QSet<QString> >::iterator posting =
+            m_postings.find(gramAt(lower, i));
+        if (posting != m_postings.end()) {
+            posting.value().remove(key);
+            if (posting.value().isEmpty()) {
+                m_postings.erase(posting);
+            }
+        }
+    }
+    m_texts.erase(it);
+}
+
+void NgramIndex::clear() {
+    m_texts.clear();
+    m_postings.clear();
+}
+
+bool NgramIndex::matches(const QString &key, const QString &lowerQuery) const {
+    QHash<QString, QString>::const_iterator it = m_texts.constFind(key);
+    return it != m_texts.constEnd() && it.value().contains(lowerQuery);
+}
+
+QSet<QString> NgramIndex::search(const QString &query) const {
+    QSet<QString> result;
+    QString lower = query.toLower();
+
+    // 少于3个字符无法使用三元组，直接扫描(文本都很短，上万条也只需几毫秒)
+    if (lower.length() < 3) {
+        for (QHash<QString, QString>::const_iterator it = m_texts.constBegin();
+             it != m_texts.constEnd(); ++it) {
+            if (it.value().contains(lower)) {
+                result.insert(it.key());
+            }
+        }
+        return result;
+    }
+
+    // 找出最小的倒排表作为候选，其余三元组依次求交
+    QList<const QSet<QString> *> postings;
+    const QSet<QString> *smallest = 0;
+    for (int i = 0; i + 3 <= lower.length(); ++i) {
+        QHash<quint64, QSet<QString> >::const_iterator posting =
+            m_postings.constFind(gramAt(lower, i));
+        if (posting == m_postings.constEnd()) {
+            return result;  // 某个三元组没有出现过，不可能匹配
+        }
+        postings.append(&posting.value());
+        if (!smallest || posting.value().count() < smallest->count()) {
+            smallest = &posting.value();
+        }
+    }
+
+    for (QSet<QString>::const_iterator it = smallest->constBegin();
+         it != smallest->constEnd(); ++it) {
+        bool candidate = true;
+        for (int i = 0; i < postings.count() && candidate; ++i) {
+            candidate = postings.at(i) == smallest || postings.at(i)->contains(*it);
+        }
+        // 三元组都出现不代表它们连在一起，最后做一次子串确认
+        if (candidate && m_texts.value(*it).contains(lower)) {
+            result.insert(*it);
+        }
+    }
+    return result;
+}
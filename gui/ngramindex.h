@@ -0,0 +1,32 @@
+#ifndef NGRAMINDEX_H
+#define NGRAMINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+// 小写三元组(trigram)倒排索引，用于在大量服务中按子串快速过滤。
+// 每个键对应一段文本(ID、名称、命令拼接)，增删改都是增量的；
+// 查询先用查询串的三元组求候选集的交集，再对候选做一次真正的子串匹配。
+class NgramIndex {
+public:
+    void insert(const QString &key, const QString &text);
+    void remove(const QString &key);
+    void clear();
+
+    bool contains(const QString &key) const { return m_texts.contains(key); }
+
+    // 文本(不区分大小写)包含 query 的所有键；query 为空时返回全部键
+    QSet<QString> search(const QString &query) const;
+
+    // 单个键是否匹配，query 须已转为小写
+    bool matches(const QString &key, const QString &lowerQuery) const;
+
+private:
+    static quint64 gramAt(const QString &text, int pos);
+
+    QHash<QString, QString> m_texts;            // 键 -> 小写文本
+    QHash<quint64, QSet<QString> > m_postings;  // 三元组 -> 键
+};
+
+#endif  // NGRAMINDEX_H
@@ -0,0 +1,129 @@
+#include "processfilterproxy.h"
+
+#include "processmodel.h"
+
+ProcessFilterProxy::ProcessFilterProxy(QObject *parent)
+    : QSortFilterProxyModel(parent) {
+    setSortRole(ProcessModel::SortRole);
+    setSortCaseSensitivity(Qt::CaseInsensitive);
+    setDynamicSortFilter(true);
+}
+
+void ProcessFilterProxy::setSourceModel(QAbstractItemModel *model) {
+    if (sourceModel()) {
+        disconnect(sourceModel(), 0, this, 0);
+    }
+
+    // 先于基类连接：源模型变化时索引先更新，基类随后重新过滤时用到的就是新索引
+    if (model) {
+        connect(model, SIGNAL(rowsInserted(QModelIndex, int, int)), this,
+                SLOT(onRowsInserted(QModelIndex, int, int)));
+        connect(model, SIGNAL(rowsAboutToBeRemoved(QModelIndex, int, int)),
+                this, SLOT(onRowsAboutToBeRemoved(QModelIndex, int, int)));
+        connect(model, SIGNAL(modelReset()), this, SLOT(onModelReset()));
+        connect(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)), this,
+                SLOT(onDataChanged(QModelIndex, QModelIndex)));
+    }
+
+    QSortFilterProxyModel::setSourceModel(model);
+    rebuildIndex();
+}
+
+void ProcessFilterProxy::setFilterText(const QString &text) {
+    QString lower = text.trimmed().toLower();
+    if (lower == m_filterText) {
+        return;
+    }
+
+    m_filterText = lower;
+    if (m_filterText.isEmpty()) {
+        m_matches.clear();
+    } else {
+        m_matches = m_index.search(m_filterText);
+    }
+    invalidateFilter();
+}
+
+bool ProcessFilterProxy::filterAcceptsRow(
+    int sourceRow, const QModelIndex & /*sourceParent*/) const {
+    if (m_filterText.isEmpty()) {
+        return true;
+    }
+    return m_matches.contains(rowKey(sourceRow));
+}
+
+QString ProcessFilterProxy::rowKey(int sourceRow) const {
+    return sourceModel()
+        ->data(sourceModel()->index(sourceRow, 0), ProcessModel::RowKeyRole)
+        .toString();
+}
+
+bool ProcessFilterProxy::indexRow(int sourceRow) {
+    QString key = rowKey(sourceRow);
+    if (key.isEmpty()) {
+        return false;
+    }
+
+    m_index.insert(key, sourceModel()
+                            ->data(sourceModel()->index(sourceRow, 0),
+                                   ProcessModel::SearchTextRole)
+                            .toString());
+
+    if (m_filterText.isEmpty()) {
+        return true;
+    }
+    bool matched = m_index.matches(key, m_filterText);
+    if (matched) {
+        m_matches.insert(key);
+    } else {
+        m_matches.remove(key);
+    }
+    return matched;
+}
+
+void ProcessFilterProxy::rebuildIndex() {
+    m_index.clear();
+    m_matches.clear();
+    if (!sourceModel()) {
+        return;
+    }
+    int rows = sourceModel()->rowCount();
+    for (int row = 0; row < rows; ++row) {
+        indexRow(row);
+    }
+}
+
+void ProcessFilterProxy::onRowsInserted(const QModelIndex &parent, int first,
+                                        int last) {
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; ++row) {
+        indexRow(row);
+    }
+}
+
+void ProcessFilterProxy::onRowsAboutToBeRemoved(const QModelIndex &parent,
+                                                int first, int last) {
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; ++row) {
+        QString key = rowKey(row);
+        m_index.remove(key);
+        m_matches.remove(key);
+    }
+}
+
+void ProcessFilterProxy::onModelReset() { rebuildIndex(); }
+
+void ProcessFilterProxy::onDataChanged(const QModelIndex &topLeft,
+                                       const QModelIndex &bottomRight) {
+    // 指标刷新只涉及PID到内存这几列，名称(第0列)没变就无需重新索引
+    if (topLeft.column() > 0) {
+        return;
+    }
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        indexRow(row);
+    }
+}
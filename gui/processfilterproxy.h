@@ -0,0 +1,48 @@
+#ifndef PROCESSFILTERPROXY_H
+#define PROCESSFILTERPROXY_H
+
+#include <QSet>
+#include <QSortFilterProxyModel>
+
+#include "ngramindex.h"
+
+// 服务表的排序/过滤代理。
+// 排序使用 ProcessModel::SortRole 提供的原始数值，CPU、内存按数值而非字符串比较；
+// 依靠 dynamicSortFilter，指标刷新时只有 dataChanged 涉及的行会被重新定位。
+// 过滤按 ID、名称、命令、主机、分组做不区分大小写的子串匹配，由增量维护的三元组索引支撑，
+// 每次输入只在索引中求一次候选集，filterAcceptsRow 本身是一次哈希查找。
+class ProcessFilterProxy : public QSortFilterProxyModel {
+    Q_OBJECT
+
+public:
+    explicit ProcessFilterProxy(QObject *parent = 0);
+
+    void setSourceModel(QAbstractItemModel *sourceModel);
+
+    QString filterText() const { return m_filterText; }
+
+public slots:
+    void setFilterText(const QString &text);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const;
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onModelReset();
+    void onDataChanged(const QModelIndex &topLeft,
+                       const QModelIndex &bottomRight);
+
+private:
+    QString rowKey(int sourceRow) const;
+    // 重新索引一行，返回该行是否匹配当前过滤条件
+    bool indexRow(int sourceRow);
+    void rebuildIndex();
+
+    NgramIndex m_index;
+    QString m_filterText;   // 小写；空 = 不过滤
+    QSet<QString> m_matches;
+};
+
+#endif  // PROCESSFILTERPROXY_H
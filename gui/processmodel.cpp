@@ -1,13 +1,115 @@
 #include "processmodel.h"
 
 #include <QColor>
-#include <QDebug>
+
+#include <algorithm>
+
+#include "lifecycletimings.h"
+#include "tracer.h"
+
+namespace {
+
+// 状态列按"活跃程度"排序，而不是按枚举值或显示文字
+int stateRank(ProcessState::State state) {
+    switch (state) {
+        case ProcessState::Running: return 0;
+        case ProcessState::Starting: return 1;
+        case ProcessState::Stopping: return 2;
+        case ProcessState::Error: return 3;
+        case ProcessState::Quarantined: return 4;
+        default: return 5;
+    }
+}
+
+// 启停耗时列: "P50 / P99"，没有样本时显示 "-"
+QString formatLatency(const LatencySummary &summary) {
+    if (summary.count == 0) {
+        return QString("-");
+    }
+    return QString("%1 / %2 s")
+        .arg(summary.p50 / 1000.0, 0, 'f', 1)
+        .arg(summary.p99 / 1000.0, 0, 'f', 1);
+}
+
+QString latencyToolTip(const LatencySummary &summary) {
+    if (summary.count == 0) {
+        return QString();
+    }
+    return QString::fromUtf8("累计 %1 次；最近 %2 次中 最短 %3 秒，最长 %4 秒")
+        .arg(summary.count)
+        .arg(qMin(summary.count, (quint64)LifecycleTimings::kWindow))
+        .arg(summary.min / 1000.0, 0, 'f', 2)
+        .arg(summary.max / 1000.0, 0, 'f', 2);
+}
+
+}  // namespace
 
 ProcessModel::ProcessModel(QObject *parent) : QAbstractTableModel(parent) {}
 
+// 状态只在显示时转换为文字
+QString ProcessModel::stateDisplayName(ProcessState::State state) {
+    switch (state) {
+        case ProcessState::Stopped: return QString::fromUtf8("已停止");
+        case ProcessState::Starting: return QString::fromUtf8("启动中...");
+        case ProcessState::Running: return QString::fromUtf8("运行中");
+        case ProcessState::Stopping: return QString::fromUtf8("停止中...");
+        case ProcessState::Error: return QString::fromUtf8("错误");
+        case ProcessState::Quarantined: return QString::fromUtf8("已隔离");
+    }
+    return QString();
+}
+
+QVariant ProcessModel::stateColor(ProcessState::State state) {
+    if (state == ProcessState::Running) return QColor(46, 204, 113);   // 绿色
+    if (state == ProcessState::Stopped) return QColor(230, 126, 34);  // 琥珀色
+    if (state == ProcessState::Error) return QColor(231, 76, 60);   // 红色 (Qt::red 过于刺眼，用一个柔和些的)
+    if (state == ProcessState::Quarantined) return QColor(192, 57, 43);  // 深红色
+    return QVariant();
+}
+
+QString ProcessModel::rowKey(const QString &host, const QString &id) {
+    if (host.isEmpty()) {
+        return id;
+    }
+    return host + QChar('\x1f') + id;
+}
+
+int ProcessModel::rowOf(const QString &key) const {
+    return m_rowById.value(key, -1);
+}
+
+void ProcessModel::reindexRows(int firstRow) {
+    for (int row = firstRow; row < m_processes.count(); ++row) {
+        const ProcessInfo &p = m_processes.at(row);
+        m_rowById.insert(rowKey(p.host, p.id), row);
+    }
+}
+
+bool ProcessModel::hasActiveProcesses() const {
+    for (int i = 0; i < m_processes.count(); ++i) {
+        if (m_processes.at(i).host.isEmpty() &&
+            !ProcessState::isIdle(m_processes.at(i).state)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void ProcessModel::updateProcessList(const QList<ProcessInfo> &processes) {
+    TraceSpan span("gui", "updateProcessList");
+    // 只替换本机的服务，远程主机的行保留
+    QList<ProcessInfo> remote;
+    for (int i = 0; i < m_processes.count(); ++i) {
+        if (!m_processes.at(i).host.isEmpty()) {
+            remote.append(m_processes.at(i));
+        }
+    }
+
     beginResetModel();
     m_processes = processes;
+    m_processes.append(remote);
+    m_rowById.clear();
+    reindexRows(0);
     endResetModel();
 }
 
@@ -16,16 +118,31 @@ int ProcessModel::rowCount(const QModelIndex & /*parent*/) const {
 }
 
 int ProcessModel::columnCount(const QModelIndex & /*parent*/) const {
-    return 6;
+    return 10;
+}
+
+ProcessState::State ProcessModel::stateAt(int row) const {
+    if (row < 0 || row >= m_processes.count()) {
+        return ProcessState::Stopped;
+    }
+    return m_processes.at(row).state;
 }
 
 QString ProcessModel::getProcessId(int row) const {
     if (row < 0 || row >= m_processes.count()) {
         return QString();  // 返回空字符串表示无效
     }
+    if (!m_processes.at(row).host.isEmpty()) {
+        return QString();
+    }
     return m_processes.at(row).id;
 }
 
+bool ProcessModel::isRemote(int row) const {
+    return row >= 0 && row < m_processes.count() &&
+           !m_processes.at(row).host.isEmpty();
+}
+
 QVariant ProcessModel::data(const QModelIndex &index, int role) const {
     if (!index.isValid() || index.row() >= m_processes.count()) {
         return QVariant();
@@ -33,6 +150,53 @@ QVariant ProcessModel::data(const QModelIndex &index, int role) const {
 
     const ProcessInfo &p = m_processes.at(index.row());
 
+    if (role == IdRole) {
+        return p.id;
+    }
+    if (role == SearchTextRole) {
+        return p.id + QChar('\n') + p.name + QChar('\n') +
+               p.command + QChar('\n') + p.host + QChar('\n') + p.group;
+    }
+    if (role == RowKeyRole) {
+        return rowKey(p.host, p.id);
+    }
+    if (role == SortRole) {
+        switch (index.column()) {
+            case 0:
+                return p.name;
+            case 1:
+                return p.type;
+            case 2:
+                return p.pid;
+            case 3:
+                return stateRank(p.state);
+            case 4:
+                return p.cpuUsage;
+            case 5:
+                return p.memUsage;
+            case 6:
+                return p.restartCount;
+            case 7:
+                return p.startLatency.p50;
+            case 8:
+                return p.stopLatency.p50;
+            case 9:
+                return p.host;
+            default:
+                return QVariant();
+        }
+    }
+
+    if (role == Qt::ToolTipRole) {
+        if (index.column() == 7) {
+            return latencyToolTip(p.startLatency);
+        }
+        if (index.column() == 8) {
+            return latencyToolTip(p.stopLatency);
+        }
+        return QVariant();
+    }
+
     if (role == Qt::DisplayRole) {
         switch (index.column()) {
             case 0:
@@ -43,11 +207,19 @@ QVariant ProcessModel::data(const QModelIndex &index, int role) const {
             case 2:
                 return (p.pid == -1) ? "N/A" : QString::number(p.pid);
             case 3:
-                return p.status;
+                return stateDisplayName(p.state);
             case 4:
                 return QString::number(p.cpuUsage, 'f', 2);
             case 5:
                 return QString::number(p.memUsage, 'f', 2);
+            case 6:
+                return p.restartCount;
+            case 7:
+                return formatLatency(p.startLatency);
+            case 8:
+                return formatLatency(p.stopLatency);
+            case 9:
+                return p.host.isEmpty() ? QString::fromUtf8("本机") : p.host;
             default:
                 return QVariant();
         }
@@ -67,9 +239,17 @@ QVariant ProcessModel::data(const QModelIndex &index, int role) const {
 
         // 【您已实现的逻辑】为“状态”列（第3列）设置颜色
         if (index.column() == 3) {
-            if (p.status == "Running") return QColor(46, 204, 113);   // 绿色
-            if (p.status == "Stopped") return QColor(230, 126, 34);  // 琥珀色
-            if (p.status == "Error") return QColor(231, 76, 60);   // 红色 (Qt::red 过于刺眼，用一个柔和些的)
+            return stateColor(p.state);
+        }
+
+        // 远程主机的行不能操作，主机名用灰色
+        if (index.column() == 9 && !p.host.isEmpty()) {
+            return QColor(127, 140, 141);
+        }
+
+        // 有过自动重启的服务用琥珀色提示
+        if (index.column() == 6 && p.restartCount > 0) {
+            return QColor(230, 126, 34);
         }
     }
 
@@ -94,82 +274,81 @@ QVariant ProcessModel::headerData(int section, Qt::Orientation orientation,
             return QString::fromUtf8("CPU (%)");
         case 5:
             return QString::fromUtf8("内存 (MB)");
+        case 6:
+            return QString::fromUtf8("重启次数");
+        case 7:
+            return QString::fromUtf8("启动耗时 P50/P99");
+        case 8:
+            return QString::fromUtf8("停止耗时 P50/P99");
+        case 9:
+            return QString::fromUtf8("主机");
         default:
             return QVariant();
     }
 }
 
-void ProcessModel::updateProcessStatus(const QString &id, const QString &status,
-                                       qint64 pid, double cpu, double mem) {
-    // 【关键修复4】添加调试信息，确认数据更新是否到达
-    qDebug() << "ProcessModel::updateProcessStatus called - ID:" << id
-             << "Status:" << status << "PID:" << pid << "CPU:" << cpu
-             << "Memory:" << mem;
+void ProcessModel::updateProcessStatus(const QString &id,
+                                       ProcessState::State state, qint64 pid,
+                                       double cpu, double mem) {
+    // 每个刷新周期每个服务都会调用一次，上万个服务时不能逐行查找，也不能逐条打日志
+    TraceSpan span("gui", "updateProcessStatus", id);
+    // 找不到的ID(刚删除的服务、其他主机的服务)在每个周期都会出现，静默忽略
+    int row = rowOf(id);
+    if (row < 0) {
+        return;
+    }
 
-    // 遍历查找对应的进程
-    for (int row = 0; row < m_processes.count(); ++row) {
-        if (m_processes[row].id == id) {
-            // 【关键修复5】检查数据是否真的发生了变化
-            ProcessInfo &process = m_processes[row];
-            bool hasChanged = false;
-
-            if (process.status != status) {
-                process.status = status;
-                hasChanged = true;
-            }
-            if (process.pid != pid) {
-                process.pid = pid;
-                hasChanged = true;
-            }
-            if (process.cpuUsage != cpu) {
-                process.cpuUsage = cpu;
-                hasChanged = true;
-            }
-            if (process.memUsage != mem) {
-                process.memUsage = mem;
-                hasChanged = true;
-            }
+    // 【关键修复5】检查数据是否真的发生了变化
+    ProcessInfo &process = m_processes[row];
+    bool hasChanged = false;
 
-            if (hasChanged) {
-                qDebug() << "Data changed for process" << id
-                         << ", emitting dataChanged signal";
-                // 发射dataChanged信号，通知视图只刷新变化的单元格
-                // 我们更新了从PID(第2列)到内存(第5列)的整片区域
-                emit dataChanged(index(row, 2), index(row, 5));
-            }
-            return;  // 找到并更新后就返回
-        }
+    if (process.state != state) {
+        process.state = state;
+        hasChanged = true;
+    }
+    if (process.pid != pid) {
+        process.pid = pid;
+        hasChanged = true;
+    }
+    if (process.cpuUsage != cpu) {
+        process.cpuUsage = cpu;
+        hasChanged = true;
+    }
+    if (process.memUsage != mem) {
+        process.memUsage = mem;
+        hasChanged = true;
     }
 
-    // 【关键修复6】如果没有找到对应的进程，输出警告
-    qDebug() << "Warning: Process with ID" << id << "not found in model";
+    if (hasChanged) {
+        // 发射dataChanged信号，通知视图只刷新变化的单元格
+        // 我们更新了从PID(第2列)到内存(第5列)的整片区域
+        emit dataChanged(index(row, 2), index(row, 5));
+    }
 }
 
 void ProcessModel::addProcess(const ProcessInfo &info) {
     // beginInsertRows/endInsertRows 是Qt Model/View编程的最佳实践
     // 它会高效地通知视图“准备插入新行了”，而不是刷新整个表格
+    TraceSpan span("gui", "addProcess", info.id);
     beginInsertRows(QModelIndex(), rowCount(), rowCount());
 
     m_processes.append(info);
+    m_rowById.insert(info.id, m_processes.count() - 1);
 
     endInsertRows();
 }
 
 void ProcessModel::onServiceDeleted(const QString &id) {
-    // 1. 遍历查找要删除的服务在列表中的行号
-    int rowToRemove = -1;
-    for (int i = 0; i < m_processes.count(); ++i) {
-        if (m_processes.at(i).id == id) {
-            rowToRemove = i;
-            break;
-        }
-    }
+    // 1. 查找要删除的服务在列表中的行号
+    int rowToRemove = rowOf(id);
 
     if (rowToRemove != -1) {
         // 2. 使用beginRemoveRows/endRemoveRows通知视图准备移除操作
         // 这是最高效、最正确的刷新方式
         beginRemoveRows(QModelIndex(), rowToRemove, rowToRemove);
         m_processes.removeAt(rowToRemove);
+        m_rowById.remove(id);
+        reindexRows(rowToRemove);
         endRemoveRows();
     }
 }
@@ -177,14 +356,8 @@ void ProcessModel::onServiceDeleted(const QString &id) {
 // gui/processmodel.cpp
 
 void ProcessModel::onServiceUpdated(const ProcessInfo &info) {
-    // 1. 遍历查找要更新的服务在列表中的行号
-    int rowToUpdate = -1;
-    for (int i = 0; i < m_processes.count(); ++i) {
-        if (m_processes.at(i).id == info.id) {
-            rowToUpdate = i;
-            break;
-        }
-    }
+    // 1. 查找要更新的服务在列表中的行号
+    int rowToUpdate = rowOf(info.id);
 
     if (rowToUpdate != -1) {
         // 2. 直接替换掉旧的数据
@@ -197,3 +370,105 @@ void ProcessModel::onServiceUpdated(const ProcessInfo &info) {
         emit dataChanged(topLeft, bottomRight);
     }
 }
+
+void ProcessModel::updateRestartCount(const QString &id, int count) {
+    int row = rowOf(id);
+    if (row >= 0 && m_processes[row].restartCount != count) {
+        m_processes[row].restartCount = count;
+        emit dataChanged(index(row, 6), index(row, 6));
+    }
+}
+
+void ProcessModel::updateLifecycleTimings(const QString &id,
+                                          const LatencySummary &start,
+                                          const LatencySummary &stop) {
+    int row = rowOf(id);
+    if (row >= 0) {
+        m_processes[row].startLatency = start;
+        m_processes[row].stopLatency = stop;
+        emit dataChanged(index(row, 7), index(row, 8));
+    }
+}
+
+void ProcessModel::updateHostServices(const QString &host,
+                                      const QList<ProcessInfo> &services) {
+    TraceSpan span("gui", "updateHostServices", host);
+    QList<ProcessInfo> added;
+    for (int i = 0; i < services.count(); ++i) {
+        const ProcessInfo &info = services.at(i);
+        int row = rowOf(rowKey(host, info.id));
+        if (row < 0) {
+            added.append(info);
+            added.last().host = host;
+            continue;
+        }
+
+        // 名称变化时才从第0列开始通知，否则过滤代理不必重建该行的索引
+        ProcessInfo &process = m_processes[row];
+        bool renamed = process.name != info.name || process.type != info.type;
+        process = info;
+        process.host = host;
+        emit dataChanged(index(row, renamed ? 0 : 2), index(row, 8));
+    }
+
+    if (!added.isEmpty()) {
+        int first = m_processes.count();
+        beginInsertRows(QModelIndex(), first, first + added.count() - 1);
+        m_processes.append(added);
+        reindexRows(first);
+        endInsertRows();
+    }
+}
+
+void ProcessModel::removeHostServices(const QString &host,
+                                      const QStringList &ids) {
+    QList<int> rows;
+    for (int i = 0; i < ids.count(); ++i) {
+        int row = rowOf(rowKey(host, ids.at(i)));
+        if (row >= 0) {
+            rows.append(row);
+        }
+    }
+    removeRowList(rows);
+}
+
+void ProcessModel::removeHost(const QString &host) {
+    if (host.isEmpty()) {
+        return;
+    }
+    QList<int> rows;
+    for (int row = 0; row < m_processes.count(); ++row) {
+        if (m_processes.at(row).host == host) {
+            rows.append(row);
+        }
+    }
+    removeRowList(rows);
+}
+
+void ProcessModel::removeRowList(QList<int> rows) {
+    if (rows.isEmpty()) {
+        return;
+    }
+
+    // 从后往前删，前面的行号不受影响
+    std::sort(rows.begin(), rows.end());
+    int i = rows.count() - 1;
+    while (i >= 0) {
+        int last = rows.at(i);
+        int first = last;
+        while (i > 0 && rows.at(i - 1) == first - 1) {
+            --i;
+            first = rows.at(i);
+        }
+        --i;
+
+        beginRemoveRows(QModelIndex(), first, last);
+        for (int row = last; row >= first; --row) {
+            const ProcessInfo &p = m_processes.at(row);
+            m_rowById.remove(rowKey(p.host, p.id));
+            m_processes.removeAt(row);
+        }
+        endRemoveRows();
+    }
+    reindexRows(rows.first());
+}
@@ -2,6 +2,7 @@
 #define PROCESSMODEL_H
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include <QList>
 
 #include "../core/processinfo.h"
@@ -10,6 +11,13 @@ class ProcessModel : public QAbstractTableModel {
     Q_OBJECT
 
 public:
+    enum Roles {
+        SortRole = Qt::UserRole + 1,  // 排序用的原始值(数值列返回数字)
+        IdRole,                       // 服务ID
+        SearchTextRole,               // 供过滤的文本: ID、名称、命令、主机、分组
+        RowKeyRole                    // 行的唯一键: 本机为服务ID，远程为主机+ID
+    };
+
     explicit ProcessModel(QObject *parent = 0);
 
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
@@ -18,13 +26,22 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation,
                         int role = Qt::DisplayRole) const;
 
+    // 远程主机的行返回空字符串：本机后台不认识这些服务，不能对它们操作
     QString getProcessId(int row) const;
+    bool isRemote(int row) const;
+    ProcessState::State stateAt(int row) const;
+    // 本机是否还有未停止的服务(运行中、启动中或停止中)
+    bool hasActiveProcesses() const;
+
+    // 状态列的文字和颜色，分组视图共用
+    static QString stateDisplayName(ProcessState::State state);
+    static QVariant stateColor(ProcessState::State state);
 
 public slots:
     void updateProcessList(const QList<ProcessInfo> &processes);
 
     // 修改槽，使其能接收cpu和mem数据
-    void updateProcessStatus(const QString &id, const QString &status,
+    void updateProcessStatus(const QString &id, ProcessState::State state,
                              qint64 pid, double cpu, double mem);
 
     void addProcess(const ProcessInfo &info);
@@ -33,8 +50,29 @@ public slots:
 
     void onServiceUpdated(const ProcessInfo &info);
 
+    void updateRestartCount(const QString &id, int count);
+
+    // --- 联合视图：远程主机的服务 ---
+    // 新增或更新该主机的服务；已有的行只刷新变化的单元格
+    void updateHostServices(const QString &host,
+                            const QList<ProcessInfo> &services);
+    void removeHostServices(const QString &host, const QStringList &ids);
+    void removeHost(const QString &host);
+
+    void updateLifecycleTimings(const QString &id, const LatencySummary &start,
+                                const LatencySummary &stop);
+
 private:
+    static QString rowKey(const QString &host, const QString &id);
+    // 本机服务的行键就是服务ID
+    int rowOf(const QString &key) const;
+    // 删除若干行(任意顺序)，连续的行合并成一次通知
+    void removeRowList(QList<int> rows);
+    // 从 firstRow 起重新登记行号(插入、删除后行号会整体移动)
+    void reindexRows(int firstRow);
+
     QList<ProcessInfo> m_processes;
+    QHash<QString, int> m_rowById;  // 行键 -> 行号，指标刷新时O(1)定位
 };
 
 #endif  // PROCESSMODEL_H
@@ -0,0 +1,183 @@
+#include "runhistorydialog.h"
+
+#include <QColor>
+#include <QDateTime>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+namespace {
+
+QString formatDuration(qint64 ms) {
+    if (ms < 60 * 1000) {
+        return QString::fromUtf8("%1 秒").arg(ms / 1000.0, 0, 'f', 1);
+    }
+    qint64 secs = ms / 1000;
+    if (secs < 3600) {
+        return QString::fromUtf8("%1 分 %2 秒").arg(secs / 60).arg(secs % 60);
+    }
+    return QString::fromUtf8("%1 小时 %2 分").arg(secs / 3600).arg(secs % 3600 / 60);
+}
+
+QString formatExit(const RunRecord &run) {
+    if (run.signalNumber != 0) {
+        return QString::fromUtf8("信号 %1").arg(run.signalNumber);
+    }
+    return QString::number(run.exitCode);
+}
+
+// 耗时趋势：每次运行一根柱子，从旧到新，失败的运行标红
+class DurationTrendWidget : public QWidget {
+public:
+    explicit DurationTrendWidget(QWidget *parent = 0) : QWidget(parent) {
+        setMinimumHeight(90);
+    }
+
+    void setRuns(const QList<RunRecord> &runs) {
+        m_runs = runs;
+        update();
+    }
+
+    QSize sizeHint() const { return QSize(480, 110); }
+
+protected:
+    void paintEvent(QPaintEvent * /*event*/) {
+        QPainter painter(this);
+        QRect area = rect().adjusted(4, 4, -4, -4);
+
+        if (m_runs.isEmpty()) {
+            painter.setPen(QColor("#888888"));
+            painter.drawText(area, Qt::AlignCenter,
+                             QString::fromUtf8("暂无运行记录"));
+            return;
+        }
+
+        qint64 maxDuration = 1;
+        for (int i = 0; i < m_runs.count(); ++i) {
+            maxDuration = qMax(maxDuration, m_runs.at(i).durationMs());
+        }
+
+        int count = m_runs.count();
+        int slot = qMax(1, area.width() / count);
+        int barWidth = qMax(1, slot - 2);
+        for (int i = 0; i < count; ++i) {
+            const RunRecord &run = m_runs.at(i);
+            int height = (int)((double)run.durationMs() / maxDuration *
+                               area.height());
+            height = qMax(1, height);
+            QRect bar(area.left() + i * slot, area.bottom() - height + 1,
+                      barWidth, height);
+            painter.fillRect(bar, run.succeeded() ? QColor("#3498DB")
+                                                  : QColor("#E74C3C"));
+        }
+
+        painter.setPen(QColor("#888888"));
+        painter.drawText(area, Qt::AlignTop | Qt::AlignLeft,
+                         QString::fromUtf8("最长 %1").arg(formatDuration(maxDuration)));
+    }
+
+private:
+    QList<RunRecord> m_runs;
+};
+
+}  // namespace
+
+RunHistoryDialog::RunHistoryDialog(QWidget *parent) : QDialog(parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setWordWrap(true);
+    layout->addWidget(m_summaryLabel);
+
+    m_trendWidget = new DurationTrendWidget(this);
+    layout->addWidget(m_trendWidget);
+
+    m_table = new QTableWidget(this);
+    m_table->setColumnCount(8);
+    m_table->setHorizontalHeaderLabels(QStringList()
+                                       << QString::fromUtf8("开始时间")
+                                       << QString::fromUtf8("结束时间")
+                                       << QString::fromUtf8("耗时")
+                                       << QString::fromUtf8("退出状态")
+                                       << QString::fromUtf8("峰值CPU (%)")
+                                       << QString::fromUtf8("峰值内存 (MB)")
+                                       << QString::fromUtf8("CPU时间 (秒)")
+                                       << QString::fromUtf8("排队等待"));
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    layout->addWidget(m_table, 1);
+
+    resize(720, 460);
+}
+
+void RunHistoryDialog::setRuns(const QString &name,
+                               const QList<RunRecord> &runs) {
+    setWindowTitle(QString::fromUtf8("运行历史 - %1").arg(name));
+    static_cast<DurationTrendWidget *>(m_trendWidget)->setRuns(runs);
+
+    // --- 汇总 ---
+    if (runs.isEmpty()) {
+        m_summaryLabel->setText(QString::fromUtf8(
+            "暂无运行记录。只有由本管理器启动并退出的运行才会被记录。"));
+    } else {
+        int succeeded = 0;
+        qint64 total = 0;
+        qint64 shortest = runs.first().durationMs();
+        qint64 longest = shortest;
+        for (int i = 0; i < runs.count(); ++i) {
+            qint64 duration = runs.at(i).durationMs();
+            total += duration;
+            shortest = qMin(shortest, duration);
+            longest = qMax(longest, duration);
+            if (runs.at(i).succeeded()) {
+                ++succeeded;
+            }
+        }
+        qint64 average = total / runs.count();
+        qint64 last = runs.last().durationMs();
+        double change = average > 0 ? (last - average) * 100.0 / average : 0.0;
+
+        m_summaryLabel->setText(
+            QString::fromUtf8("最近 %1 次运行，成功 %2 次。平均耗时 %3，最短 %4，"
+                              "最长 %5；最近一次 %6 (较平均 %7%8%)。")
+                .arg(runs.count())
+                .arg(succeeded)
+                .arg(formatDuration(average))
+                .arg(formatDuration(shortest))
+                .arg(formatDuration(longest))
+                .arg(formatDuration(last))
+                .arg(change >= 0 ? "+" : "")
+                .arg(change, 0, 'f', 1));
+    }
+
+    // --- 明细：最新的在最上面 ---
+    m_table->clearContents();
+    m_table->setRowCount(runs.count());
+    for (int i = 0; i < runs.count(); ++i) {
+        const RunRecord &run = runs.at(runs.count() - 1 - i);
+        QStringList cells;
+        cells << QDateTime::fromMSecsSinceEpoch(run.startMs)
+                     .toString("yyyy-MM-dd hh:mm:ss")
+              << QDateTime::fromMSecsSinceEpoch(run.endMs)
+                     .toString("yyyy-MM-dd hh:mm:ss")
+              << formatDuration(run.durationMs()) << formatExit(run)
+              << QString::number(run.peakCpu, 'f', 1)
+              << QString::number(run.peakMemMB, 'f', 1)
+              << QString::number(run.cpuSeconds, 'f', 2)
+              << (run.queueWaitMs > 0 ? formatDuration(run.queueWaitMs)
+                                      : QString("-"));
+        for (int column = 0; column < cells.count(); ++column) {
+            QTableWidgetItem *item = new QTableWidgetItem(cells.at(column));
+            if (!run.succeeded()) {
+                item->setForeground(QColor("#E74C3C"));
+            }
+            m_table->setItem(i, column, item);
+        }
+    }
+    m_table->resizeColumnsToContents();
+}
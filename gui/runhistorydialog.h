@@ -0,0 +1,27 @@
+#ifndef RUNHISTORYDIALOG_H
+#define RUNHISTORYDIALOG_H
+
+#include <QDialog>
+#include <QList>
+
+#include "runhistory.h"
+
+class QLabel;
+class QTableWidget;
+
+// 显示单个服务/任务最近的运行记录：汇总、耗时趋势图和明细表格
+class RunHistoryDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit RunHistoryDialog(QWidget *parent = 0);
+
+    void setRuns(const QString &name, const QList<RunRecord> &runs);
+
+private:
+    QLabel *m_summaryLabel;
+    QWidget *m_trendWidget;
+    QTableWidget *m_table;
+};
+
+#endif  // RUNHISTORYDIALOG_H